@@ -0,0 +1,330 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "AllocStats.h"
+#include "IssueTracker.h"
+#include "benchmark/benchmark.h"
+
+/**
+ * Smallest and largest number of issues in a generated dataset, and the
+ * factor between the sizes run
+ */
+static const int64_t MIN_ISSUES = 1 << 10;
+static const int64_t MAX_ISSUES = 1 << 20;
+static const int SIZE_MULTIPLIER = 32;
+
+/**
+ * Reports allocations per iteration alongside the time, from the counts
+ * the server's operator new hook keeps for the benchmark thread.
+ * Allocations made while timing is paused (setup and cleanup of an
+ * iteration) are left out.
+ */
+class AllocMeter {
+ public:
+  explicit AllocMeter(benchmark::State& state)
+      : state(state),
+        allocations(AllocStats::thread().allocations),
+        bytes(AllocStats::thread().bytes),
+        pausedAllocations(0),
+        pausedBytes(0) {}
+  ~AllocMeter() {
+    uint64_t made = AllocStats::thread().allocations - allocations;
+    uint64_t requested = AllocStats::thread().bytes - bytes;
+    state.counters["allocs/op"] =
+        benchmark::Counter(made, benchmark::Counter::kAvgIterations);
+    state.counters["bytes/op"] =
+        benchmark::Counter(requested, benchmark::Counter::kAvgIterations);
+  }
+
+  /**
+   * Pauses timing and allocation counting
+   */
+  void pause() {
+    state.PauseTiming();
+    pausedAllocations = AllocStats::thread().allocations;
+    pausedBytes = AllocStats::thread().bytes;
+  }
+  /**
+   * Resumes timing and allocation counting
+   */
+  void resume() {
+    allocations += AllocStats::thread().allocations - pausedAllocations;
+    bytes += AllocStats::thread().bytes - pausedBytes;
+    state.ResumeTiming();
+  }
+
+ private:
+  benchmark::State& state;
+  /**
+   * Counts at the start, moved forward by whatever was allocated while
+   * paused
+   */
+  uint64_t allocations;
+  uint64_t bytes;
+  uint64_t pausedAllocations;
+  uint64_t pausedBytes;
+};
+
+/**
+ * Builds a tracker holding a number of issues spread over a tenth as many
+ * users, with up to three comments each, the way readFile would leave it
+ * @param issues number of issues
+ * @return the tracker
+ */
+static IssueTracker* generate(int64_t issues) {
+  static const char* systems[] = {"Linux", "Windows", "MacOS"};
+  static const char* types[] = {"Bug", "Feature", "Task"};
+  IssueTracker* tracker = new IssueTracker();
+  int64_t userCount = issues / 10 + 1;
+  for (int64_t u = 0; u < userCount; u++) {
+    tracker->addToUserVec(new User("user_" + std::to_string(u)));
+  }
+  for (int64_t i = 0; i < issues; i++) {
+    Issue* issue = new Issue(
+        "Issue " + std::to_string(i),
+        "Steps to reproduce problem " + std::to_string(i % 997),
+        systems[i % 3], types[i / 3 % 3],
+        "user_" + std::to_string(i % userCount),
+        "user_" + std::to_string(i * 7 % userCount));
+    for (int c = 0; c < i % 4; c++) {
+      Comment* comment = new Comment();
+      comment->setText("Seen again on build " + std::to_string(c));
+      comment->setUser("user_" + std::to_string((i + c) % userCount));
+      issue->addToComments(comment);
+    }
+    tracker->addToIssueVec(issue);
+  }
+  return tracker;
+}
+
+/**
+ * Gets the generated tracker with a number of issues, building it the first
+ * time, and makes the files in the working directory hold that tracker
+ * @param issues number of issues
+ * @return the tracker, shared by every benchmark of that size
+ */
+static IssueTracker* dataset(int64_t issues) {
+  static std::map<int64_t, IssueTracker*> trackers;
+  static int64_t onDisk = -1;
+  IssueTracker*& tracker = trackers[issues];
+  if (tracker == NULL) tracker = generate(issues);
+  if (onDisk != issues) {
+    std::ofstream userFile("users.txt");
+    std::vector<User*> users = tracker->getUserVec();
+    for (int u = 0; u < users.size(); u++) {
+      userFile << users[u]->getName() << '\n';
+    }
+    userFile.close();
+    tracker->writeFile();
+    onDisk = issues;
+  }
+  return tracker;
+}
+
+static void BM_AddAnIssue(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  std::string result;
+  int64_t n = 0;
+  for (auto _ : state) {
+    std::string title = "New issue " + std::to_string(n++);
+    tracker->addAnIssue(title, "Fresh report", "Linux", "Bug", "user_0",
+                        "user_1", result);
+    meter.pause();
+    Issue* added = tracker->getIssueVec().back();
+    tracker->deleteIssue(title);
+    delete added;
+    meter.resume();
+  }
+}
+
+static void BM_GetAnIssue(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  int64_t n = 0;
+  for (auto _ : state) {
+    // Strided so consecutive lookups do not share cache lines
+    int64_t i = n++ * 7919 % state.range(0);
+    benchmark::DoNotOptimize(tracker->getAnIssue("Issue " +
+                                                 std::to_string(i)));
+  }
+}
+
+static void BM_GetAllIssues(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tracker->getAllIssues());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_DeleteIssue(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  int64_t n = 0;
+  for (auto _ : state) {
+    meter.pause();
+    std::string title = "Doomed issue " + std::to_string(n++);
+    Issue* doomed =
+        new Issue(title, "Short lived", "Linux", "Bug", "user_0", "user_1");
+    tracker->addToIssueVec(doomed);
+    meter.resume();
+    tracker->deleteIssue(title);
+    meter.pause();
+    delete doomed;
+    meter.resume();
+  }
+}
+
+static void BM_CreateUser(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  int64_t n = 0;
+  for (auto _ : state) {
+    std::string name = "new_user_" + std::to_string(n++);
+    tracker->createUser(name);
+    meter.pause();
+    tracker->deleteUser(name);
+    meter.resume();
+  }
+}
+
+static void BM_DeleteUser(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  int64_t n = 0;
+  for (auto _ : state) {
+    meter.pause();
+    std::string name = "leaving_user_" + std::to_string(n++);
+    tracker->createUser(name);
+    meter.resume();
+    tracker->deleteUser(name);
+  }
+}
+
+static void BM_AddToCommentVec(benchmark::State& state) {
+  // Comments cannot be taken back, so they go on a copy of the dataset
+  IssueTracker* tracker = generate(state.range(0));
+  {
+    AllocMeter meter(state);
+    int64_t n = 0;
+    for (auto _ : state) {
+      int64_t i = n++ * 7919 % state.range(0);
+      tracker->addToCommentVec("Issue " + std::to_string(i), "Me too",
+                               "user_0", "");
+    }
+  }
+  tracker->memoryCleanCom();
+  tracker->memoryCleanIssues();
+  delete tracker;
+  // The copy overwrote the files of the shared dataset
+  dataset(state.range(0))->writeFile();
+}
+
+/**
+ * Ranks the ten best issues for a query; every generated issue says
+ * "reproduce", while the number in the last title appears in only one or
+ * two issues
+ * @param query "single", "multi" or "rare"
+ */
+static void BM_SearchIssues(benchmark::State& state, const char* query) {
+  IssueTracker* tracker = dataset(state.range(0));
+  std::string text = "reproduce";
+  if (std::string(query) == "multi") {
+    text = "steps reproduce problem build";
+  } else if (std::string(query) == "rare") {
+    text = std::to_string(state.range(0) - 1);
+  }
+  {
+    AllocMeter meter(state);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(tracker->searchIssues(text, 10));
+    }
+  }
+
+  MemoryStats stats = tracker->getMemoryStats();
+  for (size_t i = 0; i < stats.indexBytes.size(); i++) {
+    if (stats.indexBytes[i].first == "text") {
+      state.counters["index_bytes"] = stats.indexBytes[i].second;
+    }
+  }
+}
+
+static void BM_WriteFile(benchmark::State& state) {
+  IssueTracker* tracker = dataset(state.range(0));
+  AllocMeter meter(state);
+  for (auto _ : state) tracker->writeFile();
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ReadFile(benchmark::State& state) {
+  dataset(state.range(0));
+  AllocMeter meter(state);
+  for (auto _ : state) {
+    IssueTracker* loaded = new IssueTracker();
+    loaded->readFile();
+    meter.pause();
+    loaded->memoryCleanCom();
+    loaded->memoryCleanIssues();
+    delete loaded;
+    meter.resume();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define ISSUE_BENCHMARK(name) \
+  BENCHMARK(name)->RangeMultiplier(SIZE_MULTIPLIER)->Range(MIN_ISSUES, \
+                                                           MAX_ISSUES)
+#define ISSUE_BENCHMARK_CAPTURE(name, label, ...)                     \
+  BENCHMARK_CAPTURE(name, label, __VA_ARGS__)                         \
+      ->RangeMultiplier(SIZE_MULTIPLIER)                              \
+      ->Range(MIN_ISSUES, MAX_ISSUES)
+
+ISSUE_BENCHMARK(BM_AddAnIssue);
+ISSUE_BENCHMARK(BM_GetAnIssue);
+ISSUE_BENCHMARK(BM_GetAllIssues);
+ISSUE_BENCHMARK(BM_DeleteIssue);
+ISSUE_BENCHMARK(BM_CreateUser);
+ISSUE_BENCHMARK(BM_DeleteUser);
+ISSUE_BENCHMARK(BM_AddToCommentVec);
+ISSUE_BENCHMARK_CAPTURE(BM_SearchIssues, single, "single");
+ISSUE_BENCHMARK_CAPTURE(BM_SearchIssues, multi, "multi");
+ISSUE_BENCHMARK_CAPTURE(BM_SearchIssues, rare, "rare");
+ISSUE_BENCHMARK(BM_WriteFile);
+ISSUE_BENCHMARK(BM_ReadFile);
+
+/**
+ * Runs the benchmarks in a scratch directory, since most tracker
+ * operations rewrite the data files in the working directory
+ */
+int main(int argc, char** argv) {
+  char scratch[] = "/tmp/issue_bench_XXXXXX";
+  if (mkdtemp(scratch) == NULL || chdir(scratch) != 0) {
+    perror("scratch directory");
+    return 1;
+  }
+  AllocStats::setEnabled(true);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+
+  const char* files[] = {"users.txt",  "context.txt", "comments.txt",
+                         "search.idx", "labels.txt",  "views.txt"};
+  for (int f = 0; f < sizeof(files) / sizeof(files[0]); f++) remove(files[f]);
+  chdir("/");
+  rmdir(scratch);
+  return 0;
+}
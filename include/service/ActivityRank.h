@@ -0,0 +1,115 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef ACTIVITYRANK_H /* NOLINT */
+#define ACTIVITYRANK_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Ranks issues by comment activity. Every comment adds to its issue's score
+ * and that contribution halves every half-life, so an issue is hot when it
+ * has many comments, most of them recent.
+ *
+ * Scores use forward decay: a comment made at time t adds
+ * 2^((t - landmark) / halfLife) and is never touched again. Decaying every
+ * score by the same factor keeps their order, so the issues sit in a max-heap
+ * that a comment updates in O(log n).
+ */
+class ActivityRank {
+ public:
+  /**
+   * @param halfLife seconds after which a comment counts half as much
+   */
+  explicit ActivityRank(double halfLife);
+  ~ActivityRank() {}
+
+  /**
+   * Records comments on an issue, adding the issue if it is new
+   * @param id issue id
+   * @param now time of the comments, in seconds
+   * @param comments number of comments made
+   */
+  void record(uint64_t id, double now, double comments = 1);
+  /**
+   * Removes an issue
+   * @param id issue id
+   */
+  void remove(uint64_t id);
+  /**
+   * Gets the most active issues, visiting only the top of the heap
+   * @param k most issues returned
+   * @param now current time, in seconds
+   * @return issue ids and their scores as of now, hottest first
+   */
+  std::vector<std::pair<uint64_t, double>> top(size_t k, double now);
+  /**
+   * Gets the number of ranked issues
+   * @return number of issues
+   */
+  size_t size();
+  /**
+   * Gets the approximate memory held by the ranking
+   * @return bytes used by the heap and the position map
+   */
+  size_t bytes();
+  /**
+   * Removes every issue
+   */
+  void clear();
+
+ private:
+  /**
+   * An issue and its score relative to the landmark
+   */
+  struct Entry {
+    uint64_t id;
+    double score;
+  };
+  /**
+   * Moves a heap entry towards the root while it outranks its parent
+   * @param at heap position
+   */
+  void siftUp(size_t at);
+  /**
+   * Moves a heap entry towards the leaves while a child outranks it
+   * @param at heap position
+   */
+  void siftDown(size_t at);
+  /**
+   * Swaps two heap entries and their positions
+   * @param a heap position
+   * @param b heap position
+   */
+  void swapEntries(size_t a, size_t b);
+  /**
+   * Moves the landmark to a time, scaling every score to match, before the
+   * weights of new comments grow too large for a double
+   * @param now new landmark
+   */
+  void rebase(double now);
+
+  /**
+   * Seconds after which a comment counts half as much
+   */
+  double halfLife;
+  /**
+   * Time at which a comment adds exactly 1
+   */
+  double landmark;
+  /**
+   * Max-heap of issues by score
+   */
+  std::vector<Entry> heap;
+  /**
+   * Heap position of each issue
+   */
+  std::unordered_map<uint64_t, size_t> positions;
+};
+#endif /* NOLINT */
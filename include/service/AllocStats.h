@@ -0,0 +1,61 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef ALLOCSTATS_H /* NOLINT */
+#define ALLOCSTATS_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Counts heap allocations per thread, so they can be charged to the
+ * request a thread is handling. issueServer and the benchmarks link
+ * AllocHooks.cpp, which replaces the global operator new to call record;
+ * other programs never do, so nothing is counted there. Counting is off
+ * until setEnabled(true), and while off record costs one relaxed load.
+ */
+class AllocStats {
+ public:
+  /**
+   * Allocations and the bytes they asked for
+   */
+  struct Counts {
+    uint64_t allocations;
+    uint64_t bytes;
+  };
+
+  /**
+   * Turns counting on or off
+   * @param on whether record counts allocations
+   */
+  static void setEnabled(bool on);
+  /**
+   * Checks whether allocations are counted
+   * @return true if counting is on
+   */
+  static bool enabled();
+  /**
+   * Counts one allocation on the calling thread, if counting is on; called
+   * from operator new, so it must not allocate
+   * @param size bytes requested
+   */
+  static void record(size_t size);
+
+  /**
+   * Gets what the calling thread has allocated
+   * @return counts since the thread started
+   */
+  static Counts thread();
+  /**
+   * Starts charging the calling thread's allocations to a new request
+   */
+  static void beginRequest();
+  /**
+   * Gets what the calling thread allocated for its current request
+   * @return counts since beginRequest
+   */
+  static Counts request();
+};
+#endif /* NOLINT */
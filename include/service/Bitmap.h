@@ -0,0 +1,176 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef BITMAP_H /* NOLINT */
+#define BITMAP_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Compressed set of 32 bit issue ids, split like a roaring bitmap: ids are
+ * grouped by their high 16 bits and each group is kept either as a sorted
+ * array of the low 16 bits (when it has at most 4096 ids) or as a 65536 bit
+ * bitset. Sparse labels stay small and dense ones are combined a word at a
+ * time.
+ *
+ * Sets built with add and remove always use the smaller form. The results
+ * of intersect and subtract keep a bitset even once it gets sparse: they
+ * are usually read once, and turning them into arrays would cost more than
+ * the query itself.
+ */
+class Bitmap {
+ public:
+  Bitmap() {}
+  ~Bitmap() {}
+
+  /**
+   * Adds an id
+   * @param value the id
+   */
+  void add(uint32_t value);
+  /**
+   * Removes an id
+   * @param value the id
+   */
+  void remove(uint32_t value);
+  /**
+   * Checks whether an id is in the set
+   * @param value the id
+   * @return true if the id was added
+   */
+  bool contains(uint32_t value) const;
+  /**
+   * Gets the number of ids
+   * @return number of ids in the set
+   */
+  uint64_t cardinality() const;
+  /**
+   * Checks whether the set has no ids
+   * @return true if the set is empty
+   */
+  bool empty() const;
+  /**
+   * Gets every id
+   * @return the ids in increasing order
+   */
+  std::vector<uint32_t> values() const;
+
+  /**
+   * Gets the ids in both sets (AND)
+   * @param a first set
+   * @param b second set
+   * @return the intersection
+   */
+  static Bitmap intersect(const Bitmap& a, const Bitmap& b);
+  /**
+   * Gets the ids in either set (OR)
+   * @param a first set
+   * @param b second set
+   * @return the union
+   */
+  static Bitmap unite(const Bitmap& a, const Bitmap& b);
+  /**
+   * Gets the ids in the first set but not the second (AND NOT)
+   * @param a first set
+   * @param b second set
+   * @return the difference
+   */
+  static Bitmap subtract(const Bitmap& a, const Bitmap& b);
+  /**
+   * Counts the ids in both sets without building the intersection
+   * @param a first set
+   * @param b second set
+   * @return size of the intersection
+   */
+  static uint64_t intersectCount(const Bitmap& a, const Bitmap& b);
+
+  /**
+   * Gets the approximate memory held by the set
+   * @return bytes used by the containers
+   */
+  size_t bytes() const;
+  /**
+   * Removes every id
+   */
+  void clear();
+
+ private:
+  /**
+   * The ids sharing one value of their high 16 bits. Exactly one of array
+   * and words is in use: words is empty while the container is an array.
+   */
+  struct Container {
+    uint16_t key;
+    uint32_t count;
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> words;
+  };
+
+  /**
+   * Turns an array container into a bitset
+   * @param c the container
+   */
+  static void toWords(Container* c);
+  /**
+   * Turns a bitset container into an array
+   * @param c the container
+   */
+  static void toArray(Container* c);
+  /**
+   * Counts the values of a bitset container
+   * @param c the container
+   */
+  static void recount(Container* c);
+  /**
+   * Checks whether a container holds a low 16 bit value
+   * @param c the container
+   * @param low the value
+   * @return true if the value is in the container
+   */
+  static bool has(const Container& c, uint16_t low);
+  /**
+   * Intersects two containers with the same key
+   * @param a first container
+   * @param b second container
+   * @return the intersection, possibly empty
+   */
+  static Container intersectContainers(const Container& a, const Container& b);
+  /**
+   * Unites two containers with the same key
+   * @param a first container
+   * @param b second container
+   * @return the union
+   */
+  static Container uniteContainers(const Container& a, const Container& b);
+  /**
+   * Subtracts one container from another with the same key
+   * @param a first container
+   * @param b container whose values are removed
+   * @return the difference, possibly empty
+   */
+  static Container subtractContainers(const Container& a, const Container& b);
+  /**
+   * Counts the values two containers with the same key share
+   * @param a first container
+   * @param b second container
+   * @return size of their intersection
+   */
+  static uint64_t intersectCountContainers(const Container& a,
+                                           const Container& b);
+  /**
+   * Finds where the container for a key is or would be
+   * @param key high 16 bits of an id
+   * @return index of the first container whose key is not less than key
+   */
+  size_t position(uint16_t key) const;
+
+  /**
+   * Containers sorted by key, none of them empty
+   */
+  std::vector<Container> containers;
+};
+#endif /* NOLINT */
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef BITMAPINDEX_H /* NOLINT */
+#define BITMAPINDEX_H /* NOLINT */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bitmap.h"
+
+/**
+ * Compressed posting lists of issue ids keyed by facet, such as
+ * "label:ui", "type:Bug" or "os:Linux". Keys are kept sorted so that the
+ * facets of one field are listed together.
+ */
+class BitmapIndex {
+ public:
+  BitmapIndex() {}
+  ~BitmapIndex() {}
+
+  /**
+   * Adds an issue to a facet
+   * @param key the facet
+   * @param id issue id
+   */
+  void add(const std::string& key, uint32_t id);
+  /**
+   * Removes an issue from a facet
+   * @param key the facet
+   * @param id issue id
+   */
+  void remove(const std::string& key, uint32_t id);
+  /**
+   * Gets the issues with a facet
+   * @param key the facet
+   * @return the issue ids, empty if no issue has the facet
+   */
+  const Bitmap& get(const std::string& key) const;
+  /**
+   * Counts the issues of a set that have each facet
+   * @param within the issue ids counted
+   * @return each facet with a non-zero count, in key order
+   */
+  std::vector<std::pair<std::string, uint64_t>> counts(
+      const Bitmap& within) const;
+  /**
+   * Gets the number of facets that have at least one issue
+   * @return number of facets
+   */
+  size_t size() const;
+  /**
+   * Gets the approximate memory held by the index
+   * @return bytes used by the keys and bitmaps
+   */
+  size_t bytes() const;
+  /**
+   * Removes every facet
+   */
+  void clear();
+
+ private:
+  /**
+   * Issue ids by facet
+   */
+  std::map<std::string, Bitmap> facets;
+};
+#endif /* NOLINT */
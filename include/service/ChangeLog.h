@@ -0,0 +1,81 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef CHANGELOG_H /* NOLINT */
+#define CHANGELOG_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * A single committed mutation
+ */
+struct Change {
+  /**
+   * Sequence number of the change (the tracker version it produced)
+   */
+  uint64_t seq;
+  /**
+   * Kind of change (addIssue, deleteIssue, updateIssue, addComment,
+   * createUser, removeUser, saveView, deleteView)
+   */
+  std::string kind;
+  /**
+   * Issue title, username or view name the change applies to
+   */
+  std::string key;
+};
+
+class ChangeLog {
+ public:
+  /**
+   * Constructor for ChangeLog
+   * @param cap number of recent changes kept in memory
+   */
+  explicit ChangeLog(size_t cap = 4096);
+  ~ChangeLog() {}
+
+  /**
+   * Records a change and assigns it the next sequence number
+   * @param kind kind of change
+   * @param key issue title or username the change applies to
+   * @return sequence number of the change
+   */
+  uint64_t record(const std::string& kind, const std::string& key);
+  /**
+   * Gets the sequence number of the latest change
+   * @return latest sequence number, 0 if nothing changed yet
+   */
+  uint64_t getVersion();
+  /**
+   * Checks whether every change after a version is still held in the ring
+   * @param since version the caller has already seen
+   * @return true if the deltas since that version are available
+   */
+  bool covers(uint64_t since);
+  /**
+   * Gets the changes made after a version, oldest first
+   * @param since version the caller has already seen
+   * @return the changes, empty if since is current or not covered
+   */
+  std::vector<Change> since(uint64_t since);
+  /**
+   * Gets the approximate memory held by the log
+   * @return bytes used by the ring and the changes in it
+   */
+  size_t bytes();
+
+ private:
+  /**
+   * Fixed size ring of recent changes, indexed by seq % capacity
+   */
+  std::vector<Change> ring;
+  /**
+   * Sequence number of the latest change
+   */
+  uint64_t latest;
+};
+#endif /* NOLINT */
@@ -6,6 +6,7 @@
 #ifndef COMMENT_H /* NOLINT */
 #define COMMENT_H /* NOLINT */
 
+#include <cstddef>
 #include <string>
 class Comment {
  public:
@@ -22,6 +23,11 @@ class Comment {
    * @return commentUser
    */
   std::string getCommentUser();
+  /**
+   * Gets the approximate memory held by a comment
+   * @return bytes used by the comment and its text
+   */
+  size_t bytes();
 
   /**
    * Sets the text of a comment
@@ -0,0 +1,37 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef COMPRESSION_H /* NOLINT */
+#define COMPRESSION_H /* NOLINT */
+
+#include <string>
+
+/**
+ * gzip helpers (zlib) for compressing large responses
+ */
+class Compression {
+ public:
+  /**
+   * Checks whether an Accept-Encoding header allows gzip
+   * @param acceptEncoding value of the Accept-Encoding request header
+   * @return true if gzip (or "*") is listed without q=0
+   */
+  static bool acceptsGzip(const std::string& acceptEncoding);
+  /**
+   * Compresses data into the gzip format
+   * @param data the bytes to compress
+   * @param level zlib compression level (1 fastest, 9 smallest)
+   * @return the gzip stream
+   */
+  static std::string gzip(const std::string& data, int level = 6);
+  /**
+   * Decompresses a gzip (or zlib) stream
+   * @param data the compressed bytes
+   * @param out set to the decompressed bytes
+   * @return false if the stream is corrupt
+   */
+  static bool gunzip(const std::string& data, std::string* out);
+};
+#endif /* NOLINT */
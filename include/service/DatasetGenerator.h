@@ -0,0 +1,211 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef DATASETGENERATOR_H /* NOLINT */
+#define DATASETGENERATOR_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Draws ranks 1..n where rank k comes up in proportion to 1/k^s, in
+ * constant time per draw and without a table, by rejection-inversion
+ * (Hormann and Derflinger, 1996)
+ */
+class ZipfDistribution {
+ public:
+  /**
+   * @param n number of ranks
+   * @param s exponent, 0 for uniform; larger values favour low ranks more
+   */
+  ZipfDistribution(uint64_t n, double s);
+  ~ZipfDistribution() {}
+
+  /**
+   * Maps uniform random numbers to a rank
+   * @param next returns a uniform random number in [0, 1) on every call
+   * @return a rank from 1 to n
+   */
+  template <typename Uniform>
+  uint64_t sample(Uniform next) const {
+    while (true) {
+      double u = hIntegralN + next() * (hIntegralX1 - hIntegralN);
+      double x = hIntegralInverse(u);
+      double k = static_cast<double>(static_cast<uint64_t>(x + 0.5));
+      if (k < 1) k = 1;
+      if (k > n) k = n;
+      if (k - x <= shortcut || u >= hIntegral(k + 0.5) - h(k)) {
+        return static_cast<uint64_t>(k);
+      }
+    }
+  }
+
+ private:
+  double h(double x) const;
+  double hIntegral(double x) const;
+  double hIntegralInverse(double x) const;
+
+  double n;
+  double s;
+  double hIntegralX1;
+  double hIntegralN;
+  /**
+   * Draws this close to a rank are accepted without the exact test
+   */
+  double shortcut;
+};
+
+/**
+ * Draws ranks 1..n with the same probabilities as ZipfDistribution from a
+ * precomputed alias table (Walker's method): slot i keeps rank i + 1 with
+ * probability keep[i] / 2^32 and gives alias[i] + 1 otherwise. A draw is a
+ * multiply, a lookup and a comparison, several times cheaper than
+ * rejection-inversion, at the cost of 12 bytes per rank.
+ */
+class AliasTable {
+ public:
+  /**
+   * @param n number of ranks
+   * @param s exponent, 0 for uniform; larger values favour low ranks more
+   */
+  AliasTable(uint64_t n, double s);
+  ~AliasTable() {}
+
+  /**
+   * Maps random bits to a rank
+   * @param bits 64 uniform random bits: the high half picks the slot and
+   * the low half decides between it and its alias
+   * @return a rank from 1 to n
+   */
+  uint64_t sample(uint64_t bits) const {
+    uint64_t slot = ((bits >> 32) * keep.size()) >> 32;
+    return ((bits & 0xFFFFFFFF) < keep[slot] ? slot : alias[slot]) + 1;
+  }
+
+ private:
+  std::vector<uint64_t> keep;
+  std::vector<uint32_t> alias;
+};
+
+/**
+ * Shape of a generated store
+ */
+struct DatasetSpec {
+  uint64_t issues = 1000;
+  uint64_t comments = 5000;
+  uint64_t users = 100;
+  /**
+   * Zipf exponents: comments per issue (by issue age, oldest busiest),
+   * authors and assignees per user, and words in text
+   */
+  double commentSkew = 1.0;
+  double userSkew = 1.0;
+  double wordSkew = 1.0;
+  /**
+   * Distinct operating systems, issue types and labels
+   */
+  int systems = 3;
+  int types = 3;
+  int labels = 0;
+  /**
+   * Average number of labels on an issue
+   */
+  double labelsPerIssue = 0;
+  /**
+   * Average words in a title, description and comment; each text gets
+   * between half and one and a half times as many
+   */
+  int titleWords = 4;
+  int descWords = 20;
+  int commentWords = 10;
+  /**
+   * Distinct words in all text
+   */
+  uint64_t vocabulary = 5000;
+  uint64_t seed = 1;
+};
+
+/**
+ * Writes a synthetic store in the formats readFile loads: context.txt,
+ * comments.txt, users.txt and labels.txt. Text is made of made-up words,
+ * so it never holds the "^]" and "**" separators.
+ */
+class DatasetGenerator {
+ public:
+  /**
+   * @param spec shape of the store
+   */
+  explicit DatasetGenerator(const DatasetSpec& spec);
+  ~DatasetGenerator() {}
+
+  /**
+   * Writes the store, replacing any in the directory, and removes a saved
+   * search index that would no longer match it
+   * @param dir directory to write to
+   * @param error set to what went wrong if writing fails
+   * @return false if a file could not be written
+   */
+  bool write(const std::string& dir, std::string* error);
+  /**
+   * Gets the number of bytes the last write produced
+   * @return total size of the files written
+   */
+  uint64_t bytesWritten();
+  /**
+   * Gets a word of the vocabulary
+   * @param rank rank of the word from 1, most frequent first
+   * @return the word, lowercase letters only
+   */
+  static std::string word(uint64_t rank);
+
+ private:
+  /**
+   * Gets the next random number (splitmix64)
+   * @return 64 random bits
+   */
+  uint64_t next();
+  /**
+   * Gets a uniform random number
+   * @return a number in [0, 1)
+   */
+  double uniform();
+  /**
+   * Picks a length between half and one and a half times an average
+   * @param average the average
+   * @return the length, at least 1
+   */
+  int around(int average);
+  /**
+   * Appends words drawn from the vocabulary, separated by spaces
+   * @param out text to append to
+   * @param count number of words
+   */
+  void appendWords(std::string* out, int count);
+  /**
+   * Appends a "^]" separator and a username drawn from the users
+   * @param out text to append to
+   */
+  void appendUser(std::string* out);
+  /**
+   * Spreads the comments over the issues
+   * @return number of comments on each issue
+   */
+  std::vector<uint32_t> commentCounts();
+
+  DatasetSpec spec;
+  uint64_t state;
+  uint64_t written;
+  /**
+   * Words by rank, made once
+   */
+  std::vector<std::string> words;
+  /**
+   * Text and user names take most of the draws, so they use tables
+   */
+  AliasTable wordRanks;
+  AliasTable userRanks;
+};
+#endif /* NOLINT */
@@ -6,6 +6,7 @@
 #ifndef ISSUE_H /* NOLINT */
 #define ISSUE_H /* NOLINT */
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -14,7 +15,7 @@
 
 class Issue {
  public:
-  Issue() {}
+  Issue() : id(0) {}
   /**
    * Constructor for Issue which takes in issue information as parameters
    * @param t Issue title
@@ -60,6 +61,11 @@ class Issue {
    * @return issue assignee
    */
   std::string getIssueAssignee();
+  /**
+   * Gets the issue id, assigned by the tracker in creation order
+   * @return issue id, 0 if the issue was never added to a tracker
+   */
+  uint64_t getId();
   /**
    * Gets the vector of Comment pointers, comments
    * @return comment
@@ -70,6 +76,22 @@ class Issue {
    * @return comments vector size
    */
   int getCommentNum();
+  /**
+   * Gets the issue labels
+   * @return labels in the order they were added
+   */
+  std::vector<std::string> getLabels();
+  /**
+   * Gets the approximate memory held by the issue, not counting its
+   * comments
+   * @return bytes used by the issue, its text, labels and comment list
+   */
+  size_t bytes();
+  /**
+   * Gets the approximate memory held by the issue's comments
+   * @return bytes used by the comments and their text
+   */
+  size_t commentBytes();
 
   // Setters:
 
@@ -103,6 +125,11 @@ class Issue {
    * @param sa issue assignee
    */
   void setAssignee(std::string sa);
+  /**
+   * Sets the issue id
+   * @param i issue id
+   */
+  void setId(uint64_t i);
   /**
    * Sets user at specified comment to "user_Removed" when user is deleted
    * @param index index of comments vector
@@ -114,6 +141,18 @@ class Issue {
    * @param c Comment pointer to be added to vector
    */
   void addToComments(Comment* c);
+  /**
+   * Adds a label to the issue
+   * @param label the label
+   * @return false if the issue already had the label
+   */
+  bool addLabel(std::string label);
+  /**
+   * Removes a label from the issue
+   * @param label the label
+   * @return false if the issue did not have the label
+   */
+  bool removeLabel(std::string label);
   
   /**
    * Handles deletion of object pointers when client is exited
@@ -145,9 +184,17 @@ class Issue {
    * Issue assignee
    */
   std::string assign;
+  /**
+   * Issue id, stable for the life of the issue
+   */
+  uint64_t id;
   /**
    * Vector of Comment pointers
    */
   std::vector<Comment*> comments;
+  /**
+   * Labels (tags) categorizing the issue
+   */
+  std::vector<std::string> labels;
 };
 #endif /* NOLINT */
@@ -5,14 +5,68 @@
 
 #ifndef ISSUETRACKER_H /* NOLINT */
 #define ISSUETRACKER_H /* NOLINT */
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "ChangeLog.h"
 #include "Issue.h"
 #include "IssueTrackerUI.h"
+#include "ActivityRank.h"
+#include "Bitmap.h"
+#include "BitmapIndex.h"
+#include "PostingIndex.h"
+#include "PrefixIndex.h"
+#include "QueryParser.h"
+#include "TextIndex.h"
+#include "TrigramIndex.h"
 #include "User.h"
 
+/**
+ * Sizes of the store and what saving it has cost since startup
+ */
+struct StoreStats {
+  uint64_t issues;
+  uint64_t users;
+  uint64_t comments;
+  /**
+   * Calls to writeFile, their total time and the bytes they wrote
+   */
+  uint64_t writes;
+  uint64_t writeMicros;
+  uint64_t writeBytes;
+};
+
+/**
+ * Approximate memory held by each part of the store
+ */
+struct MemoryStats {
+  /**
+   * Issues with their text, labels and comment lists; comments with their
+   * text; users with their names
+   */
+  uint64_t issueBytes;
+  uint64_t commentBytes;
+  uint64_t userBytes;
+  /**
+   * The lists of issues and users
+   */
+  uint64_t listBytes;
+  /**
+   * Each index and lookup table, by name
+   */
+  std::vector<std::pair<std::string, uint64_t>> indexBytes;
+  /**
+   * Recent changes kept for the change feed
+   */
+  uint64_t changeBytes;
+};
+
 class IssueTracker {
  public:
   IssueTracker();
@@ -36,7 +90,8 @@ class IssueTracker {
 
   // Adders:
   /**
-   * Adds Issue pointer to vector issues
+   * Adds Issue pointer to vector issues, gives it an id if it has none and
+   * adds it to the secondary indexes
    * @param i Issue pointer
    */
   virtual void addToIssueVec(Issue* i);
@@ -62,6 +117,23 @@ class IssueTracker {
    * @return size of issues vector
    */
   int retSize();
+  /**
+   * Gets the tracker version, which increases on every successful mutation
+   * and is used by the server to build ETags
+   * @return current version
+   */
+  uint64_t getVersion();
+  /**
+   * Gets the sizes of the store and the cost of writing it so far
+   * @return counts of issues, users and comments, and writeFile totals
+   */
+  StoreStats getStoreStats();
+  /**
+   * Adds up the memory held by the store, walking every issue, comment
+   * and user
+   * @return bytes held by each part of the store
+   */
+  MemoryStats getMemoryStats();
 
   // Issue Methods
   /**
@@ -83,6 +155,14 @@ class IssueTracker {
    * @return the title of each existing issue
    */
   virtual std::string getAllIssues();
+  /**
+   * Retrieves one page of issue titles in creation order. If more issues
+   * follow, the page ends with "(MORE)" and the cursor to resume from.
+   * @param after cursor from the previous page, 0 for the first page
+   * @param limit most titles returned
+   * @return the title of each issue on the page, "(BLANK)" if there are none
+   */
+  virtual std::string getIssuePage(uint64_t after, size_t limit);
   /**
    * Retrieves an existing issue from the vector of issues based on it's title
    * @param issueTitle The issue title
@@ -90,12 +170,179 @@ class IssueTracker {
    */
   virtual std::string getAnIssue(std::string issueTitle);
   /**
-   * Deletes an existing issue from the issues vector based on it's title
-   * and re-writes the text file
+   * Retrieves an existing issue with one page of its comments. If more
+   * comments follow, the result ends with "(MORE)" and the cursor to resume
+   * from.
+   * @param issueTitle The issue title
+   * @param after index of the first comment on the page
+   * @param limit most comments returned
+   * @return returns the issue data if issue is found and "(BLANK)" if not
+   */
+  virtual std::string getAnIssuePage(std::string issueTitle, size_t after,
+                                     size_t limit);
+  /**
+   * Deletes every issue with a title from the issues vector and
+   * re-writes the text file
    * @param issueTitle The issue title
    * @return returns the status of issue deletion
    */
   virtual std::string deleteIssue(std::string title);
+  /**
+   * Finds the issues matching every non-empty filter using the secondary
+   * indexes. Only the shortest matching posting list is walked, so the cost
+   * follows the number of candidates rather than the number of issues.
+   * @param os Required operating system, "" for any
+   * @param type Required issue type, "" for any
+   * @param user Required author, "" for any
+   * @param assign Required assignee, "" for any
+   * @return matching issues in creation order
+   */
+  virtual std::vector<Issue*> findIssues(const std::string& os,
+                                         const std::string& type,
+                                         const std::string& user,
+                                         const std::string& assign);
+  /**
+   * Retrieves the titles of the issues matching every non-empty filter
+   * @param os Required operating system, "" for any
+   * @param type Required issue type, "" for any
+   * @param user Required author, "" for any
+   * @param assign Required assignee, "" for any
+   * @return the title of each matching issue, "(BLANK)" if none match
+   */
+  virtual std::string queryIssues(std::string os, std::string type,
+                                  std::string user, std::string assign);
+  /**
+   * Retrieves the issue and comment totals and the number of issues of each
+   * type, operating system, author and assignee. The counts are kept up to
+   * date on every change, so no issue is visited.
+   * @return "field^]value^]count^]" for each group, after the "total"
+   * groups "issues" and "comments"
+   */
+  virtual std::string getStats();
+  /**
+   * Retrieves the most active issues, ranked by their comments with recent
+   * comments counting more
+   * @param limit Most titles returned
+   * @return the title of each issue, hottest first, or "(BLANK)" if no
+   * issue has comments
+   */
+  virtual std::string getHotIssues(size_t limit);
+  /**
+   * Adds a label to an issue and writes it to labels.txt
+   * @param title Title of the issue
+   * @param label The label, which may not contain ',' or "^]"
+   * @return a message saying whether the label was added
+   */
+  virtual std::string addLabel(std::string title, std::string label);
+  /**
+   * Removes a label from an issue and from labels.txt
+   * @param title Title of the issue
+   * @param label The label
+   * @return a message saying whether the label was removed
+   */
+  virtual std::string removeLabel(std::string title, std::string label);
+  /**
+   * Finds the issues matching a combination of facets. A facet is
+   * "label:<label>", "type:<type>" or "os:<os>", and a bare word is a label.
+   * @param all Facets every issue must have (AND), empty for any
+   * @param any Facets an issue must have at least one of (OR), empty for any
+   * @param none Facets no issue may have (NOT)
+   * @return the ids of the matching issues
+   */
+  virtual Bitmap matchFacets(const std::vector<std::string>& all,
+                             const std::vector<std::string>& any,
+                             const std::vector<std::string>& none);
+  /**
+   * Retrieves the titles of the issues matching a combination of facets
+   * @param all Comma separated facets every issue must have
+   * @param any Comma separated facets an issue must have one of
+   * @param none Comma separated facets no issue may have
+   * @return the title of each matching issue, "(BLANK)" if none match
+   */
+  virtual std::string labelQuery(std::string all, std::string any,
+                                 std::string none);
+  /**
+   * Counts the issues matching a combination of facets by label, type and
+   * OS, for narrowing the query further
+   * @param all Comma separated facets every issue must have
+   * @param any Comma separated facets an issue must have one of
+   * @param none Comma separated facets no issue may have
+   * @return "facet^]count^]" for each facet of a matching issue, after
+   * "total^]count^]"
+   */
+  virtual std::string facetCounts(std::string all, std::string any,
+                                  std::string none);
+  /**
+   * Retrieves the issues matching a query such as
+   * "type:Bug AND os:Linux AND NOT assignee:user_Removed AND comments>5".
+   * Predicates on type, os, label, user (author), assignee and title are
+   * answered from the indexes, most selective first; only the remaining
+   * predicates (comments, desc) visit issues, and only the candidates the
+   * indexes left.
+   * @param query The query, see QueryParser
+   * @param explain True to describe the plan instead of running it for
+   * titles
+   * @return the title of each matching issue, "(BLANK)" if none match, the
+   * plan with the number of issues examined if explain is set, or
+   * "(ERROR)" and a reason if the query is invalid
+   */
+  virtual std::string filterIssues(std::string query, bool explain);
+  /**
+   * Saves a filterIssues query under a name and materializes its matches.
+   * The matches are updated whenever an issue changes, so reading the view
+   * never runs the query again. Saving over an existing name replaces it.
+   * @param name Name of the view, which may not contain "^]"
+   * @param query The query, see QueryParser
+   * @return a message with the number of matching issues, or "(ERROR)" and
+   * a reason if the query is invalid
+   */
+  virtual std::string saveView(std::string name, std::string query);
+  /**
+   * Retrieves the issues of a saved view, at a cost that follows the
+   * number of matches rather than the number of issues
+   * @param name Name of the view
+   * @return the title of each matching issue, "(BLANK)" if none match, or
+   * "(ERROR)" if there is no such view
+   */
+  virtual std::string getView(std::string name);
+  /**
+   * Deletes a saved view
+   * @param name Name of the view
+   * @return a message saying whether the view was deleted
+   */
+  virtual std::string deleteView(std::string name);
+  /**
+   * Retrieves every saved view
+   * @return "name^]query^]count^]" for each view by name, "(BLANK)" if
+   * there are none
+   */
+  virtual std::string listViews();
+
+  /**
+   * Ranks issues against a full-text query over titles, descriptions and
+   * comments using BM25
+   * @param query The search text
+   * @param k Most issues returned
+   * @return the title of each matching issue, best first, or "(BLANK)"
+   */
+  virtual std::string searchIssues(std::string query, size_t k);
+  /**
+   * Finds issues whose title contains a fragment, allowing a few typos
+   * @param fragment The remembered piece of the title
+   * @param maxEdits Most typos allowed, 0 for an exact substring
+   * @param limit Most titles returned
+   * @return the matching titles, closest first, or "(BLANK)" if none match
+   */
+  virtual std::string findIssueTitles(std::string fragment, int maxEdits,
+                                      size_t limit);
+  /**
+   * Completes the start of an issue title
+   * @param prefix The start typed so far, matched ignoring case
+   * @param limit Most titles returned
+   * @return the first titles alphabetically starting with prefix, or
+   * "(BLANK)" if there are none
+   */
+  virtual std::string completeIssueTitles(std::string prefix, size_t limit);
 
   // User Methods
   /**
@@ -116,6 +363,31 @@ class IssueTracker {
    * @return returns all existing users
    */
   virtual std::string getAllUsers();
+  /**
+   * Retrieves one page of usernames in alphabetical order. If more users
+   * follow, the page ends with "(MORE)" and the cursor to resume from.
+   * @param after cursor from the previous page, "" for the first page
+   * @param limit most usernames returned
+   * @return the usernames on the page separated by '-'
+   */
+  virtual std::string getUserPage(const std::string& after, size_t limit);
+  /**
+   * Finds users whose name contains a fragment, allowing a few typos
+   * @param fragment The remembered piece of the username
+   * @param maxEdits Most typos allowed, 0 for an exact substring
+   * @param limit Most usernames returned
+   * @return the matching usernames separated by '-', closest first
+   */
+  virtual std::string findUsers(std::string fragment, int maxEdits,
+                                size_t limit);
+  /**
+   * Completes the start of a username
+   * @param prefix The start typed so far, matched ignoring case
+   * @param limit Most usernames returned
+   * @return the first usernames alphabetically starting with prefix,
+   * separated by '-'
+   */
+  virtual std::string completeUsers(std::string prefix, size_t limit);
   /**
    * Deletes an existing user from the users vector as well as from
    * comments and issues and re-writes the text files
@@ -142,6 +414,28 @@ class IssueTracker {
    */
   virtual std::string getComments(Issue* issue);
 
+  // Change Feed Methods
+  /**
+   * Gets the changes committed after a version the client has already seen,
+   * or a full snapshot of the issue titles if the client is too far behind
+   * @param since version the client has already seen
+   * @return "(DELTA)" followed by the version and kind/key pairs, or
+   * "(SNAPSHOT)" followed by the version and every issue title
+   */
+  virtual std::string getChangesSince(uint64_t since);
+  /**
+   * Gets a full snapshot of the issue titles with the current version
+   * @return "(SNAPSHOT)" followed by the version and every issue title
+   */
+  virtual std::string getSnapshot();
+  /**
+   * Gets the changes committed after a version as records
+   * @param since version the caller has already seen
+   * @param delta filled with the changes, oldest first
+   * @return false if that version is no longer covered by the change ring
+   */
+  virtual bool getChangeList(uint64_t since, std::vector<Change>& delta);
+
   // Parse Methods
   /**
    * Reads from comments.txt and context.txt when server is first started and
@@ -157,15 +451,208 @@ class IssueTracker {
    * files if any changes are made.
    */
   virtual void writeFile();
+  /**
+   * Saves the search index to search.idx, stamped with the checksums of
+   * the store files it matches, if the store changed since the index was
+   * last saved or loaded
+   * @return true if the index was written
+   */
+  bool saveIndex();
 
  private:
+  /**
+   * Adds an issue to the secondary indexes
+   * @param i Issue pointer
+   */
+  void indexIssue(Issue* i);
+  /**
+   * Removes an issue from the secondary indexes
+   * @param i Issue pointer
+   */
+  void unindexIssue(Issue* i);
+  /**
+   * Finds the latest issue with a title
+   * @param title the title
+   * @return the issue, NULL if no issue has the title
+   */
+  Issue* latestIssue(const std::string& title);
+  /**
+   * Adds a label to an issue and to the facet index
+   * @param i Issue pointer
+   * @param label The label
+   * @return false if the issue already had the label
+   */
+  bool labelIssue(Issue* i, const std::string& label);
+  /**
+   * Adds an issue to the saved views it now matches and removes it from
+   * the ones it no longer matches
+   * @param i Issue pointer
+   */
+  void refreshViews(Issue* i);
+  /**
+   * Writes the saved views to views.txt
+   */
+  void writeViews();
+  /**
+   * Checks whether a query has an index for a predicate
+   * @param term TERM node
+   * @return true if the predicate is answered without visiting issues
+   */
+  bool indexed(const QueryNode& term);
+  /**
+   * Checks whether a query can only be answered by visiting issues
+   * @param node query node
+   * @return true if some predicate without an index decides the result
+   */
+  bool needsScan(const QueryNode& node);
+  /**
+   * Runs a query, from the indexes where it can be
+   * @param root parsed and checked query
+   * @param plan set to a description of each step
+   * @param examined set to the number of issues visited
+   * @return ids of the matching issues
+   */
+  Bitmap evaluate(const QueryNode& root, std::string* plan,
+                  uint64_t* examined);
+  /**
+   * Checks a query against one issue without using any index
+   * @param i Issue pointer
+   * @param node query node
+   * @return true if the issue matches
+   */
+  bool matchesQuery(Issue* i, const QueryNode& node);
+  /**
+   * Gets the issues an index holds for a predicate
+   * @param term TERM node, for which indexed is true
+   * @return ids of the matching issues
+   */
+  Bitmap lookupTerm(const QueryNode& term);
+  /**
+   * Answers a query from the indexes, filtering the candidates they leave
+   * by any predicates that have no index
+   * @param node query node, for which needsScan is false
+   * @param depth nesting depth, for indenting the plan
+   * @param plan set to a description of each step
+   * @param examined incremented by the number of issues visited
+   * @return ids of the matching issues
+   */
+  Bitmap runQuery(const QueryNode& node, int depth, std::string* plan,
+                  uint64_t* examined);
+  /**
+   * A named query and the ids of the issues it currently matches
+   */
+  struct SavedView {
+    std::string query;
+    QueryNode root;
+    Bitmap ids;
+  };
+
+  /**
+   * Gets all searchable text of an issue (title, description and comments)
+   * @param i Issue pointer
+   * @return the text, one piece per line
+   */
+  std::string issueText(Issue* i);
+
   /**
    * Vector of Issue pointers
    */
   std::vector<Issue*> issues;
+  /**
+   * Issues by id, in creation order
+   */
+  std::map<uint64_t, Issue*> issuesById;
+  /**
+   * Issues by title, oldest first, since titles may repeat
+   */
+  std::unordered_map<std::string, std::vector<Issue*>> issuesByTitle;
+  /**
+   * Usernames in alphabetical order, for paging through users
+   */
+  std::set<std::string> userNames;
+  /**
+   * Id given to the next issue added
+   */
+  uint64_t nextIssueId;
+  /**
+   * Number of comments on all issues
+   */
+  uint64_t commentTotal;
+  /**
+   * writeFile calls, their total microseconds and the bytes they wrote
+   */
+  uint64_t writeCount;
+  uint64_t writeMicros;
+  uint64_t writeBytes;
+  /**
+   * Full-text index of issue titles, descriptions and comments
+   */
+  TextIndex text;
+  /**
+   * Trigrams of issue titles
+   */
+  TrigramIndex titleGrams;
+  /**
+   * Trigrams of usernames
+   */
+  TrigramIndex userGrams;
+  /**
+   * Issue titles sorted for completion
+   */
+  PrefixIndex titlePrefixes;
+  /**
+   * Usernames sorted for completion
+   */
+  PrefixIndex userPrefixes;
+  /**
+   * Issue ids ranked by comment activity
+   */
+  ActivityRank activity;
+  /**
+   * Issue ids by label, type and OS facet
+   */
+  BitmapIndex facets;
+  /**
+   * Ids of every issue, which NOT queries subtract from
+   */
+  Bitmap allIds;
+  /**
+   * Saved views by name
+   */
+  std::map<std::string, SavedView> views;
+  /**
+   * Set while readFile loads issues, whose text is indexed afterwards
+   */
+  bool loadingFile;
+  /**
+   * CRC-32 of context.txt and comments.txt as last read or written, which
+   * search.idx is stamped with, and whether search.idx matches them
+   */
+  std::string storeChecksum;
+  bool indexSaved;
+  /**
+   * Issue ids by operating system
+   */
+  PostingIndex byOS;
+  /**
+   * Issue ids by issue type
+   */
+  PostingIndex byType;
+  /**
+   * Issue ids by author
+   */
+  PostingIndex byUser;
+  /**
+   * Issue ids by assignee
+   */
+  PostingIndex byAssign;
   /**
    * Vector of User pointers
    */
   std::vector<User*> users;
+  /**
+   * Ring of recent mutations, whose latest sequence number is the version
+   */
+  ChangeLog changes;
 };
 #endif /* NOLINT */
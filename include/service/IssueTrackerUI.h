@@ -31,6 +31,31 @@ class IssueTrackerUI {
    *  Lists existing issues by titles
    */
   void displayIssues();
+  /**
+   *  Prompts user for the filters of an issue search, blank for any value
+   *  @param os operating system filter
+   *  @param type issue type filter
+   *  @param user author filter
+   *  @param assign assignee filter
+   */
+  void enterIssueFilters(std::string& os, std::string& type,
+                         std::string& user, std::string& assign);
+  /**
+   *  Prompts user for the text of a full-text search
+   *  @return the search text
+   */
+  std::string enterSearch();
+  /**
+   *  Prompts user for the start or part of an issue title, blank to list
+   *  every issue
+   *  @return the title fragment
+   */
+  std::string enterTitleFragment();
+  /**
+   *  Prompts user for the first letters of the user to assign an issue to
+   *  @return the username prefix, blank for the first users alphabetically
+   */
+  std::string enterAssigneePrefix();
 
   /**
    *  Displays the UI login screen
@@ -65,17 +90,16 @@ class IssueTrackerUI {
 
   /**
    *  Displays issue creation page and takes in user input as fields for issues
-   *  in order to create a new issue
+   *  in order to create a new issue. The assignee is picked afterwards from
+   *  the usernames completing enterAssigneePrefix.
    *  @param title issue title
    *  @param desc issue description
    *  @param os operating system of machine(s) affected by issue
    *  @param type type of issues (bug/feature/task)
    *  @param user author of issue
-   *  @param assign user assigned to issue
    */
   void enterIssueFields(std::string& title, std::string& desc, std::string& os,
-                        std::string& type, std::string& user,
-                        std::string& assign);
+                        std::string& type, std::string& user);
 
   /**
    *  Checks for existing titles when creating a new issue
@@ -91,9 +115,10 @@ class IssueTrackerUI {
   void parseMessage(std::string message);
   
   /**
-   *  Lists all active users
+   *  Lists one page of active users
+   *  @return true if the user asked for the next page
    */
-  void listAllUsers();
+  bool listAllUsers();
   /**
    *  Prompts user to delete their account
    *  @return true if user chooses to delete their account and false otherwise
@@ -152,7 +177,8 @@ class IssueTrackerUI {
   /**
    *  Displays a single issue and all its information as well as prompting 
    *  user to either add a comment or return to main menu
-   *  @return new comment if added or (NoComment) if user chooses to return home
+   *  @return new comment if added, (MoreComments) if user asks for the next
+   *  page of comments or (NoComment) if user chooses to return home
    */
   std::string displaySingleIssue();
   /**
@@ -173,6 +199,11 @@ class IssueTrackerUI {
    * Vector of title data parsed and sent from server
    */
   std::vector<std::string> titleData;
+  /**
+   * Cursor for the next page of the last paged message, empty on the last
+   * page
+   */
+  std::string nextCursor;
 
  private:
   /**
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef LATENCYHISTOGRAM_H /* NOLINT */
+#define LATENCYHISTOGRAM_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Histogram of latencies laid out like an HDR histogram: values below 128
+ * get a bucket each and every larger power of two range is split into 64
+ * buckets, so any recorded value is reported within 1.6% of itself while
+ * the whole 64 bit range fits in under 4000 counters. Recording is a few
+ * shifts and an increment, and histograms of the same values merge by
+ * adding counters, so each thread can keep its own.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+  ~LatencyHistogram() {}
+
+  /**
+   * Records a value
+   * @param value the latency, in whatever unit the caller uses throughout
+   */
+  void record(uint64_t value);
+  /**
+   * Adds every value recorded by another histogram
+   * @param other the histogram
+   */
+  void merge(const LatencyHistogram& other);
+  /**
+   * Gets the value below which a share of the recorded values fall
+   * @param percent share of the values, from 0 to 100
+   * @return the percentile, 0 if nothing was recorded
+   */
+  uint64_t percentile(double percent) const;
+  /**
+   * Gets the number of values recorded
+   * @return number of values
+   */
+  uint64_t count() const;
+  /**
+   * Gets the smallest value recorded
+   * @return the minimum, 0 if nothing was recorded
+   */
+  uint64_t min() const;
+  /**
+   * Gets the largest value recorded
+   * @return the maximum, 0 if nothing was recorded
+   */
+  uint64_t max() const;
+  /**
+   * Gets the average of the values recorded
+   * @return the mean, 0 if nothing was recorded
+   */
+  double mean() const;
+  /**
+   * Removes every value
+   */
+  void clear();
+
+ private:
+  /**
+   * Finds the bucket counting a value
+   * @param value the value
+   * @return index into counts
+   */
+  static size_t bucketOf(uint64_t value);
+  /**
+   * Gets the largest value a bucket counts
+   * @param bucket index into counts
+   * @return the value reported for the bucket
+   */
+  static uint64_t highestIn(size_t bucket);
+
+  /**
+   * Number of values in each bucket
+   */
+  std::vector<uint64_t> counts;
+  uint64_t total;
+  uint64_t smallest;
+  uint64_t largest;
+  /**
+   * Sum of the values, for the mean
+   */
+  double sum;
+};
+#endif /* NOLINT */
@@ -0,0 +1,174 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef METRICS_H /* NOLINT */
+#define METRICS_H /* NOLINT */
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+/**
+ * Request counters and latency histograms per operation, exposed in the
+ * Prometheus text format. Every thread records into its own shard, found
+ * through a thread-local pointer, so observe takes no lock and no atomic
+ * read-modify-write: a handful of relaxed loads and stores.
+ * Shards are only summed when the metrics are read.
+ *
+ * Latencies fall into power of two buckets from 1 microsecond up to
+ * 2^25 microseconds (about 34 seconds), plus one for anything longer.
+ */
+class Metrics {
+ public:
+  /**
+   * Histogram buckets, the last one unbounded
+   */
+  static const int BUCKETS = 27;
+
+  /**
+   * Totals of one operation over all threads
+   */
+  struct Totals {
+    uint64_t count;
+    uint64_t errors;
+    uint64_t micros;
+    /**
+     * Requests that took at most 2^i microseconds but more than 2^(i-1);
+     * not cumulative
+     */
+    uint64_t buckets[BUCKETS];
+    /**
+     * Heap allocations made and bytes they asked for, if counted
+     */
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+  };
+
+  /**
+   * State of the malloc heap, summed over its arenas
+   */
+  struct HeapStats {
+    uint64_t arenas;
+    /**
+     * Bytes malloc has from the system for its arenas, and the most it
+     * ever had
+     */
+    uint64_t systemBytes;
+    uint64_t maxSystemBytes;
+    /**
+     * Free chunks held in the arenas and their bytes; memory taken from
+     * the system that is not in use
+     */
+    uint64_t freeChunks;
+    uint64_t freeBytes;
+    /**
+     * Allocations large enough to be mapped on their own
+     */
+    uint64_t mmapChunks;
+    uint64_t mmapBytes;
+  };
+
+  /**
+   * @param prefix start of every metric name, e.g. "issueserver"
+   * @param operations name of each operation, by number
+   */
+  Metrics(const std::string& prefix,
+          const std::vector<std::string>& operations);
+  ~Metrics() {}
+
+  /**
+   * Records one request; safe to call from any thread
+   * @param operation number of the operation, out of range ones ignored
+   * @param micros how long it took
+   * @param failed whether it failed
+   */
+  void observe(size_t operation, uint64_t micros, bool failed);
+  /**
+   * Records what one request allocated; safe to call from any thread
+   * @param operation number of the operation, out of range ones ignored
+   * @param allocations heap allocations it made
+   * @param bytes bytes they asked for
+   */
+  void observeAllocations(size_t operation, uint64_t allocations,
+                          uint64_t bytes);
+  /**
+   * Sums an operation over all threads
+   * @param operation number of the operation
+   * @return its totals
+   */
+  Totals totals(size_t operation);
+  /**
+   * Formats the request counters and histograms, leaving out histograms of
+   * operations never requested, and allocations per request if any were
+   * recorded
+   * @return Prometheus text exposition lines
+   */
+  std::string format();
+
+  /**
+   * Appends one gauge or counter in the Prometheus text format
+   * @param out text to append to
+   * @param name metric name
+   * @param type "gauge" or "counter"
+   * @param help description of the metric
+   * @param value the value
+   */
+  static void append(std::string* out, const std::string& name,
+                     const std::string& type, const std::string& help,
+                     double value);
+  /**
+   * Gets the resident memory of this process
+   * @return bytes in RAM, 0 if unknown
+   */
+  static uint64_t residentBytes();
+  /**
+   * Reads the state of the malloc heap from malloc_info
+   * @param stats filled in with the heap totals
+   * @return false if malloc_info is unavailable or could not be read
+   */
+  static bool heapStats(HeapStats* stats);
+
+ private:
+  /**
+   * Counters of one operation in one shard; written only by the shard's
+   * thread
+   */
+  struct Slot {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> micros;
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> allocatedBytes;
+  };
+  /**
+   * One thread's counters
+   */
+  struct Shard {
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  /**
+   * Gets the calling thread's shard, creating it on first use
+   * @return the shard
+   */
+  Shard* shard();
+
+  std::string prefix;
+  std::vector<std::string> operations;
+  /**
+   * Tells shards of this object apart from those of any other, even one
+   * later created at the same address
+   */
+  uint64_t id;
+  std::mutex lock;
+  std::map<std::thread::id, std::unique_ptr<Shard>> shards;
+};
+#endif /* NOLINT */
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef POSTINGINDEX_H /* NOLINT */
+#define POSTINGINDEX_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Secondary index from a field value to the sorted ids of the issues that
+ * have it. Ids are handed out in increasing order, so adding an issue is an
+ * append to the end of its posting list.
+ */
+class PostingIndex {
+ public:
+  PostingIndex() {}
+  ~PostingIndex() {}
+
+  /**
+   * Adds an issue to the posting list of a value
+   * @param value field value of the issue
+   * @param id issue id
+   */
+  void add(const std::string& value, uint64_t id);
+  /**
+   * Removes an issue from the posting list of a value
+   * @param value field value the issue was indexed under
+   * @param id issue id
+   */
+  void remove(const std::string& value, uint64_t id);
+  /**
+   * Gets the ids of the issues with a value
+   * @param value field value
+   * @return sorted issue ids, empty if no issue has the value
+   */
+  const std::vector<uint64_t>& get(const std::string& value) const;
+  /**
+   * Checks whether an issue is indexed under a value
+   * @param value field value
+   * @param id issue id
+   * @return true if the issue has the value
+   */
+  bool contains(const std::string& value, uint64_t id) const;
+  /**
+   * Gets the distinct values that have at least one issue
+   * @return number of posting lists
+   */
+  size_t size() const;
+  /**
+   * Gets the number of issues with each value, read off the posting lists
+   * @return value and issue count pairs, in no particular order
+   */
+  std::vector<std::pair<std::string, size_t>> counts() const;
+  /**
+   * Gets the approximate memory held by the index
+   * @return bytes used by the values and posting lists
+   */
+  size_t bytes() const;
+  /**
+   * Removes every posting list
+   */
+  void clear();
+
+ private:
+  /**
+   * Sorted issue ids by field value
+   */
+  std::unordered_map<std::string, std::vector<uint64_t>> postings;
+};
+#endif /* NOLINT */
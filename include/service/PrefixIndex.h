@@ -0,0 +1,76 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef PREFIXINDEX_H /* NOLINT */
+#define PREFIXINDEX_H /* NOLINT */
+
+#include <string>
+#include <vector>
+
+/**
+ * Strings (issue titles or usernames) kept in one sorted array, ignoring
+ * case, so that every string starting with a prefix sits in one contiguous
+ * run found by binary search. Adding or removing shifts the array, which is
+ * cheap next to the file rewrite every mutation already does.
+ */
+class PrefixIndex {
+ public:
+  PrefixIndex() {}
+  ~PrefixIndex() {}
+
+  /**
+   * Adds a string
+   * @param key the string
+   */
+  void add(const std::string& key);
+  /**
+   * Removes a string
+   * @param key the string
+   */
+  void remove(const std::string& key);
+  /**
+   * Gets the first strings, in alphabetical order, starting with a prefix
+   * @param prefix the start typed so far, matched ignoring case
+   * @param limit most strings returned
+   * @return the completions
+   */
+  std::vector<std::string> complete(const std::string& prefix, size_t limit);
+  /**
+   * Gets the number of indexed strings
+   * @return number of strings
+   */
+  size_t size();
+  /**
+   * Gets the approximate memory held by the index
+   * @return bytes used by the array and its strings
+   */
+  size_t bytes();
+  /**
+   * Removes every string
+   */
+  void clear();
+
+ private:
+  /**
+   * Orders strings ignoring case
+   * @param a first string
+   * @param b second string
+   * @return true if a sorts before b when both are lowercased
+   */
+  static bool foldedBefore(const std::string& a, const std::string& b);
+  /**
+   * Orders strings ignoring case, then by exact bytes
+   * @param a first string
+   * @param b second string
+   * @return true if a sorts before b
+   */
+  static bool before(const std::string& a, const std::string& b);
+
+  /**
+   * The strings, sorted with before
+   */
+  std::vector<std::string> sorted;
+};
+#endif /* NOLINT */
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef PROFILER_H /* NOLINT */
+#define PROFILER_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * In-process CPU profiler. While started, an ITIMER_PROF timer sends
+ * SIGPROF to the process for every 1/hz seconds of CPU time it uses, and
+ * the handler walks the interrupted thread's frame pointers into a buffer
+ * set aside by start, so nothing is allocated or locked inside the signal.
+ * Stacks are only complete through code built with frame pointers (as the
+ * Makefile builds the server, with -fno-omit-frame-pointer); a walk stops
+ * at the first frame that does not keep one, and x86-64 and AArch64 are
+ * the only layouts known.
+ * stop turns the timer off and folds the stacks into one line per
+ * distinct stack, as flamegraph.pl and speedscope read them. When not
+ * started there is no timer and no handler, so it costs nothing.
+ *
+ * Frames are named from the dynamic symbol table, so the program must be
+ * linked with -rdynamic for its own functions to be named; others show as
+ * module+offset for addr2line.
+ */
+class Profiler {
+ public:
+  /**
+   * Deepest stack kept; deeper ones lose their outermost frames
+   */
+  static const int MAX_DEPTH = 64;
+
+  /**
+   * Starts sampling the whole process
+   * @param hz samples per second of CPU time, 1 to 1000
+   * @param capacity samples to keep; later ones are counted as dropped
+   * @return false if already started or the timer could not be set
+   */
+  static bool start(int hz, size_t capacity);
+  /**
+   * Checks whether the profiler is sampling
+   * @return true between start and stop
+   */
+  static bool running();
+  /**
+   * Stops sampling and folds the samples taken
+   * @return "outer;...;inner count" lines sorted by stack, or "" if not
+   * started
+   */
+  static std::string stop();
+  /**
+   * Gets the samples the last run could not keep
+   * @return samples beyond its capacity
+   */
+  static uint64_t dropped();
+};
+#endif /* NOLINT */
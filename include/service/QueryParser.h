@@ -0,0 +1,140 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef QUERYPARSER_H /* NOLINT */
+#define QUERYPARSER_H /* NOLINT */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * A parsed issue query: a predicate such as "type:Bug" or "comments>5", or
+ * AND, OR or NOT over other nodes
+ */
+struct QueryNode {
+  enum Kind { AND, OR, NOT, TERM };
+  Kind kind;
+  /**
+   * Field, operator and value of a TERM, empty otherwise
+   */
+  std::string field;
+  std::string op;
+  std::string value;
+  /**
+   * Operands of AND, OR and NOT
+   */
+  std::vector<QueryNode> children;
+};
+
+/**
+ * Parses issue queries such as
+ *   type:Bug AND os:Linux AND NOT assignee:user_Removed AND comments>5
+ * Predicates are field, operator (: = != > >= < <=) and value, where the
+ * value may be double quoted to hold spaces. "=" is read as ":" and "a!=b"
+ * as "NOT a:b". NOT binds tighter than AND, which binds tighter than OR,
+ * and parentheses group. Predicates written next to each other are ANDed.
+ * Keywords are case-insensitive.
+ */
+class QueryParser {
+ public:
+  /**
+   * Parses a query
+   * @param text the query
+   * @param root set to the parsed query
+   * @param error set to what is wrong with the query when parsing fails
+   * @return false if the query is malformed
+   */
+  static bool parse(const std::string& text, QueryNode* root,
+                    std::string* error);
+  /**
+   * Writes a query back out, fully parenthesized
+   * @param node the query
+   * @return the query text
+   */
+  static std::string describe(const QueryNode& node);
+
+ private:
+  explicit QueryParser(const std::string& text)
+      : text(text), pos(0), depth(0) {}
+
+  /**
+   * Deepest nesting of parentheses and NOTs accepted, since each level
+   * recurses
+   */
+  static const size_t MAX_DEPTH = 64;
+
+  /**
+   * Parses operands joined by OR
+   * @param node set to the parsed expression
+   * @return false on a syntax error
+   */
+  bool parseOr(QueryNode* node);
+  /**
+   * Parses operands joined by AND or written next to each other
+   * @param node set to the parsed expression
+   * @return false on a syntax error
+   */
+  bool parseAnd(QueryNode* node);
+  /**
+   * Parses a predicate, a parenthesized query or NOT followed by either
+   * @param node set to the parsed expression
+   * @return false on a syntax error
+   */
+  bool parseUnary(QueryNode* node);
+  /**
+   * Parses a field, operator and value
+   * @param node set to the parsed predicate
+   * @return false on a syntax error
+   */
+  bool parseTerm(QueryNode* node);
+  /**
+   * Parses the operand of a NOT or the inside of parentheses, one level
+   * deeper
+   * @param node set to the parsed expression
+   * @param inner parseUnary or parseOr
+   * @return false on a syntax error or when nested too deeply
+   */
+  bool parseNested(QueryNode* node, bool (QueryParser::*inner)(QueryNode*));
+  /**
+   * Consumes a keyword if it comes next as a whole word
+   * @param word the keyword, in upper case
+   * @return true if the keyword was consumed
+   */
+  bool keyword(const char* word);
+  /**
+   * Checks whether the rest of the query could start another operand
+   * @return true at a predicate, "(" or NOT
+   */
+  bool atOperand();
+  /**
+   * Skips whitespace
+   */
+  void skipSpaces();
+  /**
+   * Records a syntax error at the current position
+   * @param what what was expected
+   * @return false
+   */
+  bool fail(const std::string& what);
+
+  /**
+   * The query being parsed
+   */
+  std::string text;
+  /**
+   * Index of the next unparsed character
+   */
+  size_t pos;
+  /**
+   * Parentheses and NOTs open at pos
+   */
+  size_t depth;
+  /**
+   * Description of the first syntax error
+   */
+  std::string error;
+};
+#endif /* NOLINT */
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef REQUESTLOG_H /* NOLINT */
+#define REQUESTLOG_H /* NOLINT */
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+/**
+ * Log of the requests a server received, for replaying them later. The
+ * file starts with "IRQL1\n" and holds one record per request: a varint
+ * length followed by a WireFrame whose kind is GET_REQUEST or POST_REQUEST,
+ * whose id is the microseconds since the previous request and whose
+ * payload is the request in WebSocket form (query parameters joined by
+ * WireFrame::encodeParams, or the "~"-delimited POST body as received).
+ * Records are collected in memory and written in blocks, so capturing
+ * costs little more than a copy.
+ */
+class RequestLog {
+ public:
+  /**
+   * One request read back from a log
+   */
+  struct Entry {
+    /**
+     * Microseconds from the first request to this one
+     */
+    uint64_t micros;
+    int kind;
+    std::string payload;
+  };
+
+  RequestLog();
+  ~RequestLog();
+
+  /**
+   * Starts capturing to a file, replacing it
+   * @param path the file
+   * @return false if the file could not be created
+   */
+  bool open(const std::string& path);
+  /**
+   * Checks whether requests are being captured
+   * @return true if a file is open
+   */
+  bool isOpen();
+  /**
+   * Adds a request that just arrived; safe to call from any thread
+   * @param kind WireFrame::GET_REQUEST or WireFrame::POST_REQUEST
+   * @param payload the request in WebSocket form
+   */
+  void record(int kind, const std::string& payload);
+  /**
+   * Writes the records collected so far to the file
+   */
+  void flush();
+  /**
+   * Writes what is left and stops capturing
+   */
+  void close();
+
+  /**
+   * Reads a whole log, stopping at a record cut off by a crash
+   * @param path the file
+   * @param entries filled with the requests in arrival order
+   * @return false if the file cannot be read or is not a request log
+   */
+  static bool read(const std::string& path, std::vector<Entry>* entries);
+
+ private:
+  /**
+   * Writes the buffer without taking the lock
+   */
+  void write();
+
+  std::mutex lock;
+  FILE* file;
+  std::string buffer;
+  std::chrono::steady_clock::time_point last;
+  bool started;
+};
+#endif /* NOLINT */
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef RESPONSECACHE_H /* NOLINT */
+#define RESPONSECACHE_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Serialized GET responses (already JSON-dumped and, if negotiated,
+ * compressed) for one tracker version. Every entry is dropped as soon as a
+ * newer version is stored, so entries never outlive the data they describe.
+ */
+class ResponseCache {
+ public:
+  /**
+   * Constructor for ResponseCache
+   * @param maxEntries entries kept before the cache starts over
+   */
+  explicit ResponseCache(size_t maxEntries = 1024);
+  ~ResponseCache() {}
+
+  /**
+   * Looks up a response
+   * @param key request key, including the response encoding
+   * @param version current tracker version
+   * @param body set to the cached response body
+   * @param encoding set to the Content-Encoding of the body ("" if none)
+   * @return true on a hit for this version
+   */
+  bool get(const std::string& key, uint64_t version, std::string* body,
+           std::string* encoding);
+  /**
+   * Stores a response
+   * @param key request key, including the response encoding
+   * @param version tracker version the response was built from
+   * @param body the response body
+   * @param encoding the Content-Encoding of the body ("" if none)
+   */
+  void put(const std::string& key, uint64_t version, const std::string& body,
+           const std::string& encoding);
+  /**
+   * Gets the number of cached responses
+   * @return number of entries
+   */
+  size_t size();
+  /**
+   * Gets the bytes held by cached response bodies and keys
+   * @return approximate bytes used
+   */
+  size_t bytes();
+
+ private:
+  /**
+   * A cached response body and its encoding
+   */
+  struct Entry {
+    std::string body;
+    std::string encoding;
+  };
+  /**
+   * Cached responses by key, all for cachedVersion
+   */
+  std::unordered_map<std::string, Entry> entries;
+  /**
+   * Tracker version every entry was built from
+   */
+  uint64_t cachedVersion;
+  /**
+   * Entries kept before the cache starts over
+   */
+  size_t capacity;
+  /**
+   * Bytes held by bodies and keys
+   */
+  size_t usedBytes;
+};
+#endif /* NOLINT */
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef SLOWLOG_H /* NOLINT */
+#define SLOWLOG_H /* NOLINT */
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+/**
+ * Log of requests slower than a threshold, one line each. Lines are
+ * queued and written by a thread of the log's own, so a slow request never
+ * waits on the disk; if the disk falls behind by more than MAX_QUEUED
+ * lines, new ones are dropped and counted instead.
+ */
+class SlowLog {
+ public:
+  /**
+   * Lines waiting to be written before new ones are dropped
+   */
+  static const size_t MAX_QUEUED = 10000;
+
+  SlowLog();
+  ~SlowLog();
+
+  /**
+   * Starts logging to a file, appending to it
+   * @param path the file
+   * @param thresholdMicros requests taking at least this long are logged
+   * @return false if the file could not be opened
+   */
+  bool open(const std::string& path, uint64_t thresholdMicros);
+  /**
+   * Checks whether slow requests are being logged
+   * @return true if a file is open
+   */
+  bool isOpen();
+  /**
+   * Gets the time from which requests are logged
+   * @return microseconds
+   */
+  uint64_t getThreshold();
+  /**
+   * Queues a line; safe to call from any thread and never waits on I/O
+   * @param line the entry, without a newline
+   */
+  void write(const std::string& line);
+  /**
+   * Gets the number of lines written or waiting to be
+   * @return lines accepted since opening
+   */
+  uint64_t getLogged();
+  /**
+   * Gets the number of lines dropped because the queue was full
+   * @return lines dropped since opening
+   */
+  uint64_t getDropped();
+  /**
+   * Writes every queued line and stops logging
+   */
+  void close();
+
+ private:
+  /**
+   * Writes queued lines until closed
+   */
+  void run();
+
+  std::mutex lock;
+  std::condition_variable wake;
+  std::deque<std::string> queue;
+  std::thread writer;
+  FILE* file;
+  uint64_t threshold;
+  uint64_t logged;
+  uint64_t dropped;
+  bool stopping;
+};
+#endif /* NOLINT */
@@ -0,0 +1,27 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef STRINGBYTES_H /* NOLINT */
+#define STRINGBYTES_H /* NOLINT */
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Memory accounting for strings, shared by every bytes() estimate so they
+ * agree on what a string costs
+ */
+class StringBytes {
+ public:
+  /**
+   * Gets the heap memory a string holds beyond its own object. Short
+   * strings are stored inside the object, up to the capacity an empty
+   * string reports, and hold none.
+   * @param s the string
+   * @return its buffer and terminator, or 0 for a short string
+   */
+  static size_t heap(const std::string& s);
+};
+#endif /* NOLINT */
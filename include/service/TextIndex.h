@@ -0,0 +1,136 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef TEXTINDEX_H /* NOLINT */
+#define TEXTINDEX_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Inverted index over document text, ranked with BM25. A document is an
+ * issue: its title, description and comments are all added under its id.
+ */
+class TextIndex {
+ public:
+  TextIndex();
+  ~TextIndex() {}
+
+  /**
+   * Splits text into lowercase alphanumeric terms
+   * @param text the text to split
+   * @return the terms in order of appearance
+   */
+  static std::vector<std::string> tokenize(const std::string& text);
+
+  /**
+   * Adds text to a document, creating the document if it is new
+   * @param doc document id
+   * @param text text added to the document
+   */
+  void add(uint64_t doc, const std::string& text);
+  /**
+   * Removes a document entirely
+   * @param doc document id
+   * @param text every piece of text that was added to the document
+   */
+  void remove(uint64_t doc, const std::string& text);
+  /**
+   * Finds the best matching documents for a query. Documents are visited in
+   * id order and terms whose best possible score cannot lift a document
+   * into the current top k are only probed for documents that could still
+   * make it (MaxScore pruning).
+   * @param query the search text
+   * @param k most results returned
+   * @return document ids and scores, best first
+   */
+  std::vector<std::pair<uint64_t, double>> search(const std::string& query,
+                                                  size_t k);
+
+  /**
+   * Gets the number of indexed documents
+   * @return number of documents
+   */
+  size_t documents();
+  /**
+   * Gets the approximate memory held by the index
+   * @return bytes used by postings, terms and document lengths
+   */
+  size_t bytes();
+  /**
+   * Removes every document
+   */
+  void clear();
+
+  /**
+   * Writes the index to a file
+   * @param path file to write
+   * @param docs maps each document id to the id it is saved under
+   * @param stamp value checked on load to tell whether the file is current
+   */
+  void save(const std::string& path,
+            const std::unordered_map<uint64_t, uint64_t>& docs,
+            const std::string& stamp);
+  /**
+   * Replaces the index with one written by save
+   * @param path file to read
+   * @param stamp value the file must have been saved with
+   * @return false if the file is missing, corrupt or has another stamp
+   */
+  bool load(const std::string& path, const std::string& stamp);
+
+ private:
+  /**
+   * A document and the number of times the term occurs in it
+   */
+  struct Posting {
+    uint64_t doc;
+    uint32_t tf;
+  };
+  /**
+   * Postings of a term, sorted by document id. Documents that are not the
+   * newest (comments on older issues) go to a small sorted side list first,
+   * which is merged in once it grows, instead of shifting the whole list on
+   * every insert.
+   */
+  struct Term {
+    std::vector<Posting> postings;
+    std::vector<Posting> pending;
+    /**
+     * Largest tf in the postings. Removals leave it as is, which keeps it
+     * a valid (if looser) bound for pruning.
+     */
+    uint32_t maxTf;
+  };
+  /**
+   * Adds to or subtracts from the tf of a term in a document
+   * @param term the term
+   * @param doc document id
+   * @param delta change in tf
+   */
+  void update(const std::string& term, uint64_t doc, int64_t delta);
+  /**
+   * Merges the side list of a term into its postings
+   * @param entry the term
+   */
+  static void merge(Term* entry);
+
+  /**
+   * Postings by term
+   */
+  std::unordered_map<std::string, Term> terms;
+  /**
+   * Number of terms in each document
+   */
+  std::unordered_map<uint64_t, uint32_t> lengths;
+  /**
+   * Sum of all document lengths
+   */
+  uint64_t totalLength;
+};
+#endif /* NOLINT */
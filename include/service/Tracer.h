@@ -0,0 +1,123 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef TRACER_H /* NOLINT */
+#define TRACER_H /* NOLINT */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Traces where the time of sampled requests goes. A thread starts each
+ * request with beginRequest, which samples one request in every N; while a
+ * sampled request is current, TraceSpan objects record the phases it goes
+ * through into the thread's own ring buffer, which keeps the latest
+ * RING_SIZE spans. Spans outside a sampled request cost one thread-local
+ * check, so tracing can stay on. dump returns every ring as Chrome
+ * trace-event JSON, which chrome://tracing and Perfetto open directly.
+ *
+ * With phase timing on, every request, sampled or not, also adds up the
+ * time of each phase, so a request found to be slow once it ends can
+ * still say where its time went.
+ */
+class Tracer {
+ public:
+  /**
+   * Spans each thread keeps
+   */
+  static const size_t RING_SIZE = 4096;
+
+  /**
+   * Sets how many requests are traced
+   * @param every trace one request in this many, 0 to trace none
+   */
+  static void setSampling(uint32_t every);
+  /**
+   * Gets how many requests are traced
+   * @return one request in this many is traced, 0 if none
+   */
+  static uint32_t getSampling();
+  /**
+   * Turns timing the phases of every request on or off
+   * @param on whether spans are timed outside sampled requests too
+   */
+  static void setPhaseTiming(bool on);
+
+  /**
+   * Starts a request on the calling thread, sampled or not
+   * @return id of the request if it is traced, 0 if not
+   */
+  static uint64_t beginRequest();
+  /**
+   * Makes a request current on the calling thread again, e.g. in a
+   * callback that continues it, with no phases timed yet
+   * @param request id from beginRequest, 0 for an untraced request
+   */
+  static void resumeRequest(uint64_t request);
+  /**
+   * Ends the calling thread's current request
+   */
+  static void endRequest();
+  /**
+   * Checks whether the calling thread is in a traced or timed request
+   * @return true if spans are being recorded or timed
+   */
+  static bool active();
+  /**
+   * Gets the time of each phase of the calling thread's current request,
+   * if phase timing is on. Nested phases are counted in their own entry
+   * and in the one around them.
+   * @return phase names, in order first seen, with total nanoseconds
+   */
+  static const std::vector<std::pair<const char*, uint64_t>>& phases();
+
+  /**
+   * Gets the time spans are measured in
+   * @return nanoseconds on the steady clock, never 0
+   */
+  static uint64_t now();
+  /**
+   * Records a span of the current request if it is traced, and adds it
+   * to the request's phase times if they are timed
+   * @param name what was done; must outlive the tracer, e.g. a literal
+   * @param start when it started, from now()
+   * @param end when it ended, from now()
+   */
+  static void record(const char* name, uint64_t start, uint64_t end);
+
+  /**
+   * Formats every recorded span
+   * @return Chrome trace-event JSON
+   */
+  static std::string dump();
+  /**
+   * Forgets every recorded span
+   */
+  static void clear();
+};
+
+/**
+ * Records the time from its construction to the end of its scope as a span
+ * of the current request, if it is traced or timed
+ */
+class TraceSpan {
+ public:
+  /**
+   * @param name what the scope does; must outlive the tracer
+   */
+  explicit TraceSpan(const char* name)
+      : name(name), start(Tracer::active() ? Tracer::now() : 0) {}
+  ~TraceSpan() {
+    if (start != 0) Tracer::record(name, start, Tracer::now());
+  }
+
+ private:
+  const char* name;
+  uint64_t start;
+};
+#endif /* NOLINT */
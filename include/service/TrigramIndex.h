@@ -0,0 +1,123 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef TRIGRAMINDEX_H /* NOLINT */
+#define TRIGRAMINDEX_H /* NOLINT */
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Index of the three-letter fragments of a set of strings (issue titles or
+ * usernames), for finding them by a remembered piece instead of an exact
+ * match. Matching is case-insensitive.
+ */
+class TrigramIndex {
+ public:
+  TrigramIndex() {}
+  ~TrigramIndex() {}
+
+  /**
+   * Adds a string
+   * @param key the string
+   */
+  void add(const std::string& key);
+  /**
+   * Removes a string
+   * @param key the string
+   */
+  void remove(const std::string& key);
+  /**
+   * Finds the strings containing a fragment. Candidates come from
+   * intersecting the posting lists of the fragment's trigrams and are then
+   * checked directly.
+   * @param fragment the piece to look for
+   * @param limit most strings returned
+   * @return matching strings in index order
+   */
+  std::vector<std::string> substring(const std::string& fragment,
+                                     size_t limit);
+  /**
+   * Finds the strings containing a fragment with at most a few typos
+   * (insertions, deletions or substitutions). Strings sharing too few
+   * trigrams with the fragment are never compared.
+   * @param fragment the piece to look for
+   * @param maxEdits most typos allowed
+   * @param limit most strings returned
+   * @return matching strings, fewest typos first
+   */
+  std::vector<std::string> fuzzy(const std::string& fragment, int maxEdits,
+                                 size_t limit);
+  /**
+   * Gets the fewest edits turning a fragment into some substring of a text
+   * @param fragment the piece to look for
+   * @param text the text to look in
+   * @param bound distances above this are not computed exactly
+   * @return the edit distance (0 if fragment occurs in text), or bound + 1
+   * if it is larger than bound
+   */
+  static int substringDistance(const std::string& fragment,
+                               const std::string& text,
+                               int bound = INT_MAX - 1);
+  /**
+   * Gets the number of indexed strings
+   * @return number of strings
+   */
+  size_t size();
+  /**
+   * Gets the approximate memory held by the index
+   * @return bytes used by strings and posting lists
+   */
+  size_t bytes();
+  /**
+   * Removes every string
+   */
+  void clear();
+
+ private:
+  /**
+   * Gets the distinct trigrams of a lowercased string
+   * @param text lowercased string
+   * @return packed trigrams, sorted
+   */
+  static std::vector<uint32_t> grams(const std::string& text);
+  /**
+   * Lowercases a string
+   * @param text the string
+   * @return lowercased copy
+   */
+  static std::string lower(const std::string& text);
+  /**
+   * Checks whether an id holds a string rather than a free slot
+   * @param id internal id
+   * @return true if the string at id is indexed
+   */
+  bool live(uint32_t id);
+
+  /**
+   * Internal id of each string
+   */
+  std::unordered_map<std::string, uint32_t> ids;
+  /**
+   * Lowercased strings by id, "" for free ids
+   */
+  std::vector<std::string> folded;
+  /**
+   * Original strings by id
+   */
+  std::vector<std::string> keys;
+  /**
+   * Ids of removed strings, reused by later adds
+   */
+  std::vector<uint32_t> freeIds;
+  /**
+   * Sorted ids of the strings containing each trigram
+   */
+  std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+};
+#endif /* NOLINT */
@@ -6,6 +6,7 @@
 #ifndef USER_H /* NOLINT */
 #define USER_H /* NOLINT */
 
+#include <cstddef>
 #include <string>
 
 class User {
@@ -23,6 +24,11 @@ class User {
    * @return username of user as string name
    */
   std::string getName();
+  /**
+   * Gets the approximate memory held by a user
+   * @return bytes used by the user and its name
+   */
+  size_t bytes();
 
  private:
   /**
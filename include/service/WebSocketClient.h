@@ -0,0 +1,78 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef WEBSOCKETCLIENT_H /* NOLINT */
+#define WEBSOCKETCLIENT_H /* NOLINT */
+
+#include <string>
+
+/**
+ * Minimal blocking WebSocket client used by issueClient for its persistent
+ * connection to issueServer
+ */
+class WebSocketClient {
+ public:
+  WebSocketClient();
+  ~WebSocketClient();
+
+  /**
+   * Opens a TCP connection and performs the WebSocket handshake
+   * @param host server host name
+   * @param port server port
+   * @param path resource path to upgrade
+   * @return true if the server accepted the upgrade
+   */
+  bool connect(const std::string& host, int port, const std::string& path);
+  /**
+   * Checks whether the connection is open
+   * @return true if open
+   */
+  bool isOpen();
+  /**
+   * Sends a binary message
+   * @param payload the message
+   * @return false if the connection failed
+   */
+  bool send(const std::string& payload);
+  /**
+   * Receives the next data message, answering pings along the way
+   * @param payload set to the message
+   * @param timeoutMs milliseconds to wait, negative to block
+   * @return false on timeout or if the connection closed
+   */
+  bool receive(std::string* payload, int timeoutMs);
+  /**
+   * Sends a close frame and closes the connection
+   */
+  void close();
+
+ private:
+  /**
+   * Socket file descriptor, -1 when closed
+   */
+  int fd;
+  /**
+   * Bytes received but not yet decoded
+   */
+  std::string buffer;
+  /**
+   * Fragments of a message that has not been completed yet
+   */
+  std::string partial;
+
+  /**
+   * Writes all bytes to the socket
+   * @param data the bytes
+   * @return false if the connection failed
+   */
+  bool writeAll(const std::string& data);
+  /**
+   * Waits for and appends more bytes to buffer
+   * @param timeoutMs milliseconds to wait, negative to block
+   * @return false on timeout or if the connection closed
+   */
+  bool fill(int timeoutMs);
+};
+#endif /* NOLINT */
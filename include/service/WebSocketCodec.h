@@ -0,0 +1,68 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef WEBSOCKETCODEC_H /* NOLINT */
+#define WEBSOCKETCODEC_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+
+/**
+ * RFC 6455 helpers shared by the server handshake and the client transport
+ */
+class WebSocketCodec {
+ public:
+  /**
+   * WebSocket frame opcodes
+   */
+  enum OPCODE {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+  };
+
+  /**
+   * Computes the SHA-1 digest of a string
+   * @param data the bytes to hash
+   * @return the 20 byte raw digest
+   */
+  static std::string sha1(const std::string& data);
+  /**
+   * Encodes bytes as base64
+   * @param data the bytes to encode
+   * @return the base64 text
+   */
+  static std::string base64(const std::string& data);
+  /**
+   * Computes the Sec-WebSocket-Accept value for a Sec-WebSocket-Key
+   * @param key the client's Sec-WebSocket-Key header
+   * @return the value the server must answer with
+   */
+  static std::string acceptKey(const std::string& key);
+
+  /**
+   * Encodes a single unfragmented frame
+   * @param opcode frame opcode
+   * @param payload frame payload
+   * @param mask true for client to server frames, which must be masked
+   * @return the frame bytes
+   */
+  static std::string encode(int opcode, const std::string& payload,
+                            bool mask);
+  /**
+   * Decodes one frame from the front of a buffer and removes it
+   * @param buffer bytes received so far
+   * @param fin set to true if this is the final fragment of a message
+   * @param opcode set to the frame opcode
+   * @param payload set to the unmasked payload
+   * @return false if the buffer does not yet hold a complete frame
+   */
+  static bool decode(std::string* buffer, bool* fin, int* opcode,
+                     std::string* payload);
+};
+#endif /* NOLINT */
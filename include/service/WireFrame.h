@@ -0,0 +1,75 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#ifndef WIREFRAME_H /* NOLINT */
+#define WIREFRAME_H /* NOLINT */
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Compact framing for the issueClient/issueServer WebSocket channel.
+ * A frame is one kind byte, a varint id and the raw payload:
+ *   GET_REQUEST   id = request id, payload = "key~value~key~value", with
+ *                 any "%" or "~" in a key or value percent-encoded
+ *   POST_REQUEST  id = request id, payload = the "~"-delimited POST body
+ *   RESPONSE      id = request id, payload = the raw result string
+ *   FAILURE       id = request id, payload = error message
+ *   EVENT         id = version the delta starts from, payload = delta
+ *   HELLO         id = current version, payload = server epoch
+ */
+class WireFrame {
+ public:
+  /**
+   * Frame kinds
+   */
+  enum KIND {
+    GET_REQUEST = 1,
+    POST_REQUEST = 2,
+    RESPONSE = 3,
+    FAILURE = 4,
+    EVENT = 5,
+    HELLO = 6
+  };
+
+  /**
+   * Encodes a frame
+   * @param kind frame kind
+   * @param id request id or version, depending on kind
+   * @param payload frame payload
+   * @return the encoded frame
+   */
+  static std::string encode(int kind, uint64_t id, const std::string& payload);
+  /**
+   * Decodes a frame
+   * @param frame the encoded frame
+   * @param kind set to the frame kind
+   * @param id set to the request id or version
+   * @param payload set to the frame payload
+   * @return false if the frame is malformed
+   */
+  static bool decode(const std::string& frame, int* kind, uint64_t* id,
+                     std::string* payload);
+
+  /**
+   * Joins query parameters into a GET_REQUEST payload
+   * @param params the parameters, in order
+   * @return "key~value" pairs joined by "~", with "%" and "~" escaped
+   */
+  static std::string encodeParams(
+      const std::vector<std::pair<std::string, std::string>>& params);
+  /**
+   * Splits a GET_REQUEST payload back into query parameters
+   * @param payload the payload
+   * @param params set to the parameters, in order
+   * @return false if a key has no value or an escape is malformed
+   */
+  static bool decodeParams(
+      const std::string& payload,
+      std::vector<std::pair<std::string, std::string>>* params);
+};
+#endif /* NOLINT */
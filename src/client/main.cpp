@@ -9,12 +9,18 @@
 #include <cstdlib>
 #include <future>  // NOLINT
 #include <iostream>
+#include <map>
 #include <memory>
 #include <nlohmann/json.hpp>  // NOLINT
 #include <restbed>            // NOLINT
 #include <string>             // NOLINT
+#include <utility>            // NOLINT
+#include <vector>             // NOLINT
 
+#include "Compression.h"
 #include "IssueTrackerUI.h"
+#include "WebSocketClient.h"
+#include "WireFrame.h"
 
 /* Service information */
 const char* HOST = "localhost";
@@ -33,12 +39,77 @@ const char* GET_USER = "getUser";
 const char* LIST_ALL_USERS = "listAllUsers";
 const char* REMOVE_USER = "removeUser";
 
+const char* GET_CHANGES = "getChanges";
+const char* QUERY_ISSUES = "queryIssues";
+const char* SEARCH_ISSUES = "searchIssues";
+const char* FIND_ISSUES = "findIssues";
+const char* COMPLETE_ISSUES = "completeIssues";
+const char* COMPLETE_USERS = "completeUsers";
+const char* COMPLETION_LIMIT = "10";  // Most completions offered at once
+
 const char* ISSUE = "issueType";
 const char* USER = "userType";
 const char* COMMENT = "commentType";
 
 IssueTrackerUI ui;
 
+/**
+ * Decoded result of a previous GET, reused when the server answers 304
+ */
+struct cached_get {
+  std::string etag;
+  std::string result;
+};
+
+/**
+ * Previous GET results keyed by their query parameters
+ */
+std::map<std::string, cached_get> getCache;
+
+/**
+ * Builds the cache key of a GET request from its query parameters
+ * @param request the GET request
+ * @return key identifying the requested resource
+ */
+std::string get_cache_key(
+    const std::shared_ptr<const restbed::Request>& request) {
+  std::string key;
+  for (const auto& param : request->get_query_parameters()) {
+    key += param.first + "=" + param.second + "&";
+  }
+  return key;
+}
+
+/**
+ * Attaches If-None-Match to a GET request if an earlier result is cached
+ * @param request the GET request
+ */
+void set_cache_validator(const std::shared_ptr<restbed::Request>& request) {
+  auto cached = getCache.find(get_cache_key(request));
+  if (cached != getCache.end()) {
+    request->set_header("If-None-Match", cached->second.etag);
+  }
+}
+
+/**
+ * Reads the body of a successful response, decompressing it if needed
+ * @param response The response object from the server.
+ * @return the response body as sent before compression
+ */
+std::string read_body(const std::shared_ptr<restbed::Response>& response) {
+  auto length = response->get_header("Content-Length", 0);
+  restbed::Http::fetch(length, response);
+  std::string body(reinterpret_cast<char*>(response->get_body().data()),
+                   length);
+  std::string encoding = response->get_header("Content-Encoding", "");
+  std::string inflated;
+  if (encoding == "gzip" &&
+      Compression::gunzip(body, &inflated)) {
+    return inflated;
+  }
+  return body;
+}
+
 /**
  * Handle the response from the service.
  * @param response The response object from the server.
@@ -51,13 +122,26 @@ void handle_response(std::shared_ptr<restbed::Response> response,
 
   switch (status_code) {
     case 200: {
-      restbed::Http::fetch(length, response);
-      std::string responseStr(
-          reinterpret_cast<char*>(response->get_body().data()), length);
+      std::string responseStr = read_body(response);
 
       nlohmann::json resultJSON = nlohmann::json::parse(responseStr);
       result = resultJSON["result"];
       ui.parseMessage(result);  // Parses result and splits data into vectors
+
+      // Remember versioned GET results for later conditional requests
+      std::string etag = response->get_header("ETag", "");
+      if (!etag.empty() && response->get_request()->get_method() == "GET") {
+        cached_get& entry = getCache[get_cache_key(response->get_request())];
+        entry.etag = etag;
+        entry.result = result;
+      }
+      break;
+    }
+    case 304: {  // Our copy is current, reuse the previously decoded result
+      auto cached = getCache.find(get_cache_key(response->get_request()));
+      if (cached != getCache.end()) {
+        ui.parseMessage(cached->second.result);
+      }
       break;
     }
     case 400: {
@@ -75,12 +159,14 @@ void handle_response(std::shared_ptr<restbed::Response> response,
 }
 
 /**
- * Creates GET request with single parameter stating the request operation
+ * Creates GET request with the request operation and any other parameters
  * @param operation The type of operation being sent to the server
- * @return The request with the URI string and query parameter attached
+ * @param params Other query parameters by name (title, user, after, ...)
+ * @return The request with the URI string and query parameters attached
  */
 std::shared_ptr<restbed::Request> create_get_request(
-    const std::string& operation) {
+    const std::string& operation,
+    const std::map<std::string, std::string>& params) {
   // Create the URI string
   std::string uri_str;
   uri_str.append("http://");
@@ -92,13 +178,28 @@ std::shared_ptr<restbed::Request> create_get_request(
   // Configure request headers
   auto request = std::make_shared<restbed::Request>(restbed::Uri(uri_str));
   request->set_method("GET");
+  request->set_header("Accept-Encoding", "gzip");
 
   // Set the parameters
   request->set_query_parameter("op", operation);
+  for (const auto& param : params) {
+    request->set_query_parameter(param.first, param.second);
+  }
+  set_cache_validator(request);  // Only once every parameter is set
 
   return request;
 }
 
+/**
+ * Creates GET request with single parameter stating the request operation
+ * @param operation The type of operation being sent to the server
+ * @return The request with the URI string and query parameter attached
+ */
+std::shared_ptr<restbed::Request> create_get_request(
+    const std::string& operation) {
+  return create_get_request(operation, std::map<std::string, std::string>());
+}
+
 /**
  * Creates GET request with three parameters stating the request operation
  * @param operation The type of operation being sent to the server
@@ -110,23 +211,248 @@ std::shared_ptr<restbed::Request> create_get_request(
 std::shared_ptr<restbed::Request> create_get_request(
     const std::string& operation, const std::string& text,
     const std::string& param) {
-  // Create the URI string
-  std::string uri_str;
-  uri_str.append("http://");
-  uri_str.append(HOST);
-  uri_str.append(":");
-  uri_str.append(std::to_string(PORT));
-  uri_str.append("/issueServer");
+  return create_get_request(operation, {{param, text}});
+}
 
-  // Configure request headers
-  auto request = std::make_shared<restbed::Request>(restbed::Uri(uri_str));
-  request->set_method("GET");
+/**
+ * Persistent connection to the server, used instead of HTTP when available
+ */
+WebSocketClient socket;
+/**
+ * Server epoch announced when the socket connected
+ */
+std::string socketEpoch;
+/**
+ * Id of the last request sent over the socket
+ */
+uint64_t lastRequestId = 0;
 
-  // Set the parameters
-  request->set_query_parameter("op", operation);
-  request->set_query_parameter(param, text);
+/**
+ * Local copy of the issue titles, kept current through the change feed
+ */
+std::vector<std::string> syncedTitles;
+/**
+ * Server version (and server run) the local titles correspond to
+ */
+std::string syncedVersion = "0";
+std::string syncedEpoch;
+/**
+ * True while pushed events have kept the local titles current
+ */
+bool titlesCurrent = false;
 
-  return request;
+/**
+ * Applies a change feed result to the local issue titles
+ * @param feed "(DELTA)"/"(SNAPSHOT)" ^] version ^] ... from the server
+ * @param base version the feed starts from (ignored for snapshots)
+ * @param epoch server run the feed came from
+ * @return false if a delta does not start at the local version
+ */
+bool apply_feed(const std::string& feed, const std::string& base,
+                const std::string& epoch) {
+  // Splits the feed into fields
+  std::vector<std::string> fields;
+  std::string delim = "^]";
+  size_t start = 0;
+  size_t pos;
+  while ((pos = feed.find(delim, start)) != std::string::npos) {
+    fields.push_back(feed.substr(start, pos - start));
+    start = pos + delim.length();
+  }
+  if (fields.size() < 2) return false;
+
+  if (fields[0] == "(SNAPSHOT)") {  // Too far behind, replace everything
+    syncedTitles.assign(fields.begin() + 2, fields.end());
+  } else if (epoch != syncedEpoch || base != syncedVersion) {
+    return false;  // Missed changes in between
+  } else {  // Apply kind/key pairs in commit order
+    for (int i = 2; i + 1 < fields.size(); i += 2) {
+      if (fields[i] == "addIssue") {
+        syncedTitles.push_back(fields[i + 1]);
+      } else if (fields[i] == "deleteIssue") {
+        for (int j = 0; j < syncedTitles.size(); j++) {
+          if (syncedTitles[j] == fields[i + 1]) {
+            syncedTitles.erase(syncedTitles.begin() + j);
+            break;
+          }
+        }
+      }
+    }
+  }
+  syncedVersion = fields[1];
+  syncedEpoch = epoch;
+  return true;
+}
+
+/**
+ * Handles a frame pushed by the server outside of a request
+ * @param frame the encoded WireFrame
+ */
+void handle_socket_frame(const std::string& frame) {
+  int kind;
+  uint64_t id;
+  std::string payload;
+  if (!WireFrame::decode(frame, &kind, &id, &payload)) return;
+  if (kind == WireFrame::EVENT &&
+      !apply_feed(payload, std::to_string(id), socketEpoch)) {
+    titlesCurrent = false;  // Next sync asks for the missing changes
+  }
+}
+
+/**
+ * Opens the WebSocket channel if the server offers it and reads its greeting
+ */
+void connect_socket() {
+  if (!socket.connect(HOST, PORT, "/issueSocket")) return;  // HTTP only
+  std::string frame;
+  int kind;
+  uint64_t id;
+  std::string payload;
+  if (!socket.receive(&frame, 2000) ||
+      !WireFrame::decode(frame, &kind, &id, &payload) ||
+      kind != WireFrame::HELLO) {
+    socket.close();
+    return;
+  }
+  socketEpoch = payload;
+}
+
+/**
+ * Sends a request over the WebSocket and waits for its answer, applying
+ * any events pushed in the meantime
+ * @param request The request, converted to a WireFrame
+ * @param result Set to the raw result of the operation
+ * @return 200 on success, 400 if the server rejected the request or 0 if the
+ * connection dropped
+ */
+int socket_request(const std::shared_ptr<restbed::Request>& request,
+                   std::string* result) {
+  uint64_t id = ++lastRequestId;
+  std::string payload;
+  int kind;
+  if (request->get_method() == "GET") {  // Query parameters as key~value
+    kind = WireFrame::GET_REQUEST;
+    const auto query = request->get_query_parameters();
+    payload = WireFrame::encodeParams(
+        std::vector<std::pair<std::string, std::string>>(query.begin(),
+                                                         query.end()));
+  } else {  // POST bodies are sent as is, minus the "/" terminator
+    kind = WireFrame::POST_REQUEST;
+    restbed::Bytes body = request->get_body();
+    payload.assign(body.begin(), body.end());
+    if (!payload.empty() && payload[payload.size() - 1] == '/') {
+      payload.erase(payload.size() - 1);
+    }
+  }
+  if (!socket.send(WireFrame::encode(kind, id, payload))) {
+    titlesCurrent = false;
+    return 0;
+  }
+
+  std::string frame;
+  while (socket.receive(&frame, -1)) {
+    uint64_t answerId;
+    if (!WireFrame::decode(frame, &kind, &answerId, &payload)) continue;
+    if (kind == WireFrame::RESPONSE && answerId == id) {
+      *result = payload;
+      return 200;
+    } else if (kind == WireFrame::FAILURE && answerId == id) {
+      fprintf(stderr, "Something went wrong on our end: %s\n",
+              payload.c_str());
+      return 400;
+    }
+    handle_socket_frame(frame);
+  }
+  titlesCurrent = false;
+  return 0;
+}
+
+/**
+ * Sends a request over the WebSocket when connected, otherwise over HTTP,
+ * and parses the result into the UI
+ * @param request The request being sent
+ * @param result Result of the request converted to a string
+ */
+void send_request(const std::shared_ptr<restbed::Request>& request,
+                  std::string& result) {
+  if (socket.isOpen()) {
+    int status = socket_request(request, &result);
+    if (status == 200) {
+      ui.parseMessage(result);  // Parses result and splits data into vectors
+      return;
+    } else if (status == 400 || request->get_method() != "GET") {
+      return;  // Never replay a POST that may already have been applied
+    }
+  }
+  auto response = restbed::Http::sync(request);
+  handle_response(response, result);
+}
+
+/**
+ * Fetches a change feed result over HTTP
+ * @param request The getChanges request
+ * @param feed Set to the change feed result
+ * @param epoch Set to the server run the feed came from
+ * @return false if the request failed
+ */
+bool http_changes(const std::shared_ptr<restbed::Request>& request,
+                  std::string* feed, std::string* epoch) {
+  auto response = restbed::Http::sync(request);
+  if (response->get_status_code() != 200) {
+    fprintf(stderr,
+            "An error occurred with the service. (Is the service running?)\n");
+    return false;
+  }
+  nlohmann::json resultJSON = nlohmann::json::parse(read_body(response));
+  *feed = resultJSON["result"].get<std::string>();
+  *epoch = resultJSON["epoch"].get<std::string>();
+  return true;
+}
+
+/**
+ * Asks for the first letters of the assignee until some usernames complete
+ * them, leaving the completions in the UI for selectAssignee
+ */
+void complete_assignee() {
+  std::string result;
+  do {
+    std::string prefix = ui.enterAssigneePrefix();
+    ui.issueData.clear();  // Nothing is parsed if the request fails
+    send_request(create_get_request(COMPLETE_USERS, {{"q", prefix},
+                                    {"limit", COMPLETION_LIMIT}}),
+                 result);
+    if (ui.issueData.empty()) std::cout << "No matching users." << std::endl;
+  } while (ui.issueData.empty());
+}
+
+/**
+ * Brings the local issue titles up to date and hands them to the UI. With a
+ * socket, pushed events usually make this free; otherwise only the titles
+ * that changed since the last sync are fetched.
+ */
+void sync_titles() {
+  if (socket.isOpen()) {  // Applies events that arrived while idle
+    std::string frame;
+    while (socket.receive(&frame, 0)) handle_socket_frame(frame);
+  }
+
+  if (!socket.isOpen() || !titlesCurrent) {
+    std::shared_ptr<restbed::Request> request =
+        create_get_request(GET_CHANGES);
+    request->set_query_parameter("since", syncedVersion);
+    request->set_query_parameter("epoch", syncedEpoch);
+    std::string feed;
+    std::string epoch = socketEpoch;
+    if (!(socket.isOpen() && socket_request(request, &feed) == 200) &&
+        !http_changes(request, &feed, &epoch)) {
+      return;
+    }
+    titlesCurrent = apply_feed(feed, syncedVersion, epoch);
+  }
+
+  // Mirrors getAllIssues, which reports "(BLANK)" when no issues exist
+  ui.titleData = syncedTitles;
+  if (ui.titleData.empty()) ui.titleData.push_back("(BLANK)");
 }
 
 /**
@@ -159,23 +485,16 @@ std::shared_ptr<restbed::Request> create_post_request(
   // Create the message
   std::string message;
   if (operation == "addIssue") {  // Creates new issue
-    /**
-     * Sends GET request to retrieve all existing users in order to assign
-     * them to issue
-     */
-    std::string result;
-    std::shared_ptr<restbed::Request> req = create_get_request(LIST_ALL_USERS);
-    auto response = restbed::Http::sync(req);
-    handle_response(response, result);
-
     /**
      * Sends GET request to retrieve all existing issues by title
      * for title match checking (titles must be unique)
      */
-    req = create_get_request(GET_ALL_ISSUES);
-    response = restbed::Http::sync(req);
-    handle_response(response, result);
-    ui.enterIssueFields(title, desc, os, issueType, username, assign);
+    sync_titles();
+    ui.enterIssueFields(title, desc, os, issueType, username);
+
+    // User assigns issue to an active user (can be themself)
+    complete_assignee();
+    assign = ui.issueData[ui.selectAssignee()];
 
     message.append(type);  // Request type (ISSUE/USER/COMMENT)
     message.append("~");   // Delimiter to parse message when sent to server
@@ -284,8 +603,7 @@ void login() {
       // Sends GET request to check if username exists in server
       std::shared_ptr<restbed::Request> request =
           create_get_request(GET_USER, username, "user");
-      auto response = restbed::Http::sync(request);
-      handle_response(response, result);
+      send_request(request, result);
       if (ui.issueData[0] != "(BLANK)") {   // Username found in system
         printf("\e[1;1H\e[2J");             // "Clear" the screen
         ui.setActiveUser(ui.issueData[0]);  // Sets the logged in username
@@ -301,8 +619,7 @@ void login() {
       // Creates POST request to add new username to server
       std::shared_ptr<restbed::Request> request =
           create_post_request(USER, CREATE_USER);
-      auto response = restbed::Http::sync(request);
-      handle_response(response, result);
+      send_request(request, result);
       printf("\e[1;1H\e[2J");              // "Clear" the screen
       if (ui.issueData[0] == "(TAKEN)") {  // Username is already taken
         std::cout << "\nThat username is in use, please choose another."
@@ -328,7 +645,8 @@ void login() {
 int main() {
   int menuChoice = -1;
   std::string result;
-  login();  // Displays login screen
+  connect_socket();  // Uses the persistent channel if the server offers it
+  login();           // Displays login screen
 
   while (menuChoice != 99) {  // Returns to main menu after operations are done
     ui.displayMainMenu();     // Displays main menu
@@ -338,70 +656,101 @@ int main() {
         // Sends POST request to create new issue
         std::shared_ptr<restbed::Request> request =
             create_post_request(ISSUE, ADD_ISSUE);
-        auto response = restbed::Http::sync(request);
-        handle_response(response, result);
+        send_request(request, result);
         break;
       }
       case 1: {  // Retrieve an Issue
-        // Sends GET request to retrieve all issue titles
-        std::shared_ptr<restbed::Request> request =
-            create_get_request(GET_ALL_ISSUES);
-        auto response = restbed::Http::sync(request);
-        handle_response(response, result);  // Issue titles are parsed
+        std::shared_ptr<restbed::Request> request;
+        std::string fragment = ui.enterTitleFragment();
+        if (fragment.empty()) {
+          // Brings the issue titles up to date through the change feed
+          sync_titles();
+        } else {
+          // Titles starting with the fragment are offered first
+          request = create_get_request(COMPLETE_ISSUES, {{"q", fragment},
+                                       {"limit", COMPLETION_LIMIT}});
+          send_request(request, result);
+          if (ui.titleData.empty() || ui.titleData[0] == "(BLANK)") {
+            // Otherwise titles close to it anywhere (one typo allowed)
+            request = create_get_request(FIND_ISSUES,
+                                         {{"q", fragment}, {"typos", "1"}});
+            send_request(request, result);
+          }
+        }
 
         // Prompts user to pick an issue based off its title
         std::string issueChoice = ui.pickIssueToDisplay();
 
         if (issueChoice != "(BLANK)") {  // If issue exists in server
           std::string comment;
+          std::string after;  // Cursor of the page of comments shown
 
           // Allows users to continuously add comments without returning to menu
           while (comment != "(NoComment)") {
-            // Sends GET request to display an entire issue from its title
-            request = create_get_request(GET_ISSUE, issueChoice, "title");
-            response = restbed::Http::sync(request);
-            handle_response(response, result);  // All issue data parsed
+            // Sends GET request to display an issue and a page of comments
+            std::map<std::string, std::string> params = {
+                {"title", issueChoice}};
+            if (!after.empty()) params["after"] = after;
+            request = create_get_request(GET_ISSUE, params);
+            send_request(request, result);  // All issue data parsed
 
             comment = ui.displaySingleIssue();  // Displays all issue data
-            if (comment != "(NoComment)") {     // Add a comment
+            if (comment == "(MoreComments)") {  // Next page of comments
+              after = ui.nextCursor;
+            } else if (comment != "(NoComment)") {  // Add a comment
               // Sends POST request to add a new comment to displayed issue
               request = comment_post_request(COMMENT, ADD_COMMENT, comment);
-              response = restbed::Http::sync(request);
-              handle_response(response, result);
+              send_request(request, result);
             }
           }
         }
         break;
       }
       case 2: {  // List All Issues
-        // Sends GET request to retrieve all issue titles from server
-        std::shared_ptr<restbed::Request> request =
-            create_get_request(GET_ALL_ISSUES);
-        auto response = restbed::Http::sync(request);
-        handle_response(response, result);  // Issue titles are parsed
-        ui.displayIssues();                 // Issue titles are displayed
+        sync_titles();        // Issue titles are brought up to date
+        ui.displayIssues();  // Issue titles are displayed
         break;
       }
       case 3: {  // Delete an Issue
-        // Sends GET request to retrieve all issue titles from server
-        std::shared_ptr<restbed::Request> request =
-            create_get_request(GET_ALL_ISSUES);
-        auto response = restbed::Http::sync(request);
-        handle_response(response, result);  // Issue titles are parsed
+        sync_titles();  // Issue titles are brought up to date
 
         // Sends POST request to delete selected issue
-        request = create_post_request(ISSUE, DELETE_ISSUE);
-        response = restbed::Http::sync(request);
-        handle_response(response, result);
+        std::shared_ptr<restbed::Request> request =
+            create_post_request(ISSUE, DELETE_ISSUE);
+        send_request(request, result);
         break;
       }
-      case 4: {  // List All Users
-        // Sends GET request to retrieve all existing usernames from server
+      case 8: {  // Find Issues
+        std::string os, type, user, assign;
+        ui.enterIssueFilters(os, type, user, assign);
+
+        // Sends GET request for the titles of the matching issues
+        std::shared_ptr<restbed::Request> request = create_get_request(
+            QUERY_ISSUES,
+            {{"os", os}, {"type", type}, {"user", user}, {"assign", assign}});
+        send_request(request, result);
+        ui.displayIssues();  // Matching titles are displayed
+        break;
+      }
+      case 9: {  // Search Issues
+        std::string query = ui.enterSearch();
+
+        // Sends GET request for the best matching titles, best first
         std::shared_ptr<restbed::Request> request =
-            create_get_request(LIST_ALL_USERS);
-        auto response = restbed::Http::sync(request);
-        handle_response(response, result);  // Usernames are parsed
-        ui.listAllUsers();                  // Displays all active usernames
+            create_get_request(SEARCH_ISSUES, query, "q");
+        send_request(request, result);
+        ui.displayIssues();  // Matching titles are displayed
+        break;
+      }
+      case 4: {  // List All Users
+        // Sends GET requests for pages of usernames until the user is done
+        std::string cursor;
+        do {
+          std::map<std::string, std::string> params;
+          if (!cursor.empty()) params["after"] = cursor;
+          send_request(create_get_request(LIST_ALL_USERS, params), result);
+          cursor = ui.nextCursor;
+        } while (ui.listAllUsers() && !cursor.empty());
         break;
       }
       case 5: {  // Delete a User
@@ -410,8 +759,7 @@ int main() {
           // Sends POST request to delete selected username from server
           std::shared_ptr<restbed::Request> request =
               create_post_request(USER, REMOVE_USER);
-          auto response = restbed::Http::sync(request);
-          handle_response(response, result);
+          send_request(request, result);
           printf("\e[1;1H\e[2J");  // "Clear" the screen
           login();                 // Return to login screen
         }
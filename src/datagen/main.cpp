@@ -0,0 +1,133 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "DatasetGenerator.h"
+
+/**
+ * Writes a synthetic store (context.txt, comments.txt, users.txt and
+ * labels.txt) for issueServer to load, for testing startup time and how
+ * queries scale with the data.
+ */
+
+/**
+ * Prints the usage message
+ */
+void usage() {
+  DatasetSpec d;
+  printf(
+      "Usage: issueData [--dir=DIR] [options]\n\n"
+      "  --issues=N           issues (%llu)\n"
+      "  --comments=N         comments over all issues (%llu)\n"
+      "  --users=N            users (%llu)\n"
+      "  --comment-skew=S     Zipf exponent of comments per issue (%.1f)\n"
+      "  --user-skew=S        Zipf exponent of issues and comments per user "
+      "(%.1f)\n"
+      "  --word-skew=S        Zipf exponent of word frequency (%.1f)\n"
+      "  --systems=N          distinct operating systems (%d)\n"
+      "  --types=N            distinct issue types (%d)\n"
+      "  --labels=N           distinct labels (%d)\n"
+      "  --labels-per-issue=X average labels on an issue (%.1f)\n"
+      "  --title-words=N      average words in a title (%d)\n"
+      "  --desc-words=N       average words in a description (%d)\n"
+      "  --comment-words=N    average words in a comment (%d)\n"
+      "  --vocabulary=N       distinct words (%llu)\n"
+      "  --seed=N             random seed (%llu)\n",
+      static_cast<unsigned long long>(d.issues),      // NOLINT
+      static_cast<unsigned long long>(d.comments),    // NOLINT
+      static_cast<unsigned long long>(d.users),       // NOLINT
+      d.commentSkew, d.userSkew, d.wordSkew, d.systems, d.types, d.labels,
+      d.labelsPerIssue, d.titleWords, d.descWords, d.commentWords,
+      static_cast<unsigned long long>(d.vocabulary),  // NOLINT
+      static_cast<unsigned long long>(d.seed));       // NOLINT
+}
+
+/**
+ * Reads the command line
+ * @param argc number of arguments
+ * @param argv the arguments
+ * @param spec filled with the shape of the store
+ * @param dir set to the directory to write to
+ * @return false if an argument is not understood
+ */
+bool parse_args(int argc, char** argv, DatasetSpec* spec, std::string* dir) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t equals = arg.find('=');
+    if (equals == std::string::npos) return false;
+    std::string name = arg.substr(0, equals);
+    const char* value = argv[i] + equals + 1;
+    if (name == "--dir") {
+      *dir = value;
+    } else if (name == "--issues") {
+      spec->issues = strtoull(value, NULL, 10);
+    } else if (name == "--comments") {
+      spec->comments = strtoull(value, NULL, 10);
+    } else if (name == "--users") {
+      spec->users = strtoull(value, NULL, 10);
+    } else if (name == "--comment-skew") {
+      spec->commentSkew = atof(value);
+    } else if (name == "--user-skew") {
+      spec->userSkew = atof(value);
+    } else if (name == "--word-skew") {
+      spec->wordSkew = atof(value);
+    } else if (name == "--systems") {
+      spec->systems = atoi(value);
+    } else if (name == "--types") {
+      spec->types = atoi(value);
+    } else if (name == "--labels") {
+      spec->labels = atoi(value);
+    } else if (name == "--labels-per-issue") {
+      spec->labelsPerIssue = atof(value);
+    } else if (name == "--title-words") {
+      spec->titleWords = atoi(value);
+    } else if (name == "--desc-words") {
+      spec->descWords = atoi(value);
+    } else if (name == "--comment-words") {
+      spec->commentWords = atoi(value);
+    } else if (name == "--vocabulary") {
+      spec->vocabulary = strtoull(value, NULL, 10);
+    } else if (name == "--seed") {
+      spec->seed = strtoull(value, NULL, 10);
+    } else {
+      return false;
+    }
+  }
+  return spec->users > 0 && spec->vocabulary > 0 && spec->systems > 0 &&
+         spec->types > 0 && spec->labels >= 0 && spec->commentSkew >= 0 &&
+         spec->userSkew >= 0 && spec->wordSkew >= 0 &&
+         (spec->issues > 0 || spec->comments == 0);
+}
+
+int main(int argc, char** argv) {
+  DatasetSpec spec;
+  std::string dir = ".";
+  if (!parse_args(argc, argv, &spec, &dir)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  DatasetGenerator generator(spec);
+  std::string error;
+  if (!generator.write(dir, &error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  printf("Wrote %llu issues, %llu comments and %llu users to %s: "
+         "%.1f MB in %.2f s\n",
+         static_cast<unsigned long long>(spec.issues),    // NOLINT
+         static_cast<unsigned long long>(spec.comments),  // NOLINT
+         static_cast<unsigned long long>(spec.users),     // NOLINT
+         dir.c_str(), generator.bytesWritten() / 1e6, seconds);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,790 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "RequestLog.h"
+#include "WireFrame.h"
+
+/**
+ * Drives issueServer with concurrent requests in the format the client
+ * sends ("~" separated POST bodies and ?op= GETs) and reports throughput
+ * and latency percentiles for each operation.
+ *
+ * Closed loop (the default) keeps one request in flight per worker, so
+ * throughput settles wherever the server saturates. Open loop (--rate)
+ * sends on a fixed schedule whether or not the server keeps up, and counts
+ * latency from when each request was due, so time spent queued behind a
+ * slow request is not hidden. Each worker still has one request in flight
+ * at a time, so use enough threads to sustain the rate.
+ *
+ * Replay (--replay) sends the requests issueServer recorded with
+ * --capture instead, each due at its recorded time divided by --speed
+ * (as fast as possible with --speed=max). Latency again counts from the
+ * due time. Workers take requests in recorded order but send them
+ * concurrently, so requests that arrived close together may be applied in
+ * a different order. --save writes the results and --baseline compares
+ * them with results saved from an earlier build.
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Command line settings
+ */
+struct options {
+  std::string host = "localhost";
+  int port = 1234;
+  int threads = 4;
+  double duration = 10;
+  double rate = 0;  // Requests per second over all workers, 0 = closed loop
+  int seedIssues = 100;
+  std::string mix =
+      "getIssue=35,getAllIssues=15,searchIssues=10,queryIssues=10,"
+      "getStats=5,addIssue=10,addComment=10,createUser=5";
+  std::string replay;
+  double speed = 1;  // Replay speed up, 0 = as fast as possible
+  std::string save;
+  std::string baseline;
+};
+
+/**
+ * One operation of the mix and its share of the requests
+ */
+struct weighted_op {
+  std::string name;
+  double weight;
+};
+
+/**
+ * What one worker measured for one operation
+ */
+struct op_stats {
+  LatencyHistogram micros;
+  uint64_t errors = 0;
+};
+
+/**
+ * Results of one operation as saved by --save
+ */
+struct saved_row {
+  uint64_t count;
+  uint64_t errors;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t p999;
+  uint64_t max;
+};
+
+/**
+ * Operations the generator knows how to build requests for
+ */
+const char* KNOWN_OPS[] = {
+    "getIssue",     "getAllIssues", "listAllUsers", "queryIssues",
+    "searchIssues", "findIssues",   "completeIssues", "filterIssues",
+    "getStats",     "getHotIssues", "addIssue",     "addComment",
+    "createUser"};
+
+/* Values requests pick from */
+const char* SYSTEMS[] = {"Linux", "Windows", "MacOS"};
+const char* TYPES[] = {"Bug", "Feature", "Task"};
+const char* WORDS[] = {"crash", "login", "printer", "slow",  "theme",
+                       "error", "save",  "upload",  "search", "timeout"};
+
+/**
+ * Address of the server, resolved once
+ */
+sockaddr_storage serverAddress;
+socklen_t serverAddressLength;
+/**
+ * Host header sent with every request
+ */
+std::string hostHeader;
+
+/**
+ * Tag shared by every title and username this run creates
+ */
+std::string runTag;
+
+/**
+ * Percent-encodes a query parameter value
+ * @param value the value
+ * @return the encoded value
+ */
+std::string url_encode(const std::string& value) {
+  static const char* hex = "0123456789ABCDEF";
+  std::string encoded;
+  for (size_t i = 0; i < value.size(); i++) {
+    unsigned char c = value[i];
+    if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+      encoded += c;
+    } else {
+      encoded += '%';
+      encoded += hex[c >> 4];
+      encoded += hex[c & 15];
+    }
+  }
+  return encoded;
+}
+
+/**
+ * Builds a GET request the way create_get_request does
+ * @param params query parameters, starting with op
+ * @return the HTTP request
+ */
+std::string get_request(
+    const std::vector<std::pair<std::string, std::string>>& params) {
+  std::string target = "/issueServer";
+  for (size_t i = 0; i < params.size(); i++) {
+    target += (i == 0 ? "?" : "&") + params[i].first + "=" +
+              url_encode(params[i].second);
+  }
+  return "GET " + target + " HTTP/1.1\r\nHost: " + hostHeader +
+         "\r\n" + "Accept-Encoding: gzip\r\n" + "Connection: close\r\n\r\n";
+}
+
+/**
+ * Builds a POST request from a body already joined with '~'
+ * @param body type, operation and data
+ * @return the HTTP request
+ */
+std::string post_body_request(const std::string& body) {
+  std::string message = body + "/";  // Ends message so server can parse it
+  return "POST /issueServer HTTP/1.1\r\nHost: " + hostHeader +
+         "\r\n" + "Accept: */*\r\n" + "Content-Type: text/plain\r\n" +
+         "Content-Length: " + std::to_string(message.size()) + "\r\n" +
+         "Connection: close\r\n\r\n" + message;
+}
+
+/**
+ * Builds a POST request the way create_post_request does
+ * @param fields type, operation and data, joined with '~'
+ * @return the HTTP request
+ */
+std::string post_request(const std::vector<std::string>& fields) {
+  std::string body;
+  for (size_t i = 0; i < fields.size(); i++) {
+    body += (i > 0 ? "~" : "") + fields[i];
+  }
+  return post_body_request(body);
+}
+
+/**
+ * Title of one of the issues created before the run
+ * @param n issue number
+ * @return the title
+ */
+std::string seeded_title(int n) {
+  return "Load issue " + runTag + "-" + std::to_string(n);
+}
+
+/**
+ * Builds the request for one operation with random but plausible values
+ * @param op operation name
+ * @param worker number of the worker sending it
+ * @param sent requests the worker sent so far, for unique names
+ * @param seedIssues number of issues created before the run
+ * @param random the worker's random numbers
+ * @return the HTTP request
+ */
+std::string build_request(const std::string& op, int worker, uint64_t sent,
+                          int seedIssues, std::mt19937_64* random) {
+  std::string unique =
+      runTag + "-w" + std::to_string(worker) + "-" + std::to_string(sent);
+  std::string title = seeded_title((*random)() % seedIssues);
+  std::string word = WORDS[(*random)() % 10];
+  std::string os = SYSTEMS[(*random)() % 3];
+  std::string type = TYPES[(*random)() % 3];
+
+  if (op == "getIssue") return get_request({{"op", op}, {"title", title}});
+  if (op == "queryIssues") {
+    return get_request({{"op", op}, {"os", os}, {"type", type}});
+  }
+  if (op == "searchIssues" || op == "findIssues") {
+    return get_request({{"op", op}, {"q", word}});
+  }
+  if (op == "completeIssues") {
+    return get_request({{"op", op}, {"q", "Load"}, {"limit", "10"}});
+  }
+  if (op == "filterIssues") {
+    return get_request(
+        {{"op", op}, {"q", "type:" + type + " AND NOT os:" + os}});
+  }
+  if (op == "addIssue") {
+    return post_request({"issueType", op, "Load issue " + unique,
+                         "Generated " + word + " report", os, type,
+                         "load_user", "load_user"});
+  }
+  if (op == "addComment") {
+    return post_request(
+        {"commentType", op, title, "Seen " + word + " again", "load_user"});
+  }
+  if (op == "createUser") {
+    return post_request({"userType", op, "load_" + unique});
+  }
+  return get_request({{"op", op}});  // getAllIssues, getStats, ...
+}
+
+/**
+ * Sends a request on a new connection and reads the response, which the
+ * server ends by closing the connection
+ * @param request the HTTP request
+ * @return the status code, or 0 if the connection failed
+ */
+int send_request(const std::string& request) {
+  int fd = socket(serverAddress.ss_family, SOCK_STREAM, 0);
+  if (fd < 0) return 0;
+  timeval timeout = {30, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  if (connect(fd, reinterpret_cast<sockaddr*>(&serverAddress),
+              serverAddressLength) != 0) {
+    close(fd);
+    return 0;
+  }
+  for (size_t sent = 0; sent < request.size();) {
+    ssize_t n = send(fd, request.data() + sent, request.size() - sent,
+                     MSG_NOSIGNAL);
+    if (n <= 0) {
+      close(fd);
+      return 0;
+    }
+    sent += n;
+  }
+
+  std::string response;
+  char buffer[16384];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, n);
+  }
+  close(fd);
+  // "HTTP/1.1 200 OK"
+  size_t space = response.find(' ');
+  if (space == std::string::npos) return 0;
+  return atoi(response.c_str() + space + 1);
+}
+
+/**
+ * Sends requests from one worker until the run ends
+ * @param worker number of the worker
+ * @param opts command line settings
+ * @param mix operations with cumulative weights
+ * @param start when the run started
+ * @param end when the run ends
+ * @param stats filled with the latencies of each operation
+ */
+void run_worker(int worker, const options& opts,
+                const std::vector<weighted_op>& mix, Clock::time_point start,
+                Clock::time_point end, std::vector<op_stats>* stats) {
+  std::mt19937_64 random(worker * 7919 + 1);
+  std::uniform_real_distribution<double> pick(0, mix.back().weight);
+  // Open loop: this worker's share of the rate, evenly spaced and offset
+  // so the workers do not fire together
+  Clock::duration interval = Clock::duration::zero();
+  if (opts.rate > 0) {
+    interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(opts.threads / opts.rate));
+  }
+  Clock::time_point due = start + interval * worker / opts.threads;
+
+  for (uint64_t sent = 0;; sent++) {
+    if (opts.rate > 0) {
+      if (due >= end) break;
+      std::this_thread::sleep_until(due);
+    } else {
+      due = Clock::now();
+      if (due >= end) break;
+    }
+    double roll = pick(random);
+    size_t op = 0;
+    while (op + 1 < mix.size() && mix[op].weight <= roll) op++;
+
+    std::string request =
+        build_request(mix[op].name, worker, sent, opts.seedIssues, &random);
+    int status = send_request(request);
+    Clock::time_point done = Clock::now();
+    (*stats)[op].micros.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(done - due)
+            .count());
+    if (status != 200 && status != 304) (*stats)[op].errors++;
+    due += interval;
+  }
+}
+
+/**
+ * Recorded requests ready to send
+ */
+struct replay_plan {
+  std::vector<std::string> requests;
+  /**
+   * Microseconds from the first request, at 1x speed
+   */
+  std::vector<uint64_t> micros;
+  /**
+   * Index into names of each request's operation
+   */
+  std::vector<size_t> ops;
+  std::vector<std::string> names;
+};
+
+/**
+ * Splits a POST body at every '~', keeping empty fields
+ * @param payload the body
+ * @return the fields
+ */
+std::vector<std::string> split_payload(const std::string& payload) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  for (size_t tilde; (tilde = payload.find('~', start)) != std::string::npos;
+       start = tilde + 1) {
+    fields.push_back(payload.substr(start, tilde - start));
+  }
+  fields.push_back(payload.substr(start));
+  return fields;
+}
+
+/**
+ * Turns a captured log into HTTP requests grouped by operation
+ * @param entries requests read from the log
+ * @param plan filled with the requests
+ */
+void plan_replay(const std::vector<RequestLog::Entry>& entries,
+                 replay_plan* plan) {
+  std::map<std::string, size_t> indexes;
+  for (size_t i = 0; i < entries.size(); i++) {
+    std::string op = "unknown";
+    if (entries[i].kind == WireFrame::POST_REQUEST) {
+      std::vector<std::string> fields = split_payload(entries[i].payload);
+      if (fields.size() > 1) op = fields[1];
+      plan->requests.push_back(post_body_request(entries[i].payload));
+    } else {
+      std::vector<std::pair<std::string, std::string>> captured;
+      if (!WireFrame::decodeParams(entries[i].payload, &captured)) continue;
+      std::vector<std::pair<std::string, std::string>> params;
+      for (size_t p = 0; p < captured.size(); p++) {
+        if (captured[p].first == "op") {  // Kept first, as the client sends it
+          op = captured[p].second;
+          params.insert(params.begin(), captured[p]);
+        } else {
+          params.push_back(captured[p]);
+        }
+      }
+      plan->requests.push_back(get_request(params));
+    }
+    auto found = indexes.find(op);
+    if (found == indexes.end()) {
+      found = indexes.insert({op, plan->names.size()}).first;
+      plan->names.push_back(op);
+    }
+    plan->ops.push_back(found->second);
+    plan->micros.push_back(entries[i].micros);
+  }
+}
+
+/**
+ * Sends recorded requests from one worker until none are left
+ * @param plan the requests
+ * @param speed replay speed up, 0 for as fast as possible
+ * @param start when the replay started
+ * @param next index of the next request to send, shared by the workers
+ * @param stats filled with the latencies of each operation
+ */
+void run_replay_worker(const replay_plan& plan, double speed,
+                       Clock::time_point start, std::atomic<size_t>* next,
+                       std::vector<op_stats>* stats) {
+  for (size_t i; (i = next->fetch_add(1)) < plan.requests.size();) {
+    Clock::time_point due = Clock::now();
+    if (speed > 0) {
+      due = start + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::micro>(
+                            plan.micros[i] / speed));
+      std::this_thread::sleep_until(due);
+    }
+    int status = send_request(plan.requests[i]);
+    Clock::time_point done = Clock::now();
+    op_stats& op = (*stats)[plan.ops[i]];
+    op.micros.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(done - due)
+            .count());
+    if (status != 200 && status != 304) op.errors++;
+  }
+}
+
+/**
+ * Parses an operation mix such as "getIssue=70,addIssue=30"
+ * @param text the mix
+ * @param mix filled with the operations and cumulative weights
+ * @return false if an operation or weight is invalid
+ */
+bool parse_mix(const std::string& text, std::vector<weighted_op>* mix) {
+  std::stringstream ss(text);
+  std::string item;
+  double total = 0;
+  while (getline(ss, item, ',')) {
+    size_t equals = item.find('=');
+    std::string name = item.substr(0, equals);
+    double weight =
+        equals == std::string::npos ? 1 : atof(item.c_str() + equals + 1);
+    bool known = false;
+    for (size_t k = 0; k < sizeof(KNOWN_OPS) / sizeof(KNOWN_OPS[0]); k++) {
+      if (name == KNOWN_OPS[k]) known = true;
+    }
+    if (!known || weight <= 0) {
+      fprintf(stderr, "Invalid operation in mix: %s\n", item.c_str());
+      return false;
+    }
+    total += weight;
+    mix->push_back({name, total});
+  }
+  return !mix->empty();
+}
+
+/**
+ * Prints the usage message
+ */
+void usage() {
+  options defaults;
+  printf(
+      "Usage: issueLoad [--host=H] [--port=P] [--threads=N] "
+      "[--duration=SECONDS]\n"
+      "                 [--rate=REQUESTS_PER_SECOND] [--seed-issues=N] "
+      "[--mix=OP=WEIGHT,...]\n"
+      "       issueLoad --replay=FILE [--speed=X|max] [--host=H] [--port=P] "
+      "[--threads=N]\n"
+      "Both take [--save=FILE] [--baseline=FILE]\n\n"
+      "--rate switches from closed loop (one request in flight per thread)\n"
+      "to open loop at the given total rate.\n"
+      "--replay sends requests captured by issueServer --capture=FILE at\n"
+      "their recorded times, sped up --speed times.\n"
+      "--save writes the results to compare later runs with --baseline.\n"
+      "Default mix: %s\n"
+      "Operations:",
+      defaults.mix.c_str());
+  for (size_t k = 0; k < sizeof(KNOWN_OPS) / sizeof(KNOWN_OPS[0]); k++) {
+    printf(" %s", KNOWN_OPS[k]);
+  }
+  printf("\n");
+}
+
+/**
+ * Reads the command line
+ * @param argc number of arguments
+ * @param argv the arguments
+ * @param opts filled with the settings
+ * @return false if an argument is not understood
+ */
+bool parse_args(int argc, char** argv, options* opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t equals = arg.find('=');
+    std::string name = arg.substr(0, equals);
+    std::string value =
+        equals == std::string::npos ? "" : arg.substr(equals + 1);
+    if (name == "--host") {
+      opts->host = value;
+    } else if (name == "--port") {
+      opts->port = atoi(value.c_str());
+    } else if (name == "--threads") {
+      opts->threads = atoi(value.c_str());
+    } else if (name == "--duration") {
+      opts->duration = atof(value.c_str());
+    } else if (name == "--rate") {
+      opts->rate = atof(value.c_str());
+    } else if (name == "--seed-issues") {
+      opts->seedIssues = atoi(value.c_str());
+    } else if (name == "--mix") {
+      opts->mix = value;
+    } else if (name == "--replay") {
+      opts->replay = value;
+    } else if (name == "--speed") {
+      opts->speed = value == "max" ? 0 : atof(value.c_str());
+      if (opts->speed <= 0 && value != "max") return false;
+    } else if (name == "--save") {
+      opts->save = value;
+    } else if (name == "--baseline") {
+      opts->baseline = value;
+    } else {
+      return false;
+    }
+  }
+  return opts->threads > 0 && opts->duration > 0 && opts->seedIssues > 0 &&
+         opts->rate >= 0;
+}
+
+/**
+ * Formats microseconds as milliseconds
+ * @param micros the latency
+ * @return the latency in milliseconds, three decimals
+ */
+std::string ms(uint64_t micros) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.3f", micros / 1000.0);
+  return text;
+}
+
+/**
+ * Writes the results of a run for a later --baseline
+ * @param path the file
+ * @param rows each operation's results
+ * @return false if the file could not be written
+ */
+bool save_results(const std::string& path,
+                  const std::vector<std::pair<std::string, op_stats>>& rows) {
+  FILE* out = fopen(path.c_str(), "w");
+  if (out == NULL) return false;
+  fprintf(out, "# operation count errors p50 p90 p99 p99.9 max (us)\n");
+  for (size_t r = 0; r < rows.size(); r++) {
+    const LatencyHistogram& h = rows[r].second.micros;
+    fprintf(out, "%s %llu %llu %llu %llu %llu %llu %llu\n",
+            rows[r].first.c_str(),
+            static_cast<unsigned long long>(h.count()),               // NOLINT
+            static_cast<unsigned long long>(rows[r].second.errors),   // NOLINT
+            static_cast<unsigned long long>(h.percentile(50)),        // NOLINT
+            static_cast<unsigned long long>(h.percentile(90)),        // NOLINT
+            static_cast<unsigned long long>(h.percentile(99)),        // NOLINT
+            static_cast<unsigned long long>(h.percentile(99.9)),      // NOLINT
+            static_cast<unsigned long long>(h.max()));                // NOLINT
+  }
+  return fclose(out) == 0;
+}
+
+/**
+ * Reads results written by save_results
+ * @param path the file
+ * @param rows filled with each operation's results
+ * @return false if the file could not be read
+ */
+bool load_results(const std::string& path,
+                  std::map<std::string, saved_row>* rows) {
+  FILE* in = fopen(path.c_str(), "r");
+  if (in == NULL) return false;
+  char line[512];
+  char name[256];
+  while (fgets(line, sizeof(line), in) != NULL) {
+    unsigned long long v[7];  // NOLINT
+    if (line[0] == '#' ||
+        sscanf(line, "%255s %llu %llu %llu %llu %llu %llu %llu", name, &v[0],
+               &v[1], &v[2], &v[3], &v[4], &v[5], &v[6]) != 8) {
+      continue;
+    }
+    (*rows)[name] = {v[0], v[1], v[2], v[3], v[4], v[5], v[6]};
+  }
+  fclose(in);
+  return true;
+}
+
+/**
+ * Formats the change from a baseline latency
+ * @param before the baseline
+ * @param after this run
+ * @return the change in percent, e.g. "+12.5%"
+ */
+std::string change(uint64_t before, uint64_t after) {
+  if (before == 0) return "-";
+  char text[32];
+  snprintf(text, sizeof(text), "%+.1f%%",
+           (static_cast<double>(after) - before) * 100 / before);
+  return text;
+}
+
+/**
+ * Prints this run's latencies next to a baseline's
+ * @param rows each operation's results
+ * @param baseline results of the earlier run
+ */
+void print_comparison(
+    const std::vector<std::pair<std::string, op_stats>>& rows,
+    const std::map<std::string, saved_row>& baseline) {
+  printf("\n%-15s %9s %9s %8s %9s %9s %8s %9s %9s %8s\n", "vs baseline",
+         "p50 was", "p50 ms", "change", "p99 was", "p99 ms", "change",
+         "p99.9 was", "p99.9 ms", "change");
+  for (size_t r = 0; r < rows.size(); r++) {
+    auto found = baseline.find(rows[r].first);
+    if (found == baseline.end()) {
+      printf("%-15s not in baseline\n", rows[r].first.c_str());
+      continue;
+    }
+    const saved_row& was = found->second;
+    const LatencyHistogram& h = rows[r].second.micros;
+    printf("%-15s %9s %9s %8s %9s %9s %8s %9s %9s %8s\n",
+           rows[r].first.c_str(), ms(was.p50).c_str(),
+           ms(h.percentile(50)).c_str(),
+           change(was.p50, h.percentile(50)).c_str(), ms(was.p99).c_str(),
+           ms(h.percentile(99)).c_str(),
+           change(was.p99, h.percentile(99)).c_str(), ms(was.p999).c_str(),
+           ms(h.percentile(99.9)).c_str(),
+           change(was.p999, h.percentile(99.9)).c_str());
+  }
+}
+
+/**
+ * Prints one row of the report
+ * @param name operation name
+ * @param stats what was measured
+ * @param seconds length of the run
+ */
+void print_row(const std::string& name, const op_stats& stats,
+               double seconds) {
+  const LatencyHistogram& h = stats.micros;
+  printf("%-15s %9llu %7llu %10.1f %9s %9s %9s %9s %9s\n", name.c_str(),
+         static_cast<unsigned long long>(h.count()),    // NOLINT
+         static_cast<unsigned long long>(stats.errors),  // NOLINT
+         h.count() / seconds, ms(h.percentile(50)).c_str(),
+         ms(h.percentile(90)).c_str(), ms(h.percentile(99)).c_str(),
+         ms(h.percentile(99.9)).c_str(), ms(h.max()).c_str());
+}
+
+int main(int argc, char** argv) {
+  options opts;
+  std::vector<weighted_op> mix;
+  if (!parse_args(argc, argv, &opts) || !parse_mix(opts.mix, &mix)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  std::map<std::string, saved_row> baseline;
+  if (!opts.baseline.empty() && !load_results(opts.baseline, &baseline)) {
+    fprintf(stderr, "Cannot read %s\n", opts.baseline.c_str());
+    return EXIT_FAILURE;
+  }
+  replay_plan plan;
+  if (!opts.replay.empty()) {
+    std::vector<RequestLog::Entry> entries;
+    if (!RequestLog::read(opts.replay, &entries)) {
+      fprintf(stderr, "Cannot read request log %s\n", opts.replay.c_str());
+      return EXIT_FAILURE;
+    }
+    plan_replay(entries, &plan);
+    if (plan.requests.empty()) {
+      fprintf(stderr, "No requests in %s\n", opts.replay.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = NULL;
+  if (getaddrinfo(opts.host.c_str(), std::to_string(opts.port).c_str(), &hints,
+                  &addresses) != 0) {
+    fprintf(stderr, "Cannot resolve %s\n", opts.host.c_str());
+    return EXIT_FAILURE;
+  }
+  memcpy(&serverAddress, addresses->ai_addr, addresses->ai_addrlen);
+  serverAddressLength = addresses->ai_addrlen;
+  freeaddrinfo(addresses);
+  runTag = std::to_string(time(NULL));
+  hostHeader = opts.host + ":" + std::to_string(opts.port);
+
+  // A replay expects the server to hold what it held when capturing, so
+  // nothing is added before it
+  std::string probe = opts.replay.empty()
+                          ? post_request({"userType", "createUser",
+                                          "load_user"})
+                          : get_request({{"op", "getStats"}});
+  if (send_request(probe) == 0) {
+    fprintf(stderr, "Cannot reach issueServer at %s:%d\n", opts.host.c_str(),
+            opts.port);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> names;
+  if (!opts.replay.empty()) {
+    names = plan.names;
+    double recorded = plan.micros.back() / 1e6;
+    if (opts.speed > 0) {
+      printf("Replaying %zu requests (%.1f s recorded) with %d workers at "
+             "%gx speed\n",
+             plan.requests.size(), recorded, opts.threads, opts.speed);
+    } else {
+      printf("Replaying %zu requests (%.1f s recorded) with %d workers as "
+             "fast as possible\n",
+             plan.requests.size(), recorded, opts.threads);
+    }
+  } else {
+    for (size_t op = 0; op < mix.size(); op++) names.push_back(mix[op].name);
+    // Issues for reads and comments to hit, made before timing starts
+    printf("Creating %d issues...\n", opts.seedIssues);
+    for (int n = 0; n < opts.seedIssues; n++) {
+      send_request(post_request({"issueType", "addIssue", seeded_title(n),
+                                 "Seeded by issueLoad", SYSTEMS[n % 3],
+                                 TYPES[n / 3 % 3], "load_user", "load_user"}));
+    }
+    if (opts.rate > 0) {
+      printf("Running %d open loop workers for %.0f s at %.0f requests/s\n",
+             opts.threads, opts.duration, opts.rate);
+    } else {
+      printf("Running %d closed loop workers for %.0f s\n", opts.threads,
+             opts.duration);
+    }
+  }
+
+  std::vector<std::vector<op_stats>> stats(
+      opts.threads, std::vector<op_stats>(names.size()));
+  Clock::time_point start = Clock::now();
+  Clock::time_point end =
+      start + std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(opts.duration));
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for (int w = 0; w < opts.threads; w++) {
+    if (!opts.replay.empty()) {
+      workers.push_back(std::thread(run_replay_worker, std::cref(plan),
+                                    opts.speed, start, &next, &stats[w]));
+    } else {
+      workers.push_back(std::thread(run_worker, w, std::cref(opts),
+                                    std::cref(mix), start, end, &stats[w]));
+    }
+  }
+  for (size_t w = 0; w < workers.size(); w++) workers[w].join();
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  // Each worker kept its own histograms, merged only now
+  std::vector<std::pair<std::string, op_stats>> rows;
+  op_stats all;
+  for (size_t op = 0; op < names.size(); op++) {
+    op_stats merged;
+    for (int w = 0; w < opts.threads; w++) {
+      merged.micros.merge(stats[w][op].micros);
+      merged.errors += stats[w][op].errors;
+    }
+    rows.push_back({names[op], merged});
+    all.micros.merge(merged.micros);
+    all.errors += merged.errors;
+  }
+  rows.push_back({"all", all});
+
+  printf("\n%-15s %9s %7s %10s %9s %9s %9s %9s %9s\n", "operation", "count",
+         "errors", "req/s", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms",
+         "max ms");
+  for (size_t r = 0; r < rows.size(); r++) {
+    print_row(rows[r].first, rows[r].second, seconds);
+  }
+  if (!opts.save.empty() && !save_results(opts.save, rows)) {
+    fprintf(stderr, "Cannot write %s\n", opts.save.c_str());
+  }
+  if (!baseline.empty()) print_comparison(rows, baseline);
+  return all.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
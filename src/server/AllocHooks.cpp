@@ -0,0 +1,30 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "AllocStats.h"
+
+// Replaces the global operator new so AllocStats sees every allocation the
+// server makes, and the benchmarks, which link this file too; the array and
+// nothrow forms of new and delete forward to these
+void* operator new(size_t size) {
+  AllocStats::record(size);
+  if (size == 0) size = 1;
+  void* p;
+  // As the standard one does, give an installed new-handler the chance to
+  // free memory before failing
+  while ((p = malloc(size)) == NULL) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == NULL) throw std::bad_alloc();
+    handler();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
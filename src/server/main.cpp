@@ -3,16 +3,36 @@
  * Radek_Lewandowski
  */
 
+#include <chrono>  //NOLINT
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>  //NOLINT
 #include <nlohmann/json.hpp>  //NOLINT
 #include <restbed>            //NOLINT
+#include <sstream>            //NOLINT
 #include <string>             //NOLINT
+#include <system_error>       //NOLINT
+#include <thread>             //NOLINT
+#include <utility>            //NOLINT
 #include <vector>             //NOLINT
 
+#include "AllocStats.h"
+#include "Compression.h"
 #include "Issue.h"
 #include "IssueTracker.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "RequestLog.h"
+#include "Tracer.h"
+#include "ResponseCache.h"
+#include "SlowLog.h"
+#include "WebSocketCodec.h"
+#include "WireFrame.h"
 
 /**
  * List of request operations
@@ -22,18 +42,54 @@ enum OPERATION {
   GET_ISSUE,
   GET_ALL_ISSUES,
   DELETE_ISSUE,
+  ADD_LABEL,
+  REMOVE_LABEL,
+  SAVE_VIEW,
+  DELETE_VIEW,
   ADD_COMMENT,
   DELETE_COMMENT,
   CREATE_USER,
   GET_USER,
   LIST_ALL_USERS,
   REMOVE_USER,
+  GET_CHANGES,
+  WAIT_CHANGES,
+  QUERY_ISSUES,
+  SEARCH_ISSUES,
+  FIND_ISSUES,
+  FIND_USERS,
+  COMPLETE_ISSUES,
+  COMPLETE_USERS,
+  GET_STATS,
+  GET_HOT_ISSUES,
+  LABEL_QUERY,
+  FACET_COUNTS,
+  FILTER_ISSUES,
+  GET_VIEW,
+  LIST_VIEWS,
   ISSUE,
   USER,
   COMMENT,
   UNKNOWN
 };
 
+/**
+ * Names of the operations in OPERATION order, as the client sends them
+ */
+const char* OPERATION_NAMES[] = {
+    "addIssue",       "getIssue",       "getAllIssues",   "deleteIssue",
+    "addLabel",       "removeLabel",    "saveView",       "deleteView",
+    "addComment",     "deleteComment",  "createUser",     "getUser",
+    "listAllUsers",   "removeUser",     "getChanges",     "waitChanges",
+    "queryIssues",    "searchIssues",   "findIssues",     "findUsers",
+    "completeIssues", "completeUsers",  "getStats",       "getHotIssues",
+    "labelQuery",     "facetCounts",    "filterIssues",   "getView",
+    "listViews",      "issue",          "user",           "comment",
+    "unknown"};
+static_assert(sizeof(OPERATION_NAMES) / sizeof(OPERATION_NAMES[0]) ==
+                  UNKNOWN + 1,
+              "every OPERATION needs a name");
+
 /**
  * Operation types and message data
  */
@@ -47,6 +103,18 @@ struct expression {
   std::string username;
   std::string assign;
   std::string comment;
+  std::string since;
+  std::string epoch;
+  std::string after;
+  std::string limit;
+  std::string query;
+  std::string typos;
+  std::string label;
+  std::string allOf;
+  std::string anyOf;
+  std::string noneOf;
+  std::string explain;
+  std::string view;
 };
 
 IssueTracker* issueTracker;
@@ -58,6 +126,161 @@ IssueTracker* issueTracker;
 #define CLOSE_CONNECTION \
   { "Connection", "close" }
 
+/**
+ * Start time of this server run, prefixed to every ETag so that versions
+ * handed out by a previous run can never match
+ */
+std::string serverEpoch;
+
+/**
+ * GET responses smaller than this many bytes are sent uncompressed
+ */
+const size_t COMPRESSION_THRESHOLD = 1024;
+
+/**
+ * Serialized (and possibly compressed) GET responses for the current version
+ */
+ResponseCache responseCache;
+
+/**
+ * Requests received, recorded for issueLoad --replay when started with
+ * --capture=FILE
+ */
+RequestLog capture;
+
+/**
+ * Request counts and latencies per operation, served on /metrics
+ */
+Metrics metrics("issueserver",
+                std::vector<std::string>(std::begin(OPERATION_NAMES),
+                                         std::end(OPERATION_NAMES)));
+
+/**
+ * Requests taking at least slowMicros, logged when started with
+ * --slow-log; the threshold is kept here too so requests need no lock to
+ * check it
+ */
+SlowLog slowLog;
+bool logSlow = false;
+uint64_t slowMicros = 0;
+
+/**
+ * Checks whether a request field was given
+ * @param field the field; parse_get leaves missing ones as a space
+ * @return true if it holds more than spaces
+ */
+bool given(const std::string& field) {
+  return field.find_first_not_of(' ') != std::string::npos;
+}
+
+/**
+ * Queues a slow request for the slow log with its key parameters, the
+ * size of the store and the time spent in each phase
+ * @param exp the request
+ * @param micros how long it took
+ * @param ok false if the request failed
+ * @param allocated what it allocated, if allocations are counted
+ */
+void log_slow_request(const expression& exp, uint64_t micros, bool ok,
+                      const AllocStats::Counts& allocated) {
+  char now[32];
+  time_t seconds = time(NULL);
+  tm utc;
+  gmtime_r(&seconds, &utc);
+  strftime(now, sizeof(now), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+  nlohmann::json entry;
+  entry["time"] = now;
+  entry["op"] = OPERATION_NAMES[exp.op];
+  entry["ms"] = micros / 1e3;
+  entry["ok"] = ok;
+  if (given(exp.title)) entry["title"] = exp.title;
+  if (given(exp.username)) entry["username"] = exp.username;
+  if (given(exp.query)) entry["query"] = exp.query;
+  StoreStats store = issueTracker->getStoreStats();
+  entry["issues"] = store.issues;
+  entry["users"] = store.users;
+  entry["comments"] = store.comments;
+  nlohmann::json phases = nlohmann::json::object();
+  for (const auto& phase : Tracer::phases()) {
+    phases[phase.first] = phase.second / 1e6;
+  }
+  entry["phases_ms"] = phases;
+  if (AllocStats::enabled()) {
+    entry["allocations"] = allocated.allocations;
+    entry["allocated_bytes"] = allocated.bytes;
+  }
+  try {
+    slowLog.write(entry.dump());
+  } catch (const nlohmann::json::exception& e) {  // Text that is not UTF-8
+    fprintf(stderr, "Slow request not logged: %s\n", e.what());
+  }
+}
+
+/**
+ * Records a handled request in the metrics, with what it allocated if
+ * allocations are counted, in the slow log if it took too long and, if it
+ * is traced, as a span covering its phases, then ends it
+ * @param exp the request
+ * @param start when handling began
+ * @param ok false if the request failed
+ */
+void observe(const expression& exp,
+             std::chrono::steady_clock::time_point start, bool ok) {
+  auto end = std::chrono::steady_clock::now();
+  uint64_t micros =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count();
+  AllocStats::Counts allocated = AllocStats::request();
+  metrics.observe(exp.op, micros, !ok);
+  if (AllocStats::enabled()) {
+    metrics.observeAllocations(exp.op, allocated.allocations,
+                               allocated.bytes);
+  }
+  if (logSlow && micros >= slowMicros) {
+    log_slow_request(exp, micros, ok, allocated);
+  }
+  if (Tracer::active()) {
+    auto nanos = [](std::chrono::steady_clock::time_point time) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 time.time_since_epoch())
+          .count();
+    };
+    Tracer::record(OPERATION_NAMES[exp.op], nanos(start), nanos(end));
+  }
+  Tracer::endRequest();
+}
+
+/**
+ * Builds the ETag for the current tracker version. The tag is weak since the
+ * same version may be sent gzip-compressed or not
+ * @return weak entity tag
+ */
+std::string current_etag() {
+  return "W/\"" + serverEpoch + "-" +
+         std::to_string(issueTracker->getVersion()) + "\"";
+}
+
+/**
+ * Checks an If-None-Match header value against the current ETag
+ * @param header value of the If-None-Match request header
+ * @param etag the current ETag
+ * @return true if any listed tag (or "*") matches
+ */
+bool etag_matches(const std::string& header, const std::string& etag) {
+  std::stringstream ss(header);
+  std::string tag;
+  while (getline(ss, tag, ',')) {  // Header may list several tags
+    size_t start = tag.find_first_not_of(" \t");
+    if (start == std::string::npos) continue;
+    tag = tag.substr(start, tag.find_last_not_of(" \t") - start + 1);
+    if (tag.compare(0, 2, "W/") == 0) tag.erase(0, 2);  // Weak comparison
+    if (tag == "*" || tag == etag.substr(etag.compare(0, 2, "W/") ? 0 : 2))
+      return true;
+  }
+  return false;
+}
+
 /**
  * Sets the request type (ISSUE/USER/COMMENT)
  * @param expr pointer to the expression with the assigned OPERATION type
@@ -87,6 +310,14 @@ void set_operation(expression* expr, const char* operation) {
     expr->op = GET_ISSUE;
   else if (strcmp("getAllIssues", operation) == 0)
     expr->op = GET_ALL_ISSUES;
+  else if (strcmp("addLabel", operation) == 0)
+    expr->op = ADD_LABEL;
+  else if (strcmp("removeLabel", operation) == 0)
+    expr->op = REMOVE_LABEL;
+  else if (strcmp("saveView", operation) == 0)
+    expr->op = SAVE_VIEW;
+  else if (strcmp("deleteView", operation) == 0)
+    expr->op = DELETE_VIEW;
   else if (strcmp("deleteIssue", operation) == 0)
     expr->op = DELETE_ISSUE;
   else if (strcmp("addComment", operation) == 0)
@@ -101,6 +332,36 @@ void set_operation(expression* expr, const char* operation) {
     expr->op = LIST_ALL_USERS;
   else if (strcmp("removeUser", operation) == 0)
     expr->op = REMOVE_USER;
+  else if (strcmp("getChanges", operation) == 0)
+    expr->op = GET_CHANGES;
+  else if (strcmp("waitChanges", operation) == 0)
+    expr->op = WAIT_CHANGES;
+  else if (strcmp("queryIssues", operation) == 0)
+    expr->op = QUERY_ISSUES;
+  else if (strcmp("searchIssues", operation) == 0)
+    expr->op = SEARCH_ISSUES;
+  else if (strcmp("findIssues", operation) == 0)
+    expr->op = FIND_ISSUES;
+  else if (strcmp("findUsers", operation) == 0)
+    expr->op = FIND_USERS;
+  else if (strcmp("completeIssues", operation) == 0)
+    expr->op = COMPLETE_ISSUES;
+  else if (strcmp("completeUsers", operation) == 0)
+    expr->op = COMPLETE_USERS;
+  else if (strcmp("getStats", operation) == 0)
+    expr->op = GET_STATS;
+  else if (strcmp("getHotIssues", operation) == 0)
+    expr->op = GET_HOT_ISSUES;
+  else if (strcmp("labelQuery", operation) == 0)
+    expr->op = LABEL_QUERY;
+  else if (strcmp("facetCounts", operation) == 0)
+    expr->op = FACET_COUNTS;
+  else if (strcmp("filterIssues", operation) == 0)
+    expr->op = FILTER_ISSUES;
+  else if (strcmp("getView", operation) == 0)
+    expr->op = GET_VIEW;
+  else if (strcmp("listViews", operation) == 0)
+    expr->op = LIST_VIEWS;
   else
     expr->op = UNKNOWN;
 }
@@ -136,7 +397,13 @@ void parse(const char* data, expression* expr) {
   switch (expr->type) {
     case ISSUE: {  // If ISSUE, sets issue data to appropriate expr attributes
       expr->title = result[2];
-      if (result.size() > 3) {
+      if (expr->op == ADD_LABEL || expr->op == REMOVE_LABEL) {
+        expr->label = result.size() > 3 ? result[3] : "";
+      } else if (expr->op == SAVE_VIEW || expr->op == DELETE_VIEW) {
+        // Views are named by the title field: view ~ query
+        expr->view = result[2];
+        expr->query = result.size() > 3 ? result[3] : "";
+      } else if (result.size() > 3) {
         expr->description = result[3];
         expr->os = result[4];
         expr->issueType = result[5];
@@ -161,15 +428,111 @@ void parse(const char* data, expression* expr) {
 }
 
 /**
- * Handles all POST issue operations
- * @param exp expression used to hold issue fields and request operations
- * @param session closes the restbed session and sends the response back
- * to the client
+ * Gets an optional query parameter
+ * @param params query parameters by name
+ * @param name parameter name
+ * @param fallback value used when the parameter is missing
+ * @return the parameter value or fallback
  */
-void issue_operations(expression exp,
-                      const std::shared_ptr<restbed::Session>& session) {
-  std::string result = "";  // Result of request operation to be sent to client
+std::string get_param(const std::map<std::string, std::string>& params,
+                      const std::string& name, const std::string& fallback) {
+  auto found = params.find(name);
+  return found == params.end() ? fallback : found->second;
+}
+
+/**
+ * Sets the GET operation and its parameters from query parameters
+ * @param params query parameters by name
+ * @param expr expression pointer which will have attributes assigned
+ */
+void parse_get(const std::map<std::string, std::string>& params,
+               expression* expr) {
+  expr->op = UNKNOWN;
+  expr->type = UNKNOWN;
+  expr->title = UNKNOWN;
+  expr->username = UNKNOWN;
+
+  auto op = params.find("op");
+  if (op == params.end()) return;
+  set_operation(expr, op->second.c_str());  // Sets exp.op value
+  if (params.count("title")) {
+    // Sets exp.title as title sent from client
+    expr->title = params.at("title");
+  } else if (params.count("user")) {
+    // Sets exp.username as username sent from client
+    expr->username = params.at("user");
+  }
+  // Version (and the server run it came from) for the change feed
+  expr->since = get_param(params, "since", "0");
+  expr->epoch = get_param(params, "epoch", "");
+  // Filters for queryIssues, an empty filter matches anything
+  expr->os = get_param(params, "os", "");
+  expr->issueType = get_param(params, "type", "");
+  expr->assign = get_param(params, "assign", "");
+  if (expr->op == QUERY_ISSUES) {
+    expr->username = get_param(params, "user", "");
+  }
+  // Cursor and page size for paged lists
+  expr->after = get_param(params, "after", "");
+  expr->limit = get_param(params, "limit", "");
+  // Text for searches
+  expr->query = get_param(params, "q", "");
+  expr->typos = get_param(params, "typos", "0");
+  // Comma separated facets for labelQuery and facetCounts
+  expr->allOf = get_param(params, "all", "");
+  expr->anyOf = get_param(params, "any", "");
+  expr->noneOf = get_param(params, "none", "");
+  // Set to 1 for the plan of a filterIssues query instead of its results
+  expr->explain = get_param(params, "explain", "0");
+  // Name of a saved view for getView
+  expr->view = get_param(params, "view", "");
+}
+
+/**
+ * Page size used when a client does not ask for one
+ */
+const size_t DEFAULT_PAGE_SIZE = 50;
 
+/**
+ * Largest page the server will build, whatever the client asks for
+ */
+const size_t MAX_PAGE_SIZE = 500;
+
+/**
+ * Gets the page size for a paged list
+ * @param limit limit requested by the client, "" for the default
+ * @return the page size, between 1 and MAX_PAGE_SIZE
+ */
+size_t page_size(const std::string& limit) {
+  size_t size = strtoull(limit.c_str(), NULL, 10);
+  if (limit.empty() || size == 0) return DEFAULT_PAGE_SIZE;
+  return size < MAX_PAGE_SIZE ? size : MAX_PAGE_SIZE;
+}
+
+/**
+ * Most typos a fragment lookup may allow, which bounds its candidate set
+ */
+const int MAX_TYPOS = 2;
+
+/**
+ * Gets the typos allowed for a fragment lookup
+ * @param typos typos requested by the client
+ * @return the typos allowed, between 0 and MAX_TYPOS
+ */
+int typo_count(const std::string& typos) {
+  int count = atoi(typos.c_str());
+  if (count < 0) return 0;
+  return count < MAX_TYPOS ? count : MAX_TYPOS;
+}
+
+/**
+ * Runs a POST issue operation against the tracker
+ * @param exp expression used to hold issue fields and request operations
+ * @param result set to the result to be sent to the client
+ * @return false if exp.op is not an issue operation
+ */
+bool run_issue_operation(expression exp, std::string* result) {
+  TraceSpan span("IssueTracker");
   // Issue fields set from expression attributes
   std::string title = exp.title;
   std::string desc = exp.description;
@@ -178,24 +541,56 @@ void issue_operations(expression exp,
   std::string user = exp.username;
   std::string assign = exp.assign;
 
+  switch (exp.op) {
+    case ADD_ISSUE: {  // Create new issue
+      issueTracker->addAnIssue(title, desc, os, iType, user, assign, *result);
+      break;
+    }
+    case DELETE_ISSUE: {  // Delete an existing issue
+      issueTracker->deleteIssue(title);
+      break;
+    }
+    case ADD_LABEL: {  // Label an existing issue
+      *result = issueTracker->addLabel(title, exp.label);
+      break;
+    }
+    case REMOVE_LABEL: {  // Remove a label from an existing issue
+      *result = issueTracker->removeLabel(title, exp.label);
+      break;
+    }
+    case SAVE_VIEW: {  // Save a named query whose matches are kept current
+      *result = issueTracker->saveView(exp.view, exp.query);
+      break;
+    }
+    case DELETE_VIEW: {  // Delete a saved view
+      *result = issueTracker->deleteView(exp.view);
+      break;
+    }
+    default:  // exp.op not set properly
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Handles all POST issue operations
+ * @param exp expression used to hold issue fields and request operations
+ * @param session closes the restbed session and sends the response back
+ * to the client
+ * @return false if the request failed
+ */
+bool issue_operations(expression exp,
+                      const std::shared_ptr<restbed::Session>& session) {
+  std::string result = "";  // Result of request operation to be sent to client
+
   try {
-    switch (exp.op) {
-      case ADD_ISSUE: {  // Create new issue
-        issueTracker->addAnIssue(title, desc, os, iType, user, assign, result);
-        break;
-      }
-      case DELETE_ISSUE: {  // Delete an existing issue
-        issueTracker->deleteIssue(title);
-        break;
-      }
-      default: {  // Error message, exp.op not set properly
-        std::string errorMsg = "Issue Operation Error";
-        session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
-                       {ALLOW_ALL,
-                        {"Content-Length", std::to_string(errorMsg.length())},
-                        CLOSE_CONNECTION});
-        return;
-      }
+    if (!run_issue_operation(exp, &result)) {  // exp.op not set properly
+      std::string errorMsg = "Issue Operation Error";
+      session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
+                     {ALLOW_ALL,
+                      {"Content-Length", std::to_string(errorMsg.length())},
+                      CLOSE_CONNECTION});
+      return false;
     }
   } catch (int e) {  // Any other errors caught and message thrown
     std::string errorMsg = "Unexpected Error Found";
@@ -203,20 +598,52 @@ void issue_operations(expression exp,
                    {ALLOW_ALL,
                     {"Content-Length", std::to_string(errorMsg.length())},
                     CLOSE_CONNECTION});
-    return;
+    return false;
   }
 
   // Result converted to JSON
-  std::string resultStr = result;
-  nlohmann::json resultJSON;
-  resultJSON["result"] = resultStr;
-  std::string response = resultJSON.dump();
+  std::string response;
+  {
+    TraceSpan span("json");
+    std::string resultStr = result;
+    nlohmann::json resultJSON;
+    resultJSON["result"] = resultStr;
+    response = resultJSON.dump();
+  }
 
   // Response sent back to client and session closed
+  TraceSpan span("close");
   session->close(restbed::OK, response,
                  {ALLOW_ALL,
                   {"Content-Length", std::to_string(response.length())},
                   CLOSE_CONNECTION});
+  return true;
+}
+
+/**
+ * Runs a POST user operation against the tracker
+ * @param exp expression used to hold username and request operations
+ * @param result set to the result to be sent to the client
+ * @return false if exp.op is not a user operation
+ */
+bool run_user_operation(expression exp, std::string* result) {
+  TraceSpan span("IssueTracker");
+  // Username set from expression username attribute
+  std::string username = exp.username;
+
+  switch (exp.op) {
+    case CREATE_USER: {  // Create new user
+      *result = issueTracker->createUser(username);
+      break;
+    }
+    case REMOVE_USER: {  // Delete existing user
+      *result = issueTracker->deleteUser(username);
+      break;
+    }
+    default:  // exp.op not set properly
+      return false;
+  }
+  return true;
 }
 
 /**
@@ -224,32 +651,20 @@ void issue_operations(expression exp,
  * @param exp expression used to hold username and request operations
  * @param session closes the restbed session and sends the response back
  * to the client
+ * @return false if the request failed
  */
-void user_operations(expression exp,
+bool user_operations(expression exp,
                      const std::shared_ptr<restbed::Session>& session) {
   std::string result = "";  // Result of request operation to be sent to client
 
-  // Username set from expression username attribute
-  std::string username = exp.username;
-
   try {
-    switch (exp.op) {
-      case CREATE_USER: {  // Create new user
-        result = issueTracker->createUser(username);
-        break;
-      }
-      case REMOVE_USER: {  // Delete existing user
-        result = issueTracker->deleteUser(username);
-        break;
-      }
-      default: {  // Error message, exp.op not set properly
-        std::string errorMsg = "User Operation Error";
-        session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
-                       {ALLOW_ALL,
-                        {"Content-Length", std::to_string(errorMsg.length())},
-                        CLOSE_CONNECTION});
-        return;
-      }
+    if (!run_user_operation(exp, &result)) {  // exp.op not set properly
+      std::string errorMsg = "User Operation Error";
+      session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
+                     {ALLOW_ALL,
+                      {"Content-Length", std::to_string(errorMsg.length())},
+                      CLOSE_CONNECTION});
+      return false;
     }
   } catch (int e) {  // Any other errors caught and message thrown
     std::string errorMsg = "Unexpected Error Found";
@@ -257,20 +672,50 @@ void user_operations(expression exp,
                    {ALLOW_ALL,
                     {"Content-Length", std::to_string(errorMsg.length())},
                     CLOSE_CONNECTION});
-    return;
+    return false;
   }
 
   // Result converted to JSON
-  std::string resultStr = result;
-  nlohmann::json resultJSON;
-  resultJSON["result"] = resultStr;
-  std::string response = resultJSON.dump();
+  std::string response;
+  {
+    TraceSpan span("json");
+    std::string resultStr = result;
+    nlohmann::json resultJSON;
+    resultJSON["result"] = resultStr;
+    response = resultJSON.dump();
+  }
 
   // Response sent back to client and session closed
+  TraceSpan span("close");
   session->close(restbed::OK, response,
                  {ALLOW_ALL,
                   {"Content-Length", std::to_string(response.length())},
                   CLOSE_CONNECTION});
+  return true;
+}
+
+/**
+ * Runs a POST comment operation against the tracker
+ * @param exp expression used to hold comment fields and request operations
+ * @param result set to the result to be sent to the client
+ * @return false if exp.op is not a comment operation
+ */
+bool run_comment_operation(expression exp, std::string* result) {
+  TraceSpan span("IssueTracker");
+  // Comment fields set from expression attributes
+  std::string title = exp.title;
+  std::string username = exp.username;
+  std::string comment = exp.comment;
+
+  switch (exp.op) {
+    case ADD_COMMENT: {  // Create new comment
+      issueTracker->addToCommentVec(title, comment, username, *result);
+      break;
+    }
+    default:  // exp.op not set properly
+      return false;
+  }
+  return true;
 }
 
 /**
@@ -278,31 +723,21 @@ void user_operations(expression exp,
  * @param exp expression used to hold comment fields and request operations
  * @param session closes the restbed session and sends the response back
  * to the client
+ * @return false if the request failed
  */
-void comment_operations(expression exp,
+bool comment_operations(expression exp,
                         const std::shared_ptr<restbed::Session>& session) {
   // Result of request operation to be sent to client
   std::string result = "Comment not added";
 
-  // Comment fields set from expression attributes
-  std::string title = exp.title;
-  std::string username = exp.username;
-  std::string comment = exp.comment;
-
   try {
-    switch (exp.op) {
-      case ADD_COMMENT: {  // Create new comment
-        issueTracker->addToCommentVec(title, comment, username, result);
-        break;
-      }
-      default: {  // Error message, exp.op not set properly
-        std::string errorMsg = "Comment Operation Error";
-        session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
-                       {ALLOW_ALL,
-                        {"Content-Length", std::to_string(errorMsg.length())},
-                        CLOSE_CONNECTION});
-        return;
-      }
+    if (!run_comment_operation(exp, &result)) {  // exp.op not set properly
+      std::string errorMsg = "Comment Operation Error";
+      session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
+                     {ALLOW_ALL,
+                      {"Content-Length", std::to_string(errorMsg.length())},
+                      CLOSE_CONNECTION});
+      return false;
     }
   } catch (int e) {  // Any other errors caught and message thrown
     std::string errorMsg = "Unexpected Error Found";
@@ -310,46 +745,195 @@ void comment_operations(expression exp,
                    {ALLOW_ALL,
                     {"Content-Length", std::to_string(errorMsg.length())},
                     CLOSE_CONNECTION});
-    return;
+    return false;
   }
 
   // Result converted to JSON
-  std::string resultStr = result;
-  nlohmann::json resultJSON;
-  resultJSON["result"] = resultStr;
-  std::string response = resultJSON.dump();
+  std::string response;
+  {
+    TraceSpan span("json");
+    std::string resultStr = result;
+    nlohmann::json resultJSON;
+    resultJSON["result"] = resultStr;
+    response = resultJSON.dump();
+  }
 
   // Response sent back to client and session closed
+  TraceSpan span("close");
   session->close(restbed::OK, response,
                  {ALLOW_ALL,
                   {"Content-Length", std::to_string(response.length())},
                   CLOSE_CONNECTION});
+  return true;
+}
+
+/**
+ * Runs a POST operation against the tracker based on exp.type
+ * @param exp expression holding the request type, operation and fields
+ * @param result set to the result to be sent to the client
+ * @return false if the type or operation is unknown
+ */
+bool run_post_operation(expression exp, std::string* result) {
+  switch (exp.type) {
+    case ISSUE:
+      return run_issue_operation(exp, result);
+    case USER:
+      return run_user_operation(exp, result);
+    case COMMENT:
+      *result = "Comment not added";
+      return run_comment_operation(exp, result);
+    default:
+      return false;
+  }
 }
 
 /**
  * Handles POST request operations separately based on exp.type
  * @param exp Decides which method to handle operation based on exp.type
  * @param session Passes the session through to the appropriate operation
+ * @return false if the request failed
  */
-void post_operations(expression exp,
+bool post_operations(expression exp,
                      const std::shared_ptr<restbed::Session>& session) {
   switch (exp.type) {
     case ISSUE: {
-      issue_operations(exp, session);  // Handles all issue operations
-      break;
+      return issue_operations(exp, session);  // Handles all issue operations
     }
     case USER: {
-      user_operations(exp, session);  // Handles all user operations
-      break;
+      return user_operations(exp, session);  // Handles all user operations
     }
     case COMMENT: {
-      comment_operations(exp, session);  // Handles all comment operations
-      break;
+      return comment_operations(exp, session);  // Handles comment operations
     }
     default: {
+      return false;
+    }
+  }
+}
+
+/**
+ * Runs a GET operation against the tracker
+ * @param exp Holds issue title/description, username and handles operation
+ * @param result set to the result to be sent to the client
+ * @return false if exp.op is not a GET operation
+ */
+bool run_get_operation(expression exp, std::string* result) {
+  TraceSpan span("IssueTracker");
+  // Issue title/description and username set from expression attributes
+  std::string title = exp.title;
+  std::string desc = exp.description;
+  std::string username = exp.username;
+
+  switch (exp.op) {
+    case GET_ISSUE: {  // Get a single issue by title, comments paged
+      *result = issueTracker->getAnIssuePage(
+          title, strtoull(exp.after.c_str(), NULL, 10), page_size(exp.limit));
+      break;
+    }
+    case GET_ALL_ISSUES: {  // Get a page of existing issues
+      *result = issueTracker->getIssuePage(
+          strtoull(exp.after.c_str(), NULL, 10), page_size(exp.limit));
+      break;
+    }
+    case GET_USER: {  // Get a single user by username
+      *result = issueTracker->getUser(username);
+      break;
+    }
+    case LIST_ALL_USERS: {  // Get a page of existing users
+      *result = issueTracker->getUserPage(exp.after, page_size(exp.limit));
+      break;
+    }
+    case QUERY_ISSUES: {  // Get the issues matching the given filters
+      *result = issueTracker->queryIssues(exp.os, exp.issueType, username,
+                                          exp.assign);
+      break;
+    }
+    case GET_STATS: {  // Get the issue counts by type, OS, author, assignee
+      *result = issueTracker->getStats();
+      break;
+    }
+    case GET_HOT_ISSUES: {  // Get the issues with the most recent comments
+      *result = issueTracker->getHotIssues(page_size(exp.limit));
+      break;
+    }
+    case LABEL_QUERY: {  // Get the issues matching a combination of facets
+      *result = issueTracker->labelQuery(exp.allOf, exp.anyOf, exp.noneOf);
+      break;
+    }
+    case FACET_COUNTS: {  // Count the matching issues by label, type and OS
+      *result = issueTracker->facetCounts(exp.allOf, exp.anyOf, exp.noneOf);
+      break;
+    }
+    case FILTER_ISSUES: {  // Get the issues matching a query, or its plan
+      *result = issueTracker->filterIssues(exp.query, exp.explain == "1");
+      break;
+    }
+    case GET_VIEW: {  // Get the current matches of a saved view
+      *result = issueTracker->getView(exp.view);
+      break;
+    }
+    case LIST_VIEWS: {  // Get every saved view with its match count
+      *result = issueTracker->listViews();
+      break;
+    }
+    case SEARCH_ISSUES: {  // Get the best matches for a full-text query
+      *result = issueTracker->searchIssues(exp.query, page_size(exp.limit));
+      break;
+    }
+    case FIND_ISSUES: {  // Get the titles containing a fragment
+      *result = issueTracker->findIssueTitles(
+          exp.query, typo_count(exp.typos), page_size(exp.limit));
+      break;
+    }
+    case FIND_USERS: {  // Get the usernames containing a fragment
+      *result = issueTracker->findUsers(exp.query, typo_count(exp.typos),
+                                        page_size(exp.limit));
+      break;
+    }
+    case COMPLETE_ISSUES: {  // Get the titles starting with a prefix
+      *result =
+          issueTracker->completeIssueTitles(exp.query, page_size(exp.limit));
+      break;
+    }
+    case COMPLETE_USERS: {  // Get the usernames starting with a prefix
+      *result = issueTracker->completeUsers(exp.query, page_size(exp.limit));
+      break;
+    }
+    case GET_CHANGES: {  // Get the changes since a client's version
+      // Versions handed out by another server run are meaningless here
+      if (exp.epoch != serverEpoch) {
+        *result = issueTracker->getSnapshot();
+      } else {
+        *result = issueTracker->getChangesSince(strtoull(exp.since.c_str(),
+                                                        NULL, 10));
+      }
       break;
     }
+    default:  // exp.op not set properly
+      return false;
   }
+  return true;
+}
+
+/**
+ * Sends a successful GET response with its ETag and session closed
+ * @param session the restbed session to close
+ * @param response the response body, compressed if encoding is set
+ * @param encoding the Content-Encoding of the body ("" if none)
+ * @param etag the ETag of the current version
+ */
+void send_get_response(const std::shared_ptr<restbed::Session>& session,
+                       const std::string& response,
+                       const std::string& encoding, const std::string& etag) {
+  std::multimap<std::string, std::string> headers = {
+      ALLOW_ALL,
+      {"Content-Length", std::to_string(response.length())},
+      {"ETag", etag},
+      {"Vary", "Accept-Encoding"},
+      CLOSE_CONNECTION};
+  if (!encoding.empty()) headers.insert({"Content-Encoding", encoding});
+  TraceSpan span("close");
+  session->close(restbed::OK, response, headers);
 }
 
 /**
@@ -357,42 +941,48 @@ void post_operations(expression exp,
  * @param exp Holds issue title/description, username and handles operation
  * @param session closes the restbed session and sends the response back
  * to the client
+ * @return false if the request failed
  */
-void get_operations(expression exp,
+bool get_operations(expression exp,
                     const std::shared_ptr<restbed::Session>& session) {
   std::string result = "";  // Result of request operation to be sent to client
 
-  // Issue title/description and username set from expression attributes
-  std::string title = exp.title;
-  std::string desc = exp.description;
-  std::string username = exp.username;
+  // Clients whose copy is still current get a body-less 304
+  std::string etag = current_etag();
+  const auto request = session->get_request();
+  if (exp.op != UNKNOWN &&
+      etag_matches(request->get_header("If-None-Match", ""), etag)) {
+    session->close(restbed::NOT_MODIFIED,
+                   {ALLOW_ALL, {"ETag", etag}, CLOSE_CONNECTION});
+    return true;
+  }
+
+  // Responses already built for this version and encoding are resent as is
+  uint64_t version = issueTracker->getVersion();
+  bool gzip = Compression::acceptsGzip(
+      request->get_header("Accept-Encoding", ""));
+  std::string key = gzip ? "gzip" : "identity";
+  for (const auto& param : request->get_query_parameters())
+    key += "~" + param.first + "=" + param.second;
+  std::string response, encoding;
+  bool cached;
+  {
+    TraceSpan span("cache");
+    cached = responseCache.get(key, version, &response, &encoding);
+  }
+  if (cached) {
+    send_get_response(session, response, encoding, etag);
+    return true;
+  }
 
   try {
-    switch (exp.op) {
-      case GET_ISSUE: {  // Get a single issue by title
-        result = issueTracker->getAnIssue(title);
-        break;
-      }
-      case GET_ALL_ISSUES: {  // Get all existing issues
-        result = issueTracker->getAllIssues();
-        break;
-      }
-      case GET_USER: {  // Get a single user by username
-        result = issueTracker->getUser(username);
-        break;
-      }
-      case LIST_ALL_USERS: {  // Get all existing users
-        result = issueTracker->getAllUsers();
-        break;
-      }
-      default: {  // Error message, exp.op not set properly
-        std::string errorMsg = "GET Operation Error";
-        session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
-                       {ALLOW_ALL,
-                        {"Content-Length", std::to_string(errorMsg.length())},
-                        CLOSE_CONNECTION});
-        return;
-      }
+    if (!run_get_operation(exp, &result)) {  // exp.op not set properly
+      std::string errorMsg = "GET Operation Error";
+      session->close(restbed::BAD_REQUEST, "Unknown exp.op value",
+                     {ALLOW_ALL,
+                      {"Content-Length", std::to_string(errorMsg.length())},
+                      CLOSE_CONNECTION});
+      return false;
     }
   } catch (int e) {  // Any other errors caught and message thrown
     std::string errorMsg = "Unexpected Error Found";
@@ -400,29 +990,413 @@ void get_operations(expression exp,
                    {ALLOW_ALL,
                     {"Content-Length", std::to_string(errorMsg.length())},
                     CLOSE_CONNECTION});
-    return;
+    return false;
   }
 
   // Result converted to JSON
-  std::string resultStr = result;
-  nlohmann::json resultJSON;
-  resultJSON["result"] = resultStr;
-  std::string response = resultJSON.dump();
+  {
+    TraceSpan span("json");
+    std::string resultStr = result;
+    nlohmann::json resultJSON;
+    resultJSON["result"] = resultStr;
+    if (exp.op == GET_CHANGES) resultJSON["epoch"] = serverEpoch;
+    response = resultJSON.dump();
+  }
 
-  // Response sent back to client and session closed
-  session->close(restbed::OK, response,
-                 {ALLOW_ALL,
-                  {"Content-Length", std::to_string(response.length())},
-                  CLOSE_CONNECTION});
+  // Large bodies are compressed once and cached for this version
+  encoding = "";
+  if (gzip && response.length() >= COMPRESSION_THRESHOLD) {
+    TraceSpan span("gzip");
+    response = Compression::gzip(response);
+    encoding = "gzip";
+  }
+  responseCache.put(key, version, response, encoding);
+  send_get_response(session, response, encoding, etag);
+  return true;
+}
+
+/**
+ * A long-poll request parked until a relevant change commits
+ */
+struct parked_session {
+  std::shared_ptr<restbed::Session> session;
+  uint64_t since;
+  std::chrono::steady_clock::time_point deadline;
+};
+
+/**
+ * Seconds a long-poll request stays parked before it is answered anyway,
+ * with whatever changed since its version
+ */
+const int LONG_POLL_TIMEOUT = 30;
+
+/**
+ * Sessions waiting for any change
+ */
+std::vector<parked_session> globalWaiters;
+/**
+ * Sessions waiting for a change to one issue, keyed by issue title
+ */
+std::map<std::string, std::vector<parked_session>> issueWaiters;
+/**
+ * Tracker version the parked sessions were last checked against
+ */
+uint64_t notifiedVersion = 0;
+/**
+ * Guards the parked sessions against the expiry sweep
+ */
+std::mutex waitersLock;
+
+/**
+ * Builds the change feed response for a version, sharing one serialization
+ * between every waiter that saw the same version
+ * @param since version the waiters have already seen
+ * @param responses serialized responses already built, keyed by version
+ * @return the JSON response body
+ */
+const std::string& changes_response(
+    uint64_t since, std::map<uint64_t, std::string>* responses) {
+  auto found = responses->find(since);
+  if (found == responses->end()) {
+    nlohmann::json resultJSON;
+    resultJSON["result"] = issueTracker->getChangesSince(since);
+    resultJSON["epoch"] = serverEpoch;
+    found = responses->insert(std::make_pair(since, resultJSON.dump())).first;
+  }
+  return found->second;
+}
+
+/**
+ * Answers a parked session unless the client has already gone away
+ * @param waiter the parked session
+ * @param response the JSON response body
+ */
+void complete_waiter(const parked_session& waiter,
+                     const std::string& response) {
+  if (waiter.session->is_closed()) return;
+  waiter.session->close(restbed::OK, response,
+                        {ALLOW_ALL,
+                         {"Content-Length", std::to_string(response.length())},
+                         CLOSE_CONNECTION});
+}
+
+/**
+ * Wakes parked sessions once a mutation has committed. Global waiters are all
+ * answered; issue waiters are only looked up for the titles that changed.
+ */
+void notify_waiters() {
+  std::lock_guard<std::mutex> guard(waitersLock);
+  uint64_t version = issueTracker->getVersion();
+  if (version == notifiedVersion) return;
+  std::map<uint64_t, std::string> responses;
+
+  std::vector<parked_session> woken;
+  woken.swap(globalWaiters);
+  for (int i = 0; i < woken.size(); i++) {
+    complete_waiter(woken[i], changes_response(woken[i].since, &responses));
+  }
+
+  if (!issueWaiters.empty()) {
+    std::vector<Change> delta;
+    if (issueTracker->getChangeList(notifiedVersion, delta)) {
+      for (int i = 0; i < delta.size(); i++) {
+        // User changes are keyed by username, their issues by updateIssue
+        if (delta[i].kind == "createUser" || delta[i].kind == "removeUser") {
+          continue;
+        }
+        auto watched = issueWaiters.find(delta[i].key);
+        if (watched == issueWaiters.end()) continue;
+        for (int j = 0; j < watched->second.size(); j++) {
+          parked_session& waiter = watched->second[j];
+          complete_waiter(waiter, changes_response(waiter.since, &responses));
+        }
+        issueWaiters.erase(watched);
+      }
+    } else {  // Too many changes to tell which issues moved, wake everyone
+      for (auto& watched : issueWaiters) {
+        for (int j = 0; j < watched.second.size(); j++) {
+          parked_session& waiter = watched.second[j];
+          complete_waiter(waiter, changes_response(waiter.since, &responses));
+        }
+      }
+      issueWaiters.clear();
+    }
+  }
+  notifiedVersion = version;
+}
+
+/**
+ * Answers long-poll requests that reached their deadline with the changes
+ * since their version, which is empty unless they watch one issue and only
+ * other issues changed, and forgets sessions whose client disconnected.
+ * Runs once a second.
+ */
+void expire_waiters() {
+  std::lock_guard<std::mutex> guard(waitersLock);
+  auto now = std::chrono::steady_clock::now();
+  std::map<uint64_t, std::string> responses;
+  auto expire = [&](std::vector<parked_session>* waiters) {
+    size_t kept = 0;
+    for (size_t i = 0; i < waiters->size(); i++) {
+      parked_session& waiter = (*waiters)[i];
+      if (waiter.session->is_closed()) continue;  // Client gave up
+      if (waiter.deadline <= now) {
+        complete_waiter(waiter, changes_response(waiter.since, &responses));
+        continue;
+      }
+      (*waiters)[kept++] = waiter;
+    }
+    waiters->erase(waiters->begin() + kept, waiters->end());
+  };
+
+  expire(&globalWaiters);
+  for (auto watched = issueWaiters.begin(); watched != issueWaiters.end();) {
+    expire(&watched->second);
+    if (watched->second.empty()) {
+      watched = issueWaiters.erase(watched);
+    } else {
+      ++watched;
+    }
+  }
+}
+
+/**
+ * Handles a long-poll for changes. Answers at once if a relevant change is
+ * already committed, otherwise parks the session (no thread is held) until
+ * notify_waiters or expire_waiters completes it.
+ * @param exp holds the version and server run the client has seen
+ * @param session the request session
+ */
+void wait_for_changes(expression exp,
+                      const std::shared_ptr<restbed::Session>& session) {
+  // An optional title narrows the watch to a single issue
+  const auto request = session->get_request();
+  std::string title = request->get_query_parameter("title", "");
+  uint64_t since = strtoull(exp.since.c_str(), NULL, 10);
+
+  std::lock_guard<std::mutex> guard(waitersLock);
+  std::vector<Change> delta;
+  bool ready = exp.epoch != serverEpoch ||
+               !issueTracker->getChangeList(since, delta);  // Needs snapshot
+  for (int i = 0; !ready && i < delta.size(); i++) {
+    ready = title.empty() || delta[i].key == title;
+  }
+
+  if (ready) {
+    nlohmann::json resultJSON;
+    resultJSON["result"] = exp.epoch != serverEpoch
+                               ? issueTracker->getSnapshot()
+                               : issueTracker->getChangesSince(since);
+    resultJSON["epoch"] = serverEpoch;
+    parked_session waiter;
+    waiter.session = session;
+    complete_waiter(waiter, resultJSON.dump());
+    return;
+  }
+
+  parked_session waiter;
+  waiter.session = session;
+  waiter.since = since;
+  waiter.deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(LONG_POLL_TIMEOUT);
+  if (title.empty()) {
+    globalWaiters.push_back(waiter);
+  } else {
+    issueWaiters[title].push_back(waiter);
+  }
+}
+
+/**
+ * Open WebSocket connections keyed by their restbed key
+ */
+std::map<std::string, std::shared_ptr<restbed::WebSocket>> sockets;
+/**
+ * Tracker version the open sockets were last sent events for
+ */
+uint64_t pushedVersion = 0;
+
+/**
+ * Sends an encoded WireFrame as a binary WebSocket message
+ * @param socket the connection
+ * @param frame the encoded frame
+ */
+void send_frame(const std::shared_ptr<restbed::WebSocket>& socket,
+                const std::string& frame) {
+  TraceSpan span("send");
+  socket->send(std::make_shared<restbed::WebSocketMessage>(
+      restbed::WebSocketMessage::BINARY_FRAME,
+      restbed::Bytes(frame.begin(), frame.end())));
+}
+
+/**
+ * Pushes the changes since the last push to every open socket. The event is
+ * encoded once and shared by all connections.
+ */
+void push_events() {
+  uint64_t version = issueTracker->getVersion();
+  if (version != pushedVersion && !sockets.empty()) {
+    std::string frame =
+        WireFrame::encode(WireFrame::EVENT, pushedVersion,
+                          issueTracker->getChangesSince(pushedVersion));
+    auto event = std::make_shared<restbed::WebSocketMessage>(
+        restbed::WebSocketMessage::BINARY_FRAME,
+        restbed::Bytes(frame.begin(), frame.end()));
+    for (auto& entry : sockets) {
+      if (entry.second->is_open()) entry.second->send(event);
+    }
+  }
+  pushedVersion = version;
+}
+
+/**
+ * Tells every waiting client about the mutations committed since the last
+ * call, through long-polls and WebSocket events
+ */
+void publish_changes() {
+  notify_waiters();
+  push_events();
+}
+
+/**
+ * Handles a WireFrame request sent over a WebSocket and answers it with a
+ * RESPONSE (or FAILURE) frame carrying the same id
+ * @param socket the connection the request arrived on
+ * @param message the WebSocket message
+ */
+void socket_message_handler(
+    const std::shared_ptr<restbed::WebSocket> socket,
+    const std::shared_ptr<restbed::WebSocketMessage> message) {
+  const auto opcode = message->get_opcode();
+  if (opcode == restbed::WebSocketMessage::PING_FRAME) {
+    socket->send(std::make_shared<restbed::WebSocketMessage>(
+        restbed::WebSocketMessage::PONG_FRAME, message->get_data()));
+    return;
+  } else if (opcode == restbed::WebSocketMessage::CONNECTION_CLOSE_FRAME) {
+    sockets.erase(socket->get_key());
+    socket->close();
+    return;
+  } else if (opcode != restbed::WebSocketMessage::BINARY_FRAME) {
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  Tracer::beginRequest();
+  AllocStats::beginRequest();
+  const restbed::Bytes data = message->get_data();
+  int kind;
+  uint64_t id;
+  std::string payload;
+  bool decoded;
+  {
+    TraceSpan span("decode");
+    decoded = WireFrame::decode(std::string(data.begin(), data.end()), &kind,
+                                &id, &payload);
+  }
+  if (!decoded) {
+    Tracer::endRequest();
+    return;
+  }
+
+  expression exp;
+  exp.op = UNKNOWN;
+  std::string result = "";
+  bool handled = false;
+  try {
+    if (kind == WireFrame::GET_REQUEST) {
+      // Payload holds "key~value" pairs of the query parameters
+      std::vector<std::pair<std::string, std::string>> pairs;
+      {
+        TraceSpan span("parse");
+        // A malformed payload leaves exp.op UNKNOWN, which fails below
+        if (WireFrame::decodeParams(payload, &pairs)) {
+          parse_get(std::map<std::string, std::string>(pairs.begin(),
+                                                       pairs.end()),
+                    &exp);
+        }
+      }
+      if (exp.op != WAIT_CHANGES) capture.record(kind, payload);
+      // Events replace long-polls on a socket
+      handled = exp.op != WAIT_CHANGES && run_get_operation(exp, &result);
+    } else if (kind == WireFrame::POST_REQUEST) {
+      capture.record(kind, payload);
+      {
+        TraceSpan span("parse");
+        parse(payload.c_str(), &exp);
+      }
+      handled = run_post_operation(exp, &result);
+    }
+  } catch (int e) {  // Any other errors are reported as a failure
+    handled = false;
+  }
+
+  if (handled) {
+    send_frame(socket, WireFrame::encode(WireFrame::RESPONSE, id, result));
+    if (kind == WireFrame::POST_REQUEST) publish_changes();
+  } else {
+    send_frame(socket, WireFrame::encode(WireFrame::FAILURE, id,
+                                         "Unknown exp.op value"));
+  }
+  observe(exp, start, handled);
+}
+
+/**
+ * Forgets a WebSocket once it is closed
+ * @param socket the connection
+ */
+void socket_close_handler(const std::shared_ptr<restbed::WebSocket> socket) {
+  sockets.erase(socket->get_key());
+}
+
+/**
+ * Forgets a WebSocket that failed
+ * @param socket the connection
+ * @param error the failure
+ */
+void socket_error_handler(const std::shared_ptr<restbed::WebSocket> socket,
+                          const std::error_code error) {
+  fprintf(stderr, "WebSocket Error: %s\n", error.message().c_str());
+  sockets.erase(socket->get_key());
+}
+
+/**
+ * Upgrades a GET on /issueSocket to a WebSocket and greets the client with
+ * the current version and server epoch
+ * @param session The request session.
+ */
+void socket_method_handler(const std::shared_ptr<restbed::Session>& session) {
+  const auto request = session->get_request();
+  std::string key = request->get_header("Sec-WebSocket-Key", "");
+  if (key.empty()) {  // Plain HTTP request, not an upgrade
+    session->close(restbed::BAD_REQUEST, {ALLOW_ALL, CLOSE_CONNECTION});
+    return;
+  }
+
+  session->upgrade(
+      restbed::SWITCHING_PROTOCOLS,
+      {{"Upgrade", "websocket"},
+       {"Connection", "Upgrade"},
+       {"Sec-WebSocket-Accept", WebSocketCodec::acceptKey(key)}},
+      [](const std::shared_ptr<restbed::WebSocket> socket) {
+        if (!socket->is_open()) return;  // Client went away mid-handshake
+        socket->set_close_handler(socket_close_handler);
+        socket->set_error_handler(socket_error_handler);
+        socket->set_message_handler(socket_message_handler);
+        sockets[socket->get_key()] = socket;
+        send_frame(socket,
+                   WireFrame::encode(WireFrame::HELLO,
+                                     issueTracker->getVersion(), serverEpoch));
+      });
 }
 
 /**
  * POST request callback function.
  * @param session Passes the session through to post_operations
  * @param body The body of the message sent from the client
+ * @param start when the request arrived, before its body was fetched
  */
 void post_request(const std::shared_ptr<restbed::Session>& session,
-                  const restbed::Bytes& body) {
+                  const restbed::Bytes& body,
+                  std::chrono::steady_clock::time_point start) {
   expression exp;
 
   // Converts data to string format
@@ -432,9 +1406,15 @@ void post_request(const std::shared_ptr<restbed::Session>& session,
   // Searches for "/" to mark end of message
   std::string mySub = str.substr(0, str.find("/", 0));
   const char* nData = mySub.c_str();
+  capture.record(WireFrame::POST_REQUEST, mySub);
 
-  parse(nData, &exp);  // Parses the data into separate expression attributes
-  post_operations(exp, session);  // Handles which post operation to execute
+  {
+    TraceSpan span("parse");
+    parse(nData, &exp);  // Parses the data into separate expression fields
+  }
+  bool ok = post_operations(exp, session);  // Executes the post operation
+  publish_changes();  // Tells waiting clients what changed
+  observe(exp, start, ok);
 }
 
 /**
@@ -444,7 +1424,23 @@ void post_request(const std::shared_ptr<restbed::Session>& session,
 void post_method_handler(const std::shared_ptr<restbed::Session>& session) {
   const auto request = session->get_request();
   size_t content_length = request->get_header("Content-Length", 0);
-  session->fetch(content_length, &post_request);
+
+  // Other requests may be handled while the body arrives, so the trace is
+  // carried into the callback rather than left current on the thread
+  auto start = std::chrono::steady_clock::now();
+  uint64_t traced = Tracer::beginRequest();
+  Tracer::endRequest();
+  uint64_t fetchStart = Tracer::now();
+  session->fetch(
+      content_length,
+      [start, traced, fetchStart](
+          const std::shared_ptr<restbed::Session>& session,
+          const restbed::Bytes& body) {
+        Tracer::resumeRequest(traced);
+        Tracer::record("fetch", fetchStart, Tracer::now());
+        AllocStats::beginRequest();  // Receiving the body is not counted
+        post_request(session, body, start);
+      });
 }
 
 /**
@@ -452,48 +1448,330 @@ void post_method_handler(const std::shared_ptr<restbed::Session>& session) {
  * @param session The request session.
  */
 void get_method_handler(const std::shared_ptr<restbed::Session>& session) {
+  auto start = std::chrono::steady_clock::now();
+  Tracer::beginRequest();
+  AllocStats::beginRequest();
   const auto request = session->get_request();
+  const auto query = request->get_query_parameters();
 
   expression exp;
-  exp.op = UNKNOWN;
-  exp.type = UNKNOWN;
-  exp.title = UNKNOWN;
-  exp.username = UNKNOWN;
+  {
+    TraceSpan span("parse");
+    parse_get(std::map<std::string, std::string>(query.begin(), query.end()),
+              &exp);
+  }
+  if (exp.op == WAIT_CHANGES) {
+    Tracer::endRequest();
+    wait_for_changes(exp, session);  // Parks the session until a change
+    return;
+  }
+  if (capture.isOpen()) {  // Recorded in the form sockets send
+    capture.record(WireFrame::GET_REQUEST,
+                   WireFrame::encodeParams(
+                       std::vector<std::pair<std::string, std::string>>(
+                           query.begin(), query.end())));
+  }
+  bool ok = get_operations(exp, session);  // Executes get operations
+  observe(exp, start, ok);
+}
 
-  if (request->has_query_parameter("op")) {
-    // Sets exp.op value
-    set_operation(&exp, request->get_query_parameter("op").c_str());
-    if (request->has_query_parameter("title")) {
-      // Sets exp.title as title sent from client
-      exp.title = request->get_query_parameter("title");
-    } else if (request->has_query_parameter("user")) {
-      // Sets exp.username as username sent from client
-      exp.username = request->get_query_parameter("user");
-    }
+/**
+ * Handle a GET on /trace with the spans of recently traced requests as
+ * Chrome trace-event JSON, for chrome://tracing or Perfetto. ?sample=N
+ * first changes tracing to one request in every N, 0 to stop.
+ * @param session The request session.
+ */
+void trace_method_handler(const std::shared_ptr<restbed::Session>& session) {
+  const auto request = session->get_request();
+  if (request->has_query_parameter("sample")) {
+    Tracer::setSampling(
+        strtoul(request->get_query_parameter("sample").c_str(), NULL, 10));
+  }
+  std::string body = Tracer::dump();
+  session->close(restbed::OK, body,
+                 {ALLOW_ALL,
+                  {"Content-Type", "application/json"},
+                  {"Content-Length", std::to_string(body.length())},
+                  CLOSE_CONNECTION});
+}
+
+/**
+ * Handle a GET on /metrics with the request metrics, the size of the
+ * store, what writing it has cost and the memory in use, in the
+ * Prometheus text format.
+ * @param session The request session.
+ */
+void metrics_method_handler(
+    const std::shared_ptr<restbed::Session>& session) {
+  std::string body = metrics.format();
+  StoreStats store = issueTracker->getStoreStats();
+  Metrics::append(&body, "issueserver_issues", "gauge", "Issues stored.",
+                  store.issues);
+  Metrics::append(&body, "issueserver_users", "gauge", "Users stored.",
+                  store.users);
+  Metrics::append(&body, "issueserver_comments", "gauge",
+                  "Comments stored.", store.comments);
+  Metrics::append(&body, "issueserver_store_writes_total", "counter",
+                  "Times the store was written to disk.", store.writes);
+  Metrics::append(&body, "issueserver_store_write_seconds_total", "counter",
+                  "Time spent writing the store.", store.writeMicros / 1e6);
+  Metrics::append(&body, "issueserver_store_write_bytes_total", "counter",
+                  "Bytes written to the store files.", store.writeBytes);
+  Metrics::append(&body, "issueserver_version", "gauge",
+                  "Mutations committed since startup.",
+                  issueTracker->getVersion());
+  Metrics::append(&body, "issueserver_slow_requests_total", "counter",
+                  "Requests written to the slow log.", slowLog.getLogged());
+  Metrics::append(&body, "issueserver_slow_requests_dropped_total",
+                  "counter", "Slow requests not logged as the log fell "
+                  "behind.", slowLog.getDropped());
+  Metrics::append(&body, "process_resident_memory_bytes", "gauge",
+                  "Resident memory size in bytes.",
+                  Metrics::residentBytes());
+  session->close(restbed::OK, body,
+                 {ALLOW_ALL,
+                  {"Content-Type", "text/plain; version=0.0.4"},
+                  {"Content-Length", std::to_string(body.length())},
+                  CLOSE_CONNECTION});
+}
+
+/**
+ * Tracker figures from the last /memory request and the version they were
+ * taken at. Taking them walks every issue and index, which would hold up
+ * every other request on a large store if each scrape did it.
+ */
+MemoryStats memoryReport;
+uint64_t memoryVersion = 0;
+bool memoryReported = false;
+
+/**
+ * Handle a GET on /memory with where the server's memory goes, as JSON:
+ * the approximate bytes held by the issues, comments, users, lists,
+ * each index, the change feed and the response cache, the average bytes
+ * per issue, comment and user, and the state of the malloc heap. The
+ * tracker's figures are only taken again after a write.
+ * @param session The request session.
+ */
+void memory_method_handler(const std::shared_ptr<restbed::Session>& session) {
+  StoreStats store = issueTracker->getStoreStats();
+  uint64_t version = issueTracker->getVersion();
+  if (!memoryReported || version != memoryVersion) {
+    memoryReport = issueTracker->getMemoryStats();
+    memoryVersion = version;
+    memoryReported = true;
+  }
+  const MemoryStats& memory = memoryReport;
+  nlohmann::json indexes = nlohmann::json::object();
+  uint64_t indexTotal = 0;
+  for (const auto& index : memory.indexBytes) {
+    indexes[index.first] = index.second;
+    indexTotal += index.second;
   }
-  get_operations(exp, session);  // Executes get operations
+  nlohmann::json bytes;
+  bytes["issues"] = memory.issueBytes;
+  bytes["comments"] = memory.commentBytes;
+  bytes["users"] = memory.userBytes;
+  bytes["lists"] = memory.listBytes;
+  bytes["indexes"] = indexTotal;
+  bytes["changes"] = memory.changeBytes;
+  bytes["response_cache"] = responseCache.bytes();
+  uint64_t total = 0;
+  for (const auto& part : bytes.items()) total += part.value().get<uint64_t>();
+
+  auto average = [](uint64_t used, uint64_t count) {
+    return count == 0 ? 0.0 : static_cast<double>(used) / count;
+  };
+  nlohmann::json report;
+  report["resident_bytes"] = Metrics::residentBytes();
+  report["accounted_bytes"] = total;
+  report["bytes"] = bytes;
+  report["indexes"] = indexes;
+  report["counts"] = {{"issues", store.issues},
+                      {"comments", store.comments},
+                      {"users", store.users}};
+  report["bytes_per_item"] = {
+      {"issue", average(memory.issueBytes, store.issues)},
+      {"comment", average(memory.commentBytes, store.comments)},
+      {"user", average(memory.userBytes, store.users)}};
+  Metrics::HeapStats heap;
+  if (Metrics::heapStats(&heap)) {
+    // Free bytes held in the arenas, out of what malloc took from the system
+    report["heap"] = {
+        {"arenas", heap.arenas},
+        {"system_bytes", heap.systemBytes},
+        {"max_system_bytes", heap.maxSystemBytes},
+        {"in_use_bytes", heap.systemBytes - heap.freeBytes},
+        {"free_bytes", heap.freeBytes},
+        {"free_chunks", heap.freeChunks},
+        {"mmap_bytes", heap.mmapBytes},
+        {"mmap_chunks", heap.mmapChunks},
+        {"fragmentation",
+         static_cast<double>(heap.freeBytes) / heap.systemBytes}};
+  }
+
+  std::string body = report.dump();
+  session->close(restbed::OK, body,
+                 {ALLOW_ALL,
+                  {"Content-Type", "application/json"},
+                  {"Content-Length", std::to_string(body.length())},
+                  CLOSE_CONNECTION});
 }
 
-int main(const int, const char**) {
+/**
+ * Handle a GET on /profile by sampling where the server spends CPU time
+ * for ?seconds=N (10 by default, at most 60) at ?hz=N samples a second
+ * (99 by default), then responding with the folded stacks, ready for
+ * flamegraph.pl or speedscope. One profile runs at a time.
+ * @param session The request session.
+ */
+void profile_method_handler(
+    const std::shared_ptr<restbed::Session>& session) {
+  const auto request = session->get_request();
+  uint64_t seconds = request->get_query_parameter("seconds", 10);
+  int hz = request->get_query_parameter("hz", 99);
+  if (seconds == 0 || seconds > 60 || hz < 1 || hz > 1000) {
+    session->close(restbed::BAD_REQUEST, {ALLOW_ALL, CLOSE_CONNECTION});
+    return;
+  }
+
+  // Enough for every core to be busy throughout, within 64k samples
+  uint64_t cores = std::thread::hardware_concurrency();
+  uint64_t capacity = seconds * hz * (cores == 0 ? 1 : cores);
+  if (!Profiler::start(hz, capacity < 65536 ? capacity : 65536)) {
+    std::string body = "A profile is already running\n";
+    session->close(restbed::CONFLICT, body,
+                   {ALLOW_ALL,
+                    {"Content-Length", std::to_string(body.length())},
+                    CLOSE_CONNECTION});
+    return;
+  }
+  session->sleep_for(
+      std::chrono::seconds(seconds),
+      [](const std::shared_ptr<restbed::Session> session) {
+        std::string body = Profiler::stop();
+        if (session->is_closed()) return;  // Client gave up
+        session->close(
+            restbed::OK, body,
+            {ALLOW_ALL,
+             {"Content-Type", "text/plain"},
+             {"Content-Length", std::to_string(body.length())},
+             {"X-Dropped-Samples", std::to_string(Profiler::dropped())},
+             CLOSE_CONNECTION});
+      });
+}
+
+/**
+ * Writes captured requests out regularly, since the server is usually
+ * stopped by a signal
+ */
+void flush_capture() { capture.flush(); }
+
+/**
+ * Seconds between checks for a search index to save
+ */
+const int INDEX_SAVE_INTERVAL = 60;
+
+/**
+ * Saves the search index if the store changed, so a restart after a signal
+ * can load it instead of re-indexing every issue
+ */
+void save_index() { issueTracker->saveIndex(); }
+
+int main(const int argc, const char** argv) {
   // Setup service and request handlers
   auto resource = std::make_shared<restbed::Resource>();
   resource->set_path("/issueServer");
 
+  // --capture=FILE records every request for replaying with issueLoad,
+  // --trace-sample=N traces one request in every N for /trace,
+  // --slow-log=FILE logs requests slower than --slow-ms (100 by default),
+  // --alloc-stats counts the heap allocations of each operation
+  std::string slowPath;
+  uint64_t slowMs = 100;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--alloc-stats") {
+      AllocStats::setEnabled(true);
+    } else if (arg.compare(0, 15, "--trace-sample=") == 0) {
+      Tracer::setSampling(strtoul(arg.c_str() + 15, NULL, 10));
+    } else if (arg.compare(0, 11, "--slow-log=") == 0) {
+      slowPath = arg.substr(11);
+    } else if (arg.compare(0, 10, "--slow-ms=") == 0) {
+      slowMs = strtoull(arg.c_str() + 10, NULL, 10);
+    } else if (arg.compare(0, 10, "--capture=") != 0) {
+      fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return EXIT_FAILURE;
+    } else if (!capture.open(arg.substr(10))) {
+      fprintf(stderr, "Cannot write %s\n", arg.c_str() + 10);
+      return EXIT_FAILURE;
+    }
+  }
+  if (!slowPath.empty()) {
+    // Times the phases of every request, in case it turns out slow
+    if (!slowLog.open(slowPath, slowMs * 1000)) {
+      fprintf(stderr, "Cannot write %s\n", slowPath.c_str());
+      return EXIT_FAILURE;
+    }
+    logSlow = true;
+    slowMicros = slowLog.getThreshold();
+    Tracer::setPhaseTiming(true);
+  }
+
   // Initialize:
+  serverEpoch = std::to_string(time(NULL));
   issueTracker = new IssueTracker();
   issueTracker->readFile();
 
   resource->set_method_handler("POST", post_method_handler);
   resource->set_method_handler("GET", get_method_handler);
 
+  // Persistent WebSocket channel for clients that support it
+  auto socketResource = std::make_shared<restbed::Resource>();
+  socketResource->set_path("/issueSocket");
+  socketResource->set_method_handler("GET", socket_method_handler);
+
+  // Request and store metrics for Prometheus to scrape
+  auto metricsResource = std::make_shared<restbed::Resource>();
+  metricsResource->set_path("/metrics");
+  metricsResource->set_method_handler("GET", metrics_method_handler);
+
+  // Spans of sampled requests, for finding where slow ones spend time
+  auto traceResource = std::make_shared<restbed::Resource>();
+  traceResource->set_path("/trace");
+  traceResource->set_method_handler("GET", trace_method_handler);
+
+  // Where the server's memory goes
+  auto memoryResource = std::make_shared<restbed::Resource>();
+  memoryResource->set_path("/memory");
+  memoryResource->set_method_handler("GET", memory_method_handler);
+
+  // CPU profile on demand, since outside profilers cannot be attached
+  auto profileResource = std::make_shared<restbed::Resource>();
+  profileResource->set_path("/profile");
+  profileResource->set_method_handler("GET", profile_method_handler);
+
   auto settings = std::make_shared<restbed::Settings>();
   settings->set_port(1234);
 
   // Publish and start service
   restbed::Service service;
   service.publish(resource);
+  service.publish(socketResource);
+  service.publish(metricsResource);
+  service.publish(traceResource);
+  service.publish(memoryResource);
+  service.publish(profileResource);
+  service.schedule(expire_waiters, std::chrono::seconds(1));
+  service.schedule(save_index, std::chrono::seconds(INDEX_SAVE_INTERVAL));
+  if (capture.isOpen()) {
+    service.schedule(flush_capture, std::chrono::seconds(1));
+  }
   service.start(settings);
 
+  capture.close();
+  slowLog.close();
+  issueTracker->saveIndex();
+
   // Cleanup any memory leaks
   issueTracker->memoryCleanIssues();
   delete issueTracker;
@@ -0,0 +1,170 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "ActivityRank.h"
+
+#include <cmath>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * Half-lives a comment may lie past the landmark before it is moved. Weights
+ * then stay below 2^64, far from overflowing a double.
+ */
+static const double MAX_HALF_LIVES = 64;
+
+/**
+ * @param halfLife seconds after which a comment counts half as much
+ */
+ActivityRank::ActivityRank(double halfLife)
+    : halfLife(halfLife), landmark(0) {}
+
+/**
+ * Records comments on an issue, adding the issue if it is new
+ * @param id issue id
+ * @param now time of the comments, in seconds
+ * @param comments number of comments made
+ */
+void ActivityRank::record(uint64_t id, double now, double comments) {
+  if (heap.empty()) landmark = now;
+  if ((now - landmark) / halfLife > MAX_HALF_LIVES) rebase(now);
+  double weight = comments * std::exp2((now - landmark) / halfLife);
+
+  auto found = positions.find(id);
+  if (found == positions.end()) {
+    positions[id] = heap.size();
+    heap.push_back({id, weight});
+    siftUp(heap.size() - 1);
+  } else {
+    heap[found->second].score += weight;  // Scores only grow here
+    siftUp(found->second);
+  }
+}
+
+/**
+ * Removes an issue
+ * @param id issue id
+ */
+void ActivityRank::remove(uint64_t id) {
+  auto found = positions.find(id);
+  if (found == positions.end()) return;
+  size_t at = found->second;
+  swapEntries(at, heap.size() - 1);
+  heap.pop_back();
+  positions.erase(id);
+  if (at < heap.size()) {  // The moved entry may belong on either side
+    siftUp(at);
+    siftDown(at);
+  }
+}
+
+/**
+ * Gets the most active issues, visiting only the top of the heap
+ * @param k most issues returned
+ * @param now current time, in seconds
+ * @return issue ids and their scores as of now, hottest first
+ */
+std::vector<std::pair<uint64_t, double>> ActivityRank::top(size_t k,
+                                                          double now) {
+  std::vector<std::pair<uint64_t, double>> result;
+  double decay = std::exp2((landmark - now) / halfLife);
+  // Frontier of heap positions whose parents were already taken
+  std::priority_queue<std::pair<double, size_t>> frontier;
+  if (!heap.empty()) frontier.push(std::make_pair(heap[0].score, 0));
+  while (!frontier.empty() && result.size() < k) {
+    size_t at = frontier.top().second;
+    frontier.pop();
+    result.push_back(std::make_pair(heap[at].id, heap[at].score * decay));
+    for (size_t child = 2 * at + 1; child <= 2 * at + 2; child++) {
+      if (child < heap.size()) {
+        frontier.push(std::make_pair(heap[child].score, child));
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * Gets the number of ranked issues
+ * @return number of issues
+ */
+size_t ActivityRank::size() { return heap.size(); }
+
+/**
+ * Gets the approximate memory held by the ranking
+ * @return bytes used by the heap and the position map
+ */
+size_t ActivityRank::bytes() {
+  return heap.capacity() * sizeof(Entry) +
+         positions.bucket_count() * sizeof(void*) +
+         positions.size() * (sizeof(uint64_t) + sizeof(size_t) +
+                             sizeof(void*));
+}
+
+/**
+ * Removes every issue
+ */
+void ActivityRank::clear() {
+  heap.clear();
+  positions.clear();
+}
+
+/**
+ * Moves a heap entry towards the root while it outranks its parent
+ * @param at heap position
+ */
+void ActivityRank::siftUp(size_t at) {
+  while (at > 0) {
+    size_t parent = (at - 1) / 2;
+    if (heap[parent].score >= heap[at].score) break;
+    swapEntries(at, parent);
+    at = parent;
+  }
+}
+
+/**
+ * Moves a heap entry towards the leaves while a child outranks it
+ * @param at heap position
+ */
+void ActivityRank::siftDown(size_t at) {
+  while (true) {
+    size_t largest = at;
+    size_t left = 2 * at + 1;
+    size_t right = left + 1;
+    if (left < heap.size() && heap[left].score > heap[largest].score) {
+      largest = left;
+    }
+    if (right < heap.size() && heap[right].score > heap[largest].score) {
+      largest = right;
+    }
+    if (largest == at) break;
+    swapEntries(at, largest);
+    at = largest;
+  }
+}
+
+/**
+ * Swaps two heap entries and their positions
+ * @param a heap position
+ * @param b heap position
+ */
+void ActivityRank::swapEntries(size_t a, size_t b) {
+  std::swap(heap[a], heap[b]);
+  positions[heap[a].id] = a;
+  positions[heap[b].id] = b;
+}
+
+/**
+ * Moves the landmark to a time, scaling every score to match, before the
+ * weights of new comments grow too large for a double
+ * @param now new landmark
+ */
+void ActivityRank::rebase(double now) {
+  // Every score shrinks by the same factor, so the heap stays ordered
+  double scale = std::exp2((landmark - now) / halfLife);
+  for (size_t i = 0; i < heap.size(); i++) heap[i].score *= scale;
+  landmark = now;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "AllocStats.h"
+
+#include <atomic>
+
+static std::atomic<bool> counting(false);
+
+/**
+ * The calling thread's counts, and what they were when its current
+ * request began. Plain data, so operator new can use them before the
+ * thread has set anything else up.
+ */
+static thread_local AllocStats::Counts threadCounts = {0, 0};
+static thread_local AllocStats::Counts requestStart = {0, 0};
+
+/**
+ * Turns counting on or off
+ * @param on whether record counts allocations
+ */
+void AllocStats::setEnabled(bool on) { counting = on; }
+
+/**
+ * Checks whether allocations are counted
+ * @return true if counting is on
+ */
+bool AllocStats::enabled() {
+  return counting.load(std::memory_order_relaxed);
+}
+
+/**
+ * Counts one allocation on the calling thread, if counting is on; called
+ * from operator new, so it must not allocate
+ * @param size bytes requested
+ */
+void AllocStats::record(size_t size) {
+  if (!counting.load(std::memory_order_relaxed)) return;
+  threadCounts.allocations++;
+  threadCounts.bytes += size;
+}
+
+/**
+ * Gets what the calling thread has allocated
+ * @return counts since the thread started
+ */
+AllocStats::Counts AllocStats::thread() { return threadCounts; }
+
+/**
+ * Starts charging the calling thread's allocations to a new request
+ */
+void AllocStats::beginRequest() { requestStart = threadCounts; }
+
+/**
+ * Gets what the calling thread allocated for its current request
+ * @return counts since beginRequest
+ */
+AllocStats::Counts AllocStats::request() {
+  Counts counts = {threadCounts.allocations - requestStart.allocations,
+                   threadCounts.bytes - requestStart.bytes};
+  return counts;
+}
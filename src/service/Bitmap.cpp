@@ -0,0 +1,462 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "Bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * Most values an array container holds before it becomes a bitset. At this
+ * size both forms take 8KB.
+ */
+static const uint32_t ARRAY_MAX = 4096;
+
+/**
+ * Number of 64 bit words in a bitset container
+ */
+static const size_t WORDS = 1024;
+
+/**
+ * Counts the set bits of a word. Written out rather than calling
+ * __builtin_popcountll, which is a library call unless the build targets a
+ * CPU with a popcount instruction; this form also vectorizes in loops.
+ * @param bits the word
+ * @return number of bits set
+ */
+static inline uint64_t popcount(uint64_t bits) {
+  bits -= (bits >> 1) & 0x5555555555555555ULL;
+  bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+  bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (bits * 0x0101010101010101ULL) >> 56;
+}
+
+/**
+ * Adds an id
+ * @param value the id
+ */
+void Bitmap::add(uint32_t value) {
+  uint16_t key = value >> 16;
+  uint16_t low = value & 0xFFFF;
+  size_t at = position(key);
+  if (at == containers.size() || containers[at].key != key) {
+    Container fresh;
+    fresh.key = key;
+    fresh.count = 0;
+    containers.insert(containers.begin() + at, fresh);
+  }
+
+  Container& c = containers[at];
+  if (c.words.empty()) {
+    auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+    if (pos != c.array.end() && *pos == low) return;
+    c.array.insert(pos, low);
+    c.count++;
+    if (c.count > ARRAY_MAX) toWords(&c);
+  } else {
+    uint64_t bit = uint64_t(1) << (low & 63);
+    if (c.words[low >> 6] & bit) return;
+    c.words[low >> 6] |= bit;
+    c.count++;
+  }
+}
+
+/**
+ * Removes an id
+ * @param value the id
+ */
+void Bitmap::remove(uint32_t value) {
+  uint16_t key = value >> 16;
+  uint16_t low = value & 0xFFFF;
+  size_t at = position(key);
+  if (at == containers.size() || containers[at].key != key) return;
+
+  Container& c = containers[at];
+  if (c.words.empty()) {
+    auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+    if (pos == c.array.end() || *pos != low) return;
+    c.array.erase(pos);
+    c.count--;
+  } else {
+    uint64_t bit = uint64_t(1) << (low & 63);
+    if (!(c.words[low >> 6] & bit)) return;
+    c.words[low >> 6] &= ~bit;
+    c.count--;
+    if (c.count <= ARRAY_MAX) toArray(&c);
+  }
+  if (c.count == 0) containers.erase(containers.begin() + at);
+}
+
+/**
+ * Checks whether an id is in the set
+ * @param value the id
+ * @return true if the id was added
+ */
+bool Bitmap::contains(uint32_t value) const {
+  size_t at = position(value >> 16);
+  if (at == containers.size() || containers[at].key != value >> 16) {
+    return false;
+  }
+  return has(containers[at], value & 0xFFFF);
+}
+
+/**
+ * Gets the number of ids
+ * @return number of ids in the set
+ */
+uint64_t Bitmap::cardinality() const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < containers.size(); i++) total += containers[i].count;
+  return total;
+}
+
+/**
+ * Checks whether the set has no ids
+ * @return true if the set is empty
+ */
+bool Bitmap::empty() const { return containers.empty(); }
+
+/**
+ * Gets every id
+ * @return the ids in increasing order
+ */
+std::vector<uint32_t> Bitmap::values() const {
+  std::vector<uint32_t> result;
+  result.reserve(cardinality());
+  for (size_t i = 0; i < containers.size(); i++) {
+    const Container& c = containers[i];
+    uint32_t high = uint32_t(c.key) << 16;
+    if (c.words.empty()) {
+      for (size_t j = 0; j < c.array.size(); j++) {
+        result.push_back(high | c.array[j]);
+      }
+    } else {
+      for (size_t w = 0; w < WORDS; w++) {
+        for (uint64_t bits = c.words[w]; bits; bits &= bits - 1) {
+          result.push_back(high | (w << 6) | __builtin_ctzll(bits));
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * Gets the ids in both sets (AND)
+ * @param a first set
+ * @param b second set
+ * @return the intersection
+ */
+Bitmap Bitmap::intersect(const Bitmap& a, const Bitmap& b) {
+  Bitmap result;
+  size_t i = 0, j = 0;
+  while (i < a.containers.size() && j < b.containers.size()) {
+    if (a.containers[i].key < b.containers[j].key) {
+      i++;
+    } else if (b.containers[j].key < a.containers[i].key) {
+      j++;
+    } else {
+      Container c = intersectContainers(a.containers[i++], b.containers[j++]);
+      if (c.count > 0) result.containers.push_back(std::move(c));
+    }
+  }
+  return result;
+}
+
+/**
+ * Gets the ids in either set (OR)
+ * @param a first set
+ * @param b second set
+ * @return the union
+ */
+Bitmap Bitmap::unite(const Bitmap& a, const Bitmap& b) {
+  Bitmap result;
+  size_t i = 0, j = 0;
+  while (i < a.containers.size() || j < b.containers.size()) {
+    if (j == b.containers.size() ||
+        (i < a.containers.size() &&
+         a.containers[i].key < b.containers[j].key)) {
+      result.containers.push_back(a.containers[i++]);
+    } else if (i == a.containers.size() ||
+               b.containers[j].key < a.containers[i].key) {
+      result.containers.push_back(b.containers[j++]);
+    } else {
+      result.containers.push_back(
+          uniteContainers(a.containers[i++], b.containers[j++]));
+    }
+  }
+  return result;
+}
+
+/**
+ * Gets the ids in the first set but not the second (AND NOT)
+ * @param a first set
+ * @param b second set
+ * @return the difference
+ */
+Bitmap Bitmap::subtract(const Bitmap& a, const Bitmap& b) {
+  Bitmap result;
+  size_t j = 0;
+  for (size_t i = 0; i < a.containers.size(); i++) {
+    while (j < b.containers.size() &&
+           b.containers[j].key < a.containers[i].key) {
+      j++;
+    }
+    if (j == b.containers.size() ||
+        b.containers[j].key != a.containers[i].key) {
+      result.containers.push_back(a.containers[i]);
+    } else {
+      Container c = subtractContainers(a.containers[i], b.containers[j]);
+      if (c.count > 0) result.containers.push_back(std::move(c));
+    }
+  }
+  return result;
+}
+
+/**
+ * Counts the ids in both sets without building the intersection
+ * @param a first set
+ * @param b second set
+ * @return size of the intersection
+ */
+uint64_t Bitmap::intersectCount(const Bitmap& a, const Bitmap& b) {
+  uint64_t total = 0;
+  size_t i = 0, j = 0;
+  while (i < a.containers.size() && j < b.containers.size()) {
+    if (a.containers[i].key < b.containers[j].key) {
+      i++;
+    } else if (b.containers[j].key < a.containers[i].key) {
+      j++;
+    } else {
+      total += intersectCountContainers(a.containers[i++], b.containers[j++]);
+    }
+  }
+  return total;
+}
+
+/**
+ * Gets the approximate memory held by the set
+ * @return bytes used by the containers
+ */
+size_t Bitmap::bytes() const {
+  size_t used = containers.capacity() * sizeof(Container);
+  for (size_t i = 0; i < containers.size(); i++) {
+    used += containers[i].array.capacity() * sizeof(uint16_t) +
+            containers[i].words.capacity() * sizeof(uint64_t);
+  }
+  return used;
+}
+
+/**
+ * Removes every id
+ */
+void Bitmap::clear() { containers.clear(); }
+
+/**
+ * Turns an array container into a bitset
+ * @param c the container
+ */
+void Bitmap::toWords(Container* c) {
+  c->words.assign(WORDS, 0);
+  for (size_t i = 0; i < c->array.size(); i++) {
+    c->words[c->array[i] >> 6] |= uint64_t(1) << (c->array[i] & 63);
+  }
+  std::vector<uint16_t>().swap(c->array);
+}
+
+/**
+ * Turns a bitset container into an array
+ * @param c the container
+ */
+void Bitmap::toArray(Container* c) {
+  c->array.clear();
+  c->array.reserve(c->count);
+  for (size_t w = 0; w < WORDS; w++) {
+    for (uint64_t bits = c->words[w]; bits; bits &= bits - 1) {
+      c->array.push_back((w << 6) | __builtin_ctzll(bits));
+    }
+  }
+  std::vector<uint64_t>().swap(c->words);
+}
+
+/**
+ * Counts the values of a bitset container
+ * @param c the container
+ */
+void Bitmap::recount(Container* c) {
+  c->count = 0;
+  for (size_t w = 0; w < WORDS; w++) c->count += popcount(c->words[w]);
+}
+
+/**
+ * Checks whether a container holds a low 16 bit value
+ * @param c the container
+ * @param low the value
+ * @return true if the value is in the container
+ */
+bool Bitmap::has(const Container& c, uint16_t low) {
+  if (!c.words.empty()) return (c.words[low >> 6] >> (low & 63)) & 1;
+  return std::binary_search(c.array.begin(), c.array.end(), low);
+}
+
+/**
+ * Intersects two containers with the same key
+ * @param a first container
+ * @param b second container
+ * @return the intersection, possibly empty
+ */
+Bitmap::Container Bitmap::intersectContainers(const Container& a,
+                                              const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (a.words.empty() && b.words.empty()) {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                          b.array.end(), std::back_inserter(result.array));
+    result.count = result.array.size();
+  } else if (a.words.empty() || b.words.empty()) {
+    const Container& sparse = a.words.empty() ? a : b;
+    const Container& dense = a.words.empty() ? b : a;
+    // Every value is written and kept only if the bitset has it, which
+    // avoids a hard to predict branch per value
+    result.array.resize(sparse.array.size());
+    size_t kept = 0;
+    for (size_t i = 0; i < sparse.array.size(); i++) {
+      result.array[kept] = sparse.array[i];
+      kept += has(dense, sparse.array[i]);
+    }
+    result.array.resize(kept);
+    result.count = kept;
+  } else {
+    result.words.resize(WORDS);
+    for (size_t w = 0; w < WORDS; w++) {
+      result.words[w] = a.words[w] & b.words[w];
+    }
+    recount(&result);  // Stays a bitset, see the class comment
+  }
+  return result;
+}
+
+/**
+ * Unites two containers with the same key
+ * @param a first container
+ * @param b second container
+ * @return the union
+ */
+Bitmap::Container Bitmap::uniteContainers(const Container& a,
+                                          const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (a.words.empty() && b.words.empty()) {
+    std::set_union(a.array.begin(), a.array.end(), b.array.begin(),
+                   b.array.end(), std::back_inserter(result.array));
+    result.count = result.array.size();
+    if (result.count > ARRAY_MAX) toWords(&result);
+    return result;
+  }
+
+  const Container& dense = a.words.empty() ? b : a;
+  const Container& other = a.words.empty() ? a : b;
+  result.words = dense.words;
+  if (other.words.empty()) {
+    for (size_t i = 0; i < other.array.size(); i++) {
+      result.words[other.array[i] >> 6] |= uint64_t(1)
+                                           << (other.array[i] & 63);
+    }
+  } else {
+    for (size_t w = 0; w < WORDS; w++) result.words[w] |= other.words[w];
+  }
+  recount(&result);
+  return result;
+}
+
+/**
+ * Subtracts one container from another with the same key
+ * @param a first container
+ * @param b container whose values are removed
+ * @return the difference, possibly empty
+ */
+Bitmap::Container Bitmap::subtractContainers(const Container& a,
+                                             const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (a.words.empty()) {
+    result.array.resize(a.array.size());
+    size_t kept = 0;
+    for (size_t i = 0; i < a.array.size(); i++) {
+      result.array[kept] = a.array[i];
+      kept += !has(b, a.array[i]);  // Branch free, as in intersect
+    }
+    result.array.resize(kept);
+    result.count = kept;
+    return result;
+  }
+
+  result.words = a.words;
+  if (b.words.empty()) {
+    for (size_t i = 0; i < b.array.size(); i++) {
+      result.words[b.array[i] >> 6] &= ~(uint64_t(1) << (b.array[i] & 63));
+    }
+  } else {
+    for (size_t w = 0; w < WORDS; w++) result.words[w] &= ~b.words[w];
+  }
+  recount(&result);
+  return result;
+}
+
+/**
+ * Counts the values two containers with the same key share
+ * @param a first container
+ * @param b second container
+ * @return size of their intersection
+ */
+uint64_t Bitmap::intersectCountContainers(const Container& a,
+                                          const Container& b) {
+  uint64_t total = 0;
+  if (a.words.empty() && b.words.empty()) {
+    size_t i = 0, j = 0;
+    while (i < a.array.size() && j < b.array.size()) {
+      if (a.array[i] < b.array[j]) {
+        i++;
+      } else if (b.array[j] < a.array[i]) {
+        j++;
+      } else {
+        total++;
+        i++;
+        j++;
+      }
+    }
+  } else if (a.words.empty() || b.words.empty()) {
+    const Container& sparse = a.words.empty() ? a : b;
+    const Container& dense = a.words.empty() ? b : a;
+    for (size_t i = 0; i < sparse.array.size(); i++) {
+      total += has(dense, sparse.array[i]);
+    }
+  } else {
+    for (size_t w = 0; w < WORDS; w++) {
+      total += popcount(a.words[w] & b.words[w]);
+    }
+  }
+  return total;
+}
+
+/**
+ * Finds where the container for a key is or would be
+ * @param key high 16 bits of an id
+ * @return index of the first container whose key is not less than key
+ */
+size_t Bitmap::position(uint16_t key) const {
+  size_t low = 0, high = containers.size();
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    if (containers[mid].key < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
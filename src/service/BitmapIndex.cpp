@@ -0,0 +1,82 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "BitmapIndex.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * Adds an issue to a facet
+ * @param key the facet
+ * @param id issue id
+ */
+void BitmapIndex::add(const std::string& key, uint32_t id) {
+  facets[key].add(id);
+}
+
+/**
+ * Removes an issue from a facet
+ * @param key the facet
+ * @param id issue id
+ */
+void BitmapIndex::remove(const std::string& key, uint32_t id) {
+  auto found = facets.find(key);
+  if (found == facets.end()) return;
+  found->second.remove(id);
+  if (found->second.empty()) facets.erase(found);  // Drop unused facets
+}
+
+/**
+ * Gets the issues with a facet
+ * @param key the facet
+ * @return the issue ids, empty if no issue has the facet
+ */
+const Bitmap& BitmapIndex::get(const std::string& key) const {
+  static const Bitmap none;
+  auto found = facets.find(key);
+  return found == facets.end() ? none : found->second;
+}
+
+/**
+ * Counts the issues of a set that have each facet
+ * @param within the issue ids counted
+ * @return each facet with a non-zero count, in key order
+ */
+std::vector<std::pair<std::string, uint64_t>> BitmapIndex::counts(
+    const Bitmap& within) const {
+  std::vector<std::pair<std::string, uint64_t>> result;
+  for (auto it = facets.begin(); it != facets.end(); ++it) {
+    uint64_t count = Bitmap::intersectCount(it->second, within);
+    if (count > 0) result.push_back(std::make_pair(it->first, count));
+  }
+  return result;
+}
+
+/**
+ * Gets the number of facets that have at least one issue
+ * @return number of facets
+ */
+size_t BitmapIndex::size() const { return facets.size(); }
+
+/**
+ * Gets the approximate memory held by the index
+ * @return bytes used by the keys and bitmaps
+ */
+size_t BitmapIndex::bytes() const {
+  size_t used = 0;
+  for (auto it = facets.begin(); it != facets.end(); ++it) {
+    used += sizeof(*it) + StringBytes::heap(it->first) + it->second.bytes();
+  }
+  return used;
+}
+
+/**
+ * Removes every facet
+ */
+void BitmapIndex::clear() { facets.clear(); }
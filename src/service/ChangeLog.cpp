@@ -0,0 +1,75 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "ChangeLog.h"
+
+#include <string>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * Constructor for ChangeLog
+ * @param cap number of recent changes kept in memory
+ */
+ChangeLog::ChangeLog(size_t cap) : ring(cap == 0 ? 1 : cap), latest(0) {}
+
+/**
+ * Records a change and assigns it the next sequence number
+ * @param kind kind of change
+ * @param key issue title or username the change applies to
+ * @return sequence number of the change
+ */
+uint64_t ChangeLog::record(const std::string& kind, const std::string& key) {
+  latest++;
+  Change& slot = ring[latest % ring.size()];  // Overwrites the oldest change
+  slot.seq = latest;
+  slot.kind = kind;
+  slot.key = key;
+  return latest;
+}
+
+/**
+ * Gets the sequence number of the latest change
+ * @return latest sequence number, 0 if nothing changed yet
+ */
+uint64_t ChangeLog::getVersion() { return latest; }
+
+/**
+ * Checks whether every change after a version is still held in the ring
+ * @param since version the caller has already seen
+ * @return true if the deltas since that version are available
+ */
+bool ChangeLog::covers(uint64_t since) {
+  // Versions from the future (e.g. a previous server run) are never covered
+  return since <= latest && latest - since <= ring.size();
+}
+
+/**
+ * Gets the changes made after a version, oldest first
+ * @param since version the caller has already seen
+ * @return the changes, empty if since is current or not covered
+ */
+std::vector<Change> ChangeLog::since(uint64_t since) {
+  std::vector<Change> result;
+  if (!covers(since)) return result;
+  result.reserve(latest - since);
+  for (uint64_t seq = since + 1; seq <= latest; seq++) {
+    result.push_back(ring[seq % ring.size()]);
+  }
+  return result;
+}
+
+/**
+ * Gets the approximate memory held by the log
+ * @return bytes used by the ring and the changes in it
+ */
+size_t ChangeLog::bytes() {
+  size_t used = ring.capacity() * sizeof(Change);
+  for (size_t i = 0; i < ring.size(); i++) {
+    used += StringBytes::heap(ring[i].kind) + StringBytes::heap(ring[i].key);
+  }
+  return used;
+}
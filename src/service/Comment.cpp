@@ -6,6 +6,9 @@
 #include "Comment.h"
 
 #include <string>
+
+#include "StringBytes.h"
+
 Comment::Comment() {}
 Comment::~Comment() {}
 
@@ -19,6 +22,14 @@ std::string Comment::getCommentUser() { return commentUser; }
  * @return commentText
  */
 std::string Comment::getCommentText() { return commentText; }
+/**
+ * Gets the approximate memory held by a comment
+ * @return bytes used by the comment and its text
+ */
+size_t Comment::bytes() {
+  return sizeof(Comment) + StringBytes::heap(commentUser) +
+         StringBytes::heap(commentText);
+}
 
 /**
  * Sets the text of a comment
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "Compression.h"
+
+#include <zlib.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+/**
+ * Checks whether an Accept-Encoding header allows gzip
+ * @param acceptEncoding value of the Accept-Encoding request header
+ * @return true if gzip (or "*") is listed without q=0
+ */
+bool Compression::acceptsGzip(const std::string& acceptEncoding) {
+  std::stringstream ss(acceptEncoding);
+  std::string coding;
+  while (getline(ss, coding, ',')) {  // e.g. "gzip;q=0.8, br"
+    std::string name = coding.substr(0, coding.find(';'));
+    size_t start = name.find_first_not_of(" \t");
+    if (start == std::string::npos) continue;
+    name = name.substr(start, name.find_last_not_of(" \t") - start + 1);
+    if (name != "gzip" && name != "x-gzip" && name != "*") continue;
+
+    size_t q = coding.find("q=");
+    return q == std::string::npos || atof(coding.c_str() + q + 2) > 0;
+  }
+  return false;
+}
+
+/**
+ * Compresses data into the gzip format
+ * @param data the bytes to compress
+ * @param level zlib compression level (1 fastest, 9 smallest)
+ * @return the gzip stream
+ */
+std::string Compression::gzip(const std::string& data, int level) {
+  z_stream stream = {};
+  // 15 window bits + 16 selects the gzip wrapper instead of zlib
+  deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  std::string out;
+  out.resize(deflateBound(&stream, data.size()));
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  stream.avail_out = out.size();
+  deflate(&stream, Z_FINISH);  // Bound guarantees a single call finishes
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+/**
+ * Decompresses a gzip (or zlib) stream
+ * @param data the compressed bytes
+ * @param out set to the decompressed bytes
+ * @return false if the stream is corrupt
+ */
+bool Compression::gunzip(const std::string& data, std::string* out) {
+  z_stream stream = {};
+  // 15 window bits + 32 detects the gzip or zlib header automatically
+  if (inflateInit2(&stream, 15 + 32) != Z_OK) return false;
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+
+  out->clear();
+  char chunk[16384];
+  int status;
+  do {
+    stream.next_out = reinterpret_cast<Bytef*>(chunk);
+    stream.avail_out = sizeof(chunk);
+    status = inflate(&stream, Z_NO_FLUSH);
+    if (status != Z_OK && status != Z_STREAM_END) {
+      inflateEnd(&stream);
+      return false;
+    }
+    out->append(chunk, sizeof(chunk) - stream.avail_out);
+  } while (status != Z_STREAM_END);
+  inflateEnd(&stream);
+  return true;
+}
@@ -0,0 +1,362 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "DatasetGenerator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Bytes collected before each write to a file
+ */
+static const size_t FLUSH_SIZE = 1 << 20;
+
+/**
+ * Names of the first operating systems and issue types, the ones the
+ * client offers; further ones are numbered
+ */
+static const char* SYSTEM_NAMES[] = {"Linux", "Windows", "MacOS"};
+static const char* TYPE_NAMES[] = {"Bug", "Feature", "Task"};
+
+/**
+ * log(1 + x) / x, accurate near 0
+ */
+static double helper1(double x) {
+  if (fabs(x) > 1e-8) return log1p(x) / x;
+  return 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+/**
+ * (exp(x) - 1) / x, accurate near 0
+ */
+static double helper2(double x) {
+  if (fabs(x) > 1e-8) return expm1(x) / x;
+  return 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+/**
+ * @param n number of ranks
+ * @param s exponent, 0 for uniform; larger values favour low ranks more
+ */
+ZipfDistribution::ZipfDistribution(uint64_t n, double s)
+    : n(n < 1 ? 1 : n), s(s) {
+  hIntegralX1 = hIntegral(1.5) - 1;
+  hIntegralN = hIntegral(this->n + 0.5);
+  shortcut = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+}
+
+/**
+ * The unnormalized density, x^-s
+ */
+double ZipfDistribution::h(double x) const { return exp(-s * log(x)); }
+
+/**
+ * An antiderivative of h
+ */
+double ZipfDistribution::hIntegral(double x) const {
+  double logX = log(x);
+  return helper2((1 - s) * logX) * logX;
+}
+
+/**
+ * The inverse of hIntegral
+ */
+double ZipfDistribution::hIntegralInverse(double x) const {
+  double t = x * (1 - s);
+  if (t < -1) t = -1;  // Rounding can push it just past the domain
+  return exp(helper1(t) * x);
+}
+
+/**
+ * @param n number of ranks
+ * @param s exponent, 0 for uniform; larger values favour low ranks more
+ */
+AliasTable::AliasTable(uint64_t n, double s)
+    : keep(n < 1 ? 1 : n, 1ULL << 32) {
+  n = keep.size();
+  std::vector<double> weights(n);
+  double total = 0;
+  for (size_t i = 0; i < n; i++) {
+    weights[i] = pow(i + 1.0, -s);
+    total += weights[i];
+  }
+
+  // Pairs each underfull slot with an overfull rank that tops it up
+  alias.resize(n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (size_t i = 0; i < n; i++) {
+    alias[i] = i;
+    weights[i] *= n / total;
+    (weights[i] < 1 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t under = small.back();
+    uint32_t over = large.back();
+    small.pop_back();
+    keep[under] = static_cast<uint64_t>(weights[under] * 4294967296.0);
+    alias[under] = over;
+    weights[over] -= 1 - weights[under];
+    if (weights[over] < 1) {
+      large.pop_back();
+      small.push_back(over);
+    }
+  }
+}
+
+/**
+ * @param spec shape of the store
+ */
+DatasetGenerator::DatasetGenerator(const DatasetSpec& spec)
+    : spec(spec),
+      state(spec.seed),
+      written(0),
+      wordRanks(spec.vocabulary, spec.wordSkew),
+      userRanks(spec.users, spec.userSkew) {
+  words.reserve(spec.vocabulary);
+  for (uint64_t rank = 1; rank <= spec.vocabulary; rank++) {
+    words.push_back(word(rank));
+  }
+}
+
+/**
+ * Collects the output of one file and writes it in large blocks
+ */
+class BlockWriter {
+ public:
+  explicit BlockWriter(const std::string& path)
+      : file(fopen(path.c_str(), "wb")), failed(file == NULL), size(0) {
+    buffer.reserve(FLUSH_SIZE + 4096);
+  }
+  ~BlockWriter() { close(); }
+
+  std::string buffer;
+
+  /**
+   * Writes the buffer once it is full
+   */
+  void maybeFlush() {
+    if (buffer.size() >= FLUSH_SIZE) flush();
+  }
+  /**
+   * Writes what is left and closes the file
+   * @return false if anything failed to write
+   */
+  bool close() {
+    if (file == NULL) return !failed;
+    flush();
+    if (fclose(file) != 0) failed = true;
+    file = NULL;
+    return !failed;
+  }
+  uint64_t bytes() { return size; }
+
+ private:
+  void flush() {
+    if (file != NULL && !buffer.empty() &&
+        fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+      failed = true;
+    }
+    size += buffer.size();
+    buffer.clear();
+  }
+
+  FILE* file;
+  bool failed;
+  uint64_t size;
+};
+
+/**
+ * Writes the store, replacing any in the directory, and removes a saved
+ * search index that would no longer match it
+ * @param dir directory to write to
+ * @param error set to what went wrong if writing fails
+ * @return false if a file could not be written
+ */
+bool DatasetGenerator::write(const std::string& dir, std::string* error) {
+  std::string prefix = dir.empty() ? "" : dir + "/";
+  state = spec.seed;
+  written = 0;
+  remove((prefix + "search.idx").c_str());
+
+  BlockWriter users(prefix + "users.txt");
+  for (uint64_t u = 1; u <= spec.users; u++) {
+    users.buffer += "user_" + std::to_string(u) + '\n';
+    users.maybeFlush();
+  }
+
+  std::vector<uint32_t> counts = commentCounts();
+  ZipfDistribution systemRanks(spec.systems, 1.0);
+  ZipfDistribution typeRanks(spec.types, 1.0);
+  ZipfDistribution labelRanks(spec.labels, 1.0);
+  auto draw = [this]() { return uniform(); };
+  BlockWriter context(prefix + "context.txt");
+  BlockWriter comments(prefix + "comments.txt");
+  BlockWriter labels(prefix + "labels.txt");
+  std::string title;
+  for (uint64_t i = 0; i < spec.issues; i++) {
+    // Numbered so every title is unique
+    title.clear();
+    appendWords(&title, around(spec.titleWords));
+    title += ' ' + std::to_string(i + 1);
+
+    std::string& out = context.buffer;
+    out += title;
+    out += "^]";
+    appendWords(&out, around(spec.descWords));
+    out += "^]";
+    uint64_t system = systemRanks.sample(draw);
+    out += system <= 3 ? SYSTEM_NAMES[system - 1]
+                       : "OS" + std::to_string(system);
+    out += "^]";
+    uint64_t type = typeRanks.sample(draw);
+    out += type <= 3 ? TYPE_NAMES[type - 1] : "Type" + std::to_string(type);
+    appendUser(&out);
+    appendUser(&out);
+    out += "^]";
+    context.maybeFlush();
+
+    // readFile matches comment blocks to issues in order, by title
+    if (counts[i] > 0) {
+      std::string& text = comments.buffer;
+      text += title;
+      text += "^]";
+      for (uint32_t c = 0; c < counts[i]; c++) {
+        appendWords(&text, around(spec.commentWords));
+        appendUser(&text);
+        text += "^]";
+      }
+      text += "**";
+      comments.maybeFlush();
+    }
+
+    if (spec.labels > 0 && spec.labelsPerIssue > 0) {
+      size_t wanted = static_cast<size_t>(spec.labelsPerIssue);
+      if (uniform() < spec.labelsPerIssue - wanted) wanted++;
+      if (wanted > static_cast<size_t>(spec.labels)) wanted = spec.labels;
+      std::vector<uint64_t> picked;
+      while (picked.size() < wanted) {
+        uint64_t label = labelRanks.sample(draw);
+        bool seen = false;
+        for (size_t p = 0; p < picked.size(); p++) seen |= picked[p] == label;
+        if (!seen) picked.push_back(label);
+      }
+      if (!picked.empty()) {
+        labels.buffer += title + "^]";
+        for (size_t p = 0; p < picked.size(); p++) {
+          labels.buffer += "label" + std::to_string(picked[p]) + "^]";
+        }
+        labels.buffer += '\n';
+        labels.maybeFlush();
+      }
+    }
+  }
+
+  bool ok = users.close() & context.close() & comments.close() &
+            labels.close();
+  written = users.bytes() + context.bytes() + comments.bytes() +
+            labels.bytes();
+  if (!ok) *error = "could not write the store to " + (dir.empty() ? "." : dir);
+  return ok;
+}
+
+/**
+ * Gets the number of bytes the last write produced
+ * @return total size of the files written
+ */
+uint64_t DatasetGenerator::bytesWritten() { return written; }
+
+/**
+ * Gets a word of the vocabulary
+ * @param rank rank of the word from 1, most frequent first
+ * @return the word, lowercase letters only
+ */
+std::string DatasetGenerator::word(uint64_t rank) {
+  // Syllables spell the rank in bijective base 16, so every rank gets its
+  // own word and frequent words are short
+  static const char* syllables[] = {"ka", "lo", "mi", "nu", "pe", "ra",
+                                    "si", "to", "vu", "be", "do", "fi",
+                                    "ga", "ho", "ju", "ze"};
+  std::string spelled;
+  for (uint64_t n = rank; n > 0; n = (n - 1) / 16) {
+    spelled = syllables[(n - 1) % 16] + spelled;
+  }
+  return spelled;
+}
+
+/**
+ * Gets the next random number (splitmix64)
+ * @return 64 random bits
+ */
+uint64_t DatasetGenerator::next() {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Gets a uniform random number
+ * @return a number in [0, 1)
+ */
+double DatasetGenerator::uniform() {
+  return (next() >> 11) / 9007199254740992.0;  // 53 bits over 2^53
+}
+
+/**
+ * Picks a length between half and one and a half times an average
+ * @param average the average
+ * @return the length, at least 1
+ */
+int DatasetGenerator::around(int average) {
+  int low = average / 2;
+  int length = low + next() % (average + 1);
+  return length < 1 ? 1 : length;
+}
+
+/**
+ * Appends words drawn from the vocabulary, separated by spaces
+ * @param out text to append to
+ * @param count number of words
+ */
+void DatasetGenerator::appendWords(std::string* out, int count) {
+  for (int w = 0; w < count; w++) {
+    if (w > 0) *out += ' ';
+    *out += words[wordRanks.sample(next()) - 1];
+  }
+}
+
+/**
+ * Appends a "^]" separator and a username drawn from the users
+ * @param out text to append to
+ */
+void DatasetGenerator::appendUser(std::string* out) {
+  char digits[24];
+  char* end = digits + sizeof(digits);
+  char* p = end;
+  for (uint64_t n = userRanks.sample(next()); n > 0; n /= 10) {
+    *--p = '0' + n % 10;
+  }
+  out->append("^]user_");
+  out->append(p, end - p);
+}
+
+/**
+ * Spreads the comments over the issues
+ * @return number of comments on each issue
+ */
+std::vector<uint32_t> DatasetGenerator::commentCounts() {
+  std::vector<uint32_t> counts(spec.issues, 0);
+  if (spec.issues == 0) return counts;
+  ZipfDistribution issueRanks(spec.issues, spec.commentSkew);
+  auto draw = [this]() { return uniform(); };
+  for (uint64_t c = 0; c < spec.comments; c++) {
+    counts[issueRanks.sample(draw) - 1]++;
+  }
+  return counts;
+}
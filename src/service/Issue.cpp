@@ -5,10 +5,13 @@
 
 #include "Issue.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "StringBytes.h"
+
 /**
  * Constructor for Issue which takes in issue information as parameters
  * @param t Issue title
@@ -26,6 +29,7 @@ Issue::Issue(std::string t, std::string d, std::string os, std::string type,
   issueType = type;  // Type is set
   user = u;          // Author is set
   assign = a;        // Assignee is set
+  id = 0;            // Assigned when added to a tracker
 }
 
 /**
@@ -80,6 +84,12 @@ void Issue::setAssignee(std::string sa) {
   }
 }
 
+/**
+ * Sets the issue id
+ * @param i issue id
+ */
+void Issue::setId(uint64_t i) { id = i; }
+
 /**
  * Sets user at specified comment to "user_Removed" when user is deleted
  * @param index index of comments vector
@@ -150,8 +160,73 @@ std::string Issue::getIssueUser() {
   }
 }
 
+/**
+ * Gets the issue id, assigned by the tracker in creation order
+ * @return issue id, 0 if the issue was never added to a tracker
+ */
+uint64_t Issue::getId() { return id; }
+
+/**
+ * Gets the issue labels
+ * @return labels in the order they were added
+ */
+std::vector<std::string> Issue::getLabels() { return labels; }
+
+/**
+ * Gets the approximate memory held by the issue, not counting its
+ * comments
+ * @return bytes used by the issue, its text, labels and comment list
+ */
+size_t Issue::bytes() {
+  size_t used = sizeof(Issue) + StringBytes::heap(title) +
+                StringBytes::heap(desc) + StringBytes::heap(opSys) +
+                StringBytes::heap(issueType) + StringBytes::heap(user) +
+                StringBytes::heap(assign) +
+                comments.capacity() * sizeof(Comment*) +
+                labels.capacity() * sizeof(std::string);
+  for (size_t i = 0; i < labels.size(); i++) {
+    used += StringBytes::heap(labels[i]);
+  }
+  return used;
+}
+
+/**
+ * Gets the approximate memory held by the issue's comments
+ * @return bytes used by the comments and their text
+ */
+size_t Issue::commentBytes() {
+  size_t used = 0;
+  for (size_t i = 0; i < comments.size(); i++) used += comments[i]->bytes();
+  return used;
+}
+
 /**
  * Adds new comment to comments vector
  * @param c Comment pointer to be added to vector
  */
 void Issue::addToComments(Comment* c) { comments.push_back(c); }
+
+/**
+ * Adds a label to the issue
+ * @param label the label
+ * @return false if the issue already had the label
+ */
+bool Issue::addLabel(std::string label) {
+  if (std::find(labels.begin(), labels.end(), label) != labels.end()) {
+    return false;
+  }
+  labels.push_back(label);
+  return true;
+}
+
+/**
+ * Removes a label from the issue
+ * @param label the label
+ * @return false if the issue did not have the label
+ */
+bool Issue::removeLabel(std::string label) {
+  auto found = std::find(labels.begin(), labels.end(), label);
+  if (found == labels.end()) return false;
+  labels.erase(found);
+  return true;
+}
@@ -5,15 +5,129 @@
 
 #include "IssueTracker.h"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Issue.h"
+#include "StringBytes.h"
+#include "Tracer.h"
 #include "User.h"
-IssueTracker::IssueTracker() {}
+
+/**
+ * Seconds after which a comment counts half as much towards how hot its
+ * issue is
+ */
+static const double ACTIVITY_HALF_LIFE = 7 * 24 * 3600;
+
+/**
+ * Gets the current time for activity scores
+ * @return seconds since the epoch
+ */
+static double clockSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * Splits a comma separated list of facets, reading bare words as labels
+ * @param list facets such as "ui,type:Bug"
+ * @return the facet keys, such as "label:ui" and "type:Bug"
+ */
+static std::vector<std::string> facetKeys(const std::string& list) {
+  std::vector<std::string> keys;
+  std::stringstream ss(list);
+  std::string key;
+  while (getline(ss, key, ',')) {
+    if (key.empty()) continue;
+    keys.push_back(key.find(':') == std::string::npos ? "label:" + key : key);
+  }
+  return keys;
+}
+
+/**
+ * Checks that every predicate of a query names a known field with an
+ * operator and value that suit it
+ * @param node query node
+ * @param error set to the first problem found
+ * @return false if the query cannot be run
+ */
+static bool checkQuery(const QueryNode& node, std::string* error) {
+  for (size_t i = 0; i < node.children.size(); i++) {
+    if (!checkQuery(node.children[i], error)) return false;
+  }
+  if (node.kind != QueryNode::TERM) return true;
+
+  static const std::set<std::string> fields = {
+      "type", "os",       "label", "user", "author",     "assign",
+      "assignee", "title", "desc", "description", "comments"};
+  if (!fields.count(node.field)) {
+    *error = "unknown field " + node.field;
+    return false;
+  }
+  if (node.field == "comments") {
+    char* end;
+    strtoll(node.value.c_str(), &end, 10);
+    if (node.value.empty() || *end != '\0') {
+      *error = "comments needs a number";
+      return false;
+    }
+  } else if (node.op != ":") {
+    *error = node.field + " only supports : and !=";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Checks whether a text contains a fragment, ignoring case
+ * @param text the text
+ * @param fragment the fragment
+ * @return true if fragment occurs in text
+ */
+static bool containsFolded(const std::string& text,
+                           const std::string& fragment) {
+  auto same = [](char a, char b) {
+    return tolower(static_cast<unsigned char>(a)) ==
+           tolower(static_cast<unsigned char>(b));
+  };
+  return std::search(text.begin(), text.end(), fragment.begin(),
+                     fragment.end(), same) != text.end();
+}
+
+/**
+ * Adds text to a running CRC-32
+ * @param crc checksum so far, 0 to start
+ * @param text the text
+ * @return the checksum including text
+ */
+static uLong checksum(uLong crc, const std::string& text) {
+  return crc32(crc, reinterpret_cast<const Bytef*>(text.data()),
+               text.size());
+}
+
+IssueTracker::IssueTracker()
+    : nextIssueId(1),
+      commentTotal(0),
+      writeCount(0),
+      writeMicros(0),
+      writeBytes(0),
+      activity(ACTIVITY_HALF_LIFE),
+      loadingFile(false),
+      indexSaved(false) {}
 IssueTracker::~IssueTracker() {}
 
 /**
@@ -28,6 +142,9 @@ void IssueTracker::memoryCleanIssues() {
     delete (users[i]);
   }
   users.clear();
+  userNames.clear();
+  userGrams.clear();
+  userPrefixes.clear();
 }
 
 /**
@@ -58,16 +175,206 @@ std::vector<User*> IssueTracker::getUserVec() { return users; }
 int IssueTracker::retSize() { return issues.size(); }
 
 /**
- * Adds Issue pointer to vector issues
+ * Gets the tracker version, which increases on every successful mutation
+ * and is used by the server to build ETags
+ * @return current version
+ */
+uint64_t IssueTracker::getVersion() { return changes.getVersion(); }
+
+/**
+ * Gets the sizes of the store and the cost of writing it so far
+ * @return counts of issues, users and comments, and writeFile totals
+ */
+StoreStats IssueTracker::getStoreStats() {
+  return {issues.size(), users.size(), commentTotal,
+          writeCount,    writeMicros,  writeBytes};
+}
+
+/**
+ * Adds up the memory held by the store, walking every issue, comment
+ * and user
+ * @return bytes held by each part of the store
+ */
+MemoryStats IssueTracker::getMemoryStats() {
+  MemoryStats stats = {};
+  for (size_t i = 0; i < issues.size(); i++) {
+    stats.issueBytes += issues[i]->bytes();
+    stats.commentBytes += issues[i]->commentBytes();
+  }
+  for (size_t u = 0; u < users.size(); u++) {
+    stats.userBytes += users[u]->bytes();
+  }
+  stats.listBytes = issues.capacity() * sizeof(Issue*) +
+                    users.capacity() * sizeof(User*);
+
+  // Tree nodes hold three pointers and a color besides the value, hash
+  // nodes a next pointer and the cached hash
+  const size_t treeNode = 4 * sizeof(void*);
+  const size_t hashNode = 2 * sizeof(void*);
+  size_t titles = issuesByTitle.bucket_count() * sizeof(void*);
+  for (auto it = issuesByTitle.begin(); it != issuesByTitle.end(); ++it) {
+    titles += sizeof(*it) + hashNode + StringBytes::heap(it->first) +
+              it->second.capacity() * sizeof(Issue*);
+  }
+  size_t names = 0;
+  for (auto it = userNames.begin(); it != userNames.end(); ++it) {
+    names += sizeof(*it) + treeNode + StringBytes::heap(*it);
+  }
+  size_t saved = 0;
+  for (auto it = views.begin(); it != views.end(); ++it) {
+    saved += sizeof(*it) + treeNode + StringBytes::heap(it->first) +
+             StringBytes::heap(it->second.query) + it->second.ids.bytes();
+  }
+  stats.indexBytes = {
+      {"byId", issuesById.size() *
+                   (sizeof(std::pair<uint64_t, Issue*>) + treeNode)},
+      {"byTitle", titles},
+      {"userNames", names},
+      {"text", text.bytes()},
+      {"titleGrams", titleGrams.bytes()},
+      {"userGrams", userGrams.bytes()},
+      {"titlePrefixes", titlePrefixes.bytes()},
+      {"userPrefixes", userPrefixes.bytes()},
+      {"activity", activity.bytes()},
+      {"facets", facets.bytes() + allIds.bytes()},
+      {"views", saved},
+      {"byOS", byOS.bytes()},
+      {"byType", byType.bytes()},
+      {"byUser", byUser.bytes()},
+      {"byAssign", byAssign.bytes()}};
+  stats.changeBytes = changes.bytes();
+  return stats;
+}
+
+/**
+ * Adds Issue pointer to vector issues, gives it an id if it has none and
+ * adds it to the secondary indexes
+ * @param i Issue pointer
+ */
+void IssueTracker::addToIssueVec(Issue* i) {
+  if (i->getId() == 0) {
+    i->setId(nextIssueId++);
+  } else if (i->getId() >= nextIssueId) {
+    nextIssueId = i->getId() + 1;
+  }
+  issues.push_back(i);
+  issuesById[i->getId()] = i;
+  issuesByTitle[i->getIssueTitle()].push_back(i);
+  titleGrams.add(i->getIssueTitle());
+  titlePrefixes.add(i->getIssueTitle());
+  indexIssue(i);
+}
+
+/**
+ * Adds an issue to the secondary indexes
+ * @param i Issue pointer
+ */
+void IssueTracker::indexIssue(Issue* i) {
+  if (!loadingFile) text.add(i->getId(), issueText(i));
+  byOS.add(i->getIssueOS(), i->getId());
+  byType.add(i->getIssueType(), i->getId());
+  byUser.add(i->getIssueUser(), i->getId());
+  byAssign.add(i->getIssueAssignee(), i->getId());
+  commentTotal += i->getCommentNum();
+  allIds.add(i->getId());
+  facets.add("type:" + i->getIssueType(), i->getId());
+  facets.add("os:" + i->getIssueOS(), i->getId());
+  std::vector<std::string> labels = i->getLabels();
+  for (int l = 0; l < labels.size(); l++) {
+    facets.add("label:" + labels[l], i->getId());
+  }
+  if (i->getCommentNum() > 0) {
+    activity.record(i->getId(), clockSeconds(), i->getCommentNum());
+  }
+  refreshViews(i);
+}
+
+/**
+ * Removes an issue from the secondary indexes
+ * @param i Issue pointer
+ */
+void IssueTracker::unindexIssue(Issue* i) {
+  text.remove(i->getId(), issueText(i));
+  byOS.remove(i->getIssueOS(), i->getId());
+  byType.remove(i->getIssueType(), i->getId());
+  byUser.remove(i->getIssueUser(), i->getId());
+  byAssign.remove(i->getIssueAssignee(), i->getId());
+  commentTotal -= i->getCommentNum();
+  activity.remove(i->getId());
+  allIds.remove(i->getId());
+  facets.remove("type:" + i->getIssueType(), i->getId());
+  facets.remove("os:" + i->getIssueOS(), i->getId());
+  std::vector<std::string> labels = i->getLabels();
+  for (int l = 0; l < labels.size(); l++) {
+    facets.remove("label:" + labels[l], i->getId());
+  }
+  for (auto view = views.begin(); view != views.end(); ++view) {
+    view->second.ids.remove(i->getId());
+  }
+}
+
+/**
+ * Finds the latest issue with a title
+ * @param title the title
+ * @return the issue, NULL if no issue has the title
+ */
+Issue* IssueTracker::latestIssue(const std::string& title) {
+  auto found = issuesByTitle.find(title);
+  return found == issuesByTitle.end() ? NULL : found->second.back();
+}
+
+/**
+ * Adds a label to an issue and to the facet index
+ * @param i Issue pointer
+ * @param label The label
+ * @return false if the issue already had the label
+ */
+bool IssueTracker::labelIssue(Issue* i, const std::string& label) {
+  if (!i->addLabel(label)) return false;
+  facets.add("label:" + label, i->getId());
+  refreshViews(i);
+  return true;
+}
+
+/**
+ * Adds an issue to the saved views it now matches and removes it from
+ * the ones it no longer matches
  * @param i Issue pointer
  */
-void IssueTracker::addToIssueVec(Issue* i) { issues.push_back(i); }
+void IssueTracker::refreshViews(Issue* i) {
+  for (auto view = views.begin(); view != views.end(); ++view) {
+    if (matchesQuery(i, view->second.root)) {
+      view->second.ids.add(i->getId());
+    } else {
+      view->second.ids.remove(i->getId());
+    }
+  }
+}
 
 /**
  * Adds User pointer to vector users
  * @param u User pointer
  */
-void IssueTracker::addToUserVec(User* u) { users.push_back(u); }
+void IssueTracker::addToUserVec(User* u) {
+  users.push_back(u);
+  userNames.insert(u->getName());
+  userGrams.add(u->getName());
+  userPrefixes.add(u->getName());
+}
+
+/**
+ * Gets all searchable text of an issue (title, description and comments)
+ * @param i Issue pointer
+ * @return the text, one piece per line
+ */
+std::string IssueTracker::issueText(Issue* i) {
+  std::string all = i->getIssueTitle() + '\n' + i->getIssueDesc();
+  std::vector<Comment*> comments = i->getCommentVec();
+  for (int c = 0; c < comments.size(); c++) {
+    all += '\n' + comments[c]->getCommentText();
+  }
+  return all;
+}
 
 /**
  * Creates a new issue object then adds it to the issues vector
@@ -87,6 +394,7 @@ void IssueTracker::addAnIssue(std::string title, std::string desc,
   // Creates new Issue object pointer with given attributes
   Issue* newIssue = new Issue(title, desc, os, type, user, assign);
   addToIssueVec(newIssue);     // Adds issue to issues vector
+  changes.record("addIssue", title);  // Invalidates cached GET responses
   writeFile();                 // Writes issue to file
   result = "New Issue Added";  // Sends result back to client
 }
@@ -107,6 +415,30 @@ std::string IssueTracker::getAllIssues() {
   return result;
 }
 
+/**
+ * Retrieves one page of issue titles in creation order. If more issues
+ * follow, the page ends with "(MORE)" and the cursor to resume from.
+ * @param after cursor from the previous page, 0 for the first page
+ * @param limit most titles returned
+ * @return the title of each issue on the page, "(BLANK)" if there are none
+ */
+std::string IssueTracker::getIssuePage(uint64_t after, size_t limit) {
+  if (issuesById.empty()) return "(BLANK)[^";
+
+  std::string result;
+  size_t count = 0;
+  // Ids never change, so the cursor is the id of the last title sent
+  auto it = issuesById.upper_bound(after);
+  for (; it != issuesById.end() && count < limit; ++it, count++) {
+    result += it->second->getIssueTitle() + "[^";
+    after = it->first;
+  }
+  if (it != issuesById.end()) {
+    result += "(MORE)" + std::to_string(after) + "[^";
+  }
+  return result;
+}
+
 /**
  * Retrieves an existing issue from the vector of issues based on it's title
  * @param issueTitle The issue title
@@ -142,26 +474,699 @@ std::string IssueTracker::getAnIssue(std::string issueTitle) {
 }
 
 /**
- * Deletes an existing issue from the issues vector based on it's title
- * and re-writes the text file
+ * Retrieves an existing issue with one page of its comments. If more
+ * comments follow, the result ends with "(MORE)" and the cursor to resume
+ * from.
+ * @param issueTitle The issue title
+ * @param after index of the first comment on the page
+ * @param limit most comments returned
+ * @return returns the issue data if issue is found and "(BLANK)" if not
+ */
+std::string IssueTracker::getAnIssuePage(std::string issueTitle, size_t after,
+                                         size_t limit) {
+  Issue* issue = latestIssue(issueTitle);
+  if (issue == NULL) return "(BLANK)[^";
+
+  // Authors that were deleted are shown as "user_Removed"
+  std::string user = issue->getIssueUser();
+  if (!userNames.count(user)) user = "user_Removed";
+
+  // Concatenate all issue attributes into result with delimiter
+  std::string result = issue->getIssueTitle() + "^]" + issue->getIssueDesc() +
+                       "^]" + issue->getIssueOS() + "^]" +
+                       issue->getIssueType() + "^]" + user + "^]" +
+                       issue->getIssueAssignee() + "^]";
+
+  // Comments are only appended, so an index is a stable cursor
+  std::vector<Comment*> comments = issue->getCommentVec();
+  // Clamped before adding, so a huge cursor cannot wrap around
+  size_t end = comments.size();
+  if (after > end) after = end;
+  if (limit < end - after) end = after + limit;
+  for (size_t i = after; i < end; i++) {
+    result += comments[i]->getCommentText() + "^]" +
+              comments[i]->getCommentUser() + "^]";
+  }
+  if (end < comments.size()) {
+    result += "(MORE)" + std::to_string(end) + "^]";
+  }
+  return result;
+}
+
+/**
+ * Deletes every issue with a title from the issues vector and
+ * re-writes the text file
  * @param issueTitle The issue title
  * @return returns the status of issue deletion
  */
 std::string IssueTracker::deleteIssue(std::string title) {
   std::string result = "(BLANK)";
-  int index;
   for (int i = 0; i < issues.size(); i++) {
     //  If issue found by title, delete the issue
     if (issues.at(i)->getIssueTitle() == title) {
-      index = i;
+      Issue* issue = issues.at(i);
       result = title + " has been removed.";
-      issues.erase(issues.begin() + index);
+      unindexIssue(issue);
+      issuesById.erase(issue->getId());
+      // The title stays searchable while another issue still has it
+      std::vector<Issue*>& same = issuesByTitle[title];
+      same.erase(std::find(same.begin(), same.end(), issue));
+      if (same.empty()) {
+        issuesByTitle.erase(title);
+        titleGrams.remove(title);
+        titlePrefixes.remove(title);
+      }
+      issues.erase(issues.begin() + i);
+      i--;  // The next issue moved into this slot
+      changes.record("deleteIssue", title);
     }
   }
   writeFile();  // Re-write files to remove issue from them
   return result;
 }
 
+/**
+ * Finds the issues matching every non-empty filter using the secondary
+ * indexes. Only the shortest matching posting list is walked, so the cost
+ * follows the number of candidates rather than the number of issues.
+ * @param os Required operating system, "" for any
+ * @param type Required issue type, "" for any
+ * @param user Required author, "" for any
+ * @param assign Required assignee, "" for any
+ * @return matching issues in creation order
+ */
+std::vector<Issue*> IssueTracker::findIssues(const std::string& os,
+                                             const std::string& type,
+                                             const std::string& user,
+                                             const std::string& assign) {
+  std::vector<Issue*> found;
+  // Each requested filter with the index that answers it
+  std::vector<std::pair<PostingIndex*, std::string>> filters;
+  if (!os.empty()) filters.push_back(std::make_pair(&byOS, os));
+  if (!type.empty()) filters.push_back(std::make_pair(&byType, type));
+  if (!user.empty()) filters.push_back(std::make_pair(&byUser, user));
+  if (!assign.empty()) filters.push_back(std::make_pair(&byAssign, assign));
+
+  if (filters.empty()) {  // No filters, every issue matches
+    for (auto it = issuesById.begin(); it != issuesById.end(); ++it) {
+      found.push_back(it->second);
+    }
+    return found;
+  }
+
+  // Drive from the shortest posting list and probe the others
+  int driver = 0;
+  for (int f = 1; f < filters.size(); f++) {
+    if (filters[f].first->get(filters[f].second).size() <
+        filters[driver].first->get(filters[driver].second).size()) {
+      driver = f;
+    }
+  }
+  const std::vector<uint64_t>& candidates =
+      filters[driver].first->get(filters[driver].second);
+  for (int c = 0; c < candidates.size(); c++) {
+    bool match = true;
+    for (int f = 0; f < filters.size() && match; f++) {
+      if (f != driver) {
+        match = filters[f].first->contains(filters[f].second, candidates[c]);
+      }
+    }
+    if (match) found.push_back(issuesById[candidates[c]]);
+  }
+  return found;
+}
+
+/**
+ * Retrieves the titles of the issues matching every non-empty filter
+ * @param os Required operating system, "" for any
+ * @param type Required issue type, "" for any
+ * @param user Required author, "" for any
+ * @param assign Required assignee, "" for any
+ * @return the title of each matching issue, "(BLANK)" if none match
+ */
+std::string IssueTracker::queryIssues(std::string os, std::string type,
+                                      std::string user, std::string assign) {
+  std::vector<Issue*> found = findIssues(os, type, user, assign);
+  if (found.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < found.size(); i++) {
+    result += found[i]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Retrieves the issue and comment totals and the number of issues of each
+ * type, operating system, author and assignee. The counts are kept up to
+ * date on every change, so no issue is visited.
+ * @return "field^]value^]count^]" for each group, after the "total"
+ * groups "issues" and "comments"
+ */
+std::string IssueTracker::getStats() {
+  std::string result = "total^]issues^]" + std::to_string(issues.size()) +
+                       "^]total^]comments^]" + std::to_string(commentTotal) +
+                       "^]";
+  const PostingIndex* indexes[] = {&byType, &byOS, &byUser, &byAssign};
+  const char* fields[] = {"type", "os", "user", "assign"};
+  for (int f = 0; f < 4; f++) {
+    std::vector<std::pair<std::string, size_t>> groups = indexes[f]->counts();
+    for (int g = 0; g < groups.size(); g++) {
+      result += std::string(fields[f]) + "^]" + groups[g].first + "^]" +
+                std::to_string(groups[g].second) + "^]";
+    }
+  }
+  return result;
+}
+
+/**
+ * Retrieves the most active issues, ranked by their comments with recent
+ * comments counting more
+ * @param limit Most titles returned
+ * @return the title of each issue, hottest first, or "(BLANK)" if no
+ * issue has comments
+ */
+std::string IssueTracker::getHotIssues(size_t limit) {
+  std::vector<std::pair<uint64_t, double>> hot =
+      activity.top(limit, clockSeconds());
+  if (hot.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < hot.size(); i++) {
+    result += issuesById[hot[i].first]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Adds a label to an issue and writes it to labels.txt
+ * @param title Title of the issue
+ * @param label The label, which may not contain ',' or "^]"
+ * @return a message saying whether the label was added
+ */
+std::string IssueTracker::addLabel(std::string title, std::string label) {
+  if (label.empty() || label.find(',') != std::string::npos ||
+      label.find("^]") != std::string::npos) {
+    return "Invalid label";
+  }
+  Issue* issue = latestIssue(title);
+  if (issue == NULL) return "(BLANK)";
+  if (!labelIssue(issue, label)) return title + " is already " + label;
+
+  changes.record("updateIssue", title);
+  writeFile();
+  return title + " is now " + label;
+}
+
+/**
+ * Removes a label from an issue and from labels.txt
+ * @param title Title of the issue
+ * @param label The label
+ * @return a message saying whether the label was removed
+ */
+std::string IssueTracker::removeLabel(std::string title, std::string label) {
+  Issue* issue = latestIssue(title);
+  if (issue == NULL) return "(BLANK)";
+  if (!issue->removeLabel(label)) return title + " is not " + label;
+  facets.remove("label:" + label, issue->getId());
+  refreshViews(issue);
+
+  changes.record("updateIssue", title);
+  writeFile();
+  return title + " is no longer " + label;
+}
+
+/**
+ * Finds the issues matching a combination of facets. A facet is
+ * "label:<label>", "type:<type>" or "os:<os>", and a bare word is a label.
+ * @param all Facets every issue must have (AND), empty for any
+ * @param any Facets an issue must have at least one of (OR), empty for any
+ * @param none Facets no issue may have (NOT)
+ * @return the ids of the matching issues
+ */
+Bitmap IssueTracker::matchFacets(const std::vector<std::string>& all,
+                                 const std::vector<std::string>& any,
+                                 const std::vector<std::string>& none) {
+  // Smallest facet first, so every later intersection is cheap
+  std::vector<const Bitmap*> required;
+  for (int i = 0; i < all.size(); i++) required.push_back(&facets.get(all[i]));
+  std::sort(required.begin(), required.end(),
+            [](const Bitmap* a, const Bitmap* b) {
+              return a->cardinality() < b->cardinality();
+            });
+  Bitmap result = required.empty() ? allIds : *required[0];
+  for (int i = 1; i < required.size() && !result.empty(); i++) {
+    result = Bitmap::intersect(result, *required[i]);
+  }
+
+  if (!any.empty()) {
+    Bitmap either;
+    for (int i = 0; i < any.size(); i++) {
+      either = Bitmap::unite(either, facets.get(any[i]));
+    }
+    result = Bitmap::intersect(result, either);
+  }
+  for (int i = 0; i < none.size() && !result.empty(); i++) {
+    result = Bitmap::subtract(result, facets.get(none[i]));
+  }
+  return result;
+}
+
+/**
+ * Retrieves the titles of the issues matching a combination of facets
+ * @param all Comma separated facets every issue must have
+ * @param any Comma separated facets an issue must have one of
+ * @param none Comma separated facets no issue may have
+ * @return the title of each matching issue, "(BLANK)" if none match
+ */
+std::string IssueTracker::labelQuery(std::string all, std::string any,
+                                     std::string none) {
+  std::vector<uint32_t> ids =
+      matchFacets(facetKeys(all), facetKeys(any), facetKeys(none)).values();
+  if (ids.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < ids.size(); i++) {
+    result += issuesById[ids[i]]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Counts the issues matching a combination of facets by label, type and
+ * OS, for narrowing the query further
+ * @param all Comma separated facets every issue must have
+ * @param any Comma separated facets an issue must have one of
+ * @param none Comma separated facets no issue may have
+ * @return "facet^]count^]" for each facet of a matching issue, after
+ * "total^]count^]"
+ */
+std::string IssueTracker::facetCounts(std::string all, std::string any,
+                                      std::string none) {
+  Bitmap matched = matchFacets(facetKeys(all), facetKeys(any), facetKeys(none));
+  std::string result = "total^]" + std::to_string(matched.cardinality()) + "^]";
+  std::vector<std::pair<std::string, uint64_t>> counts =
+      facets.counts(matched);
+  for (int i = 0; i < counts.size(); i++) {
+    result += counts[i].first + "^]" + std::to_string(counts[i].second) + "^]";
+  }
+  return result;
+}
+
+/**
+ * Retrieves the issues matching a query such as
+ * "type:Bug AND os:Linux AND NOT assignee:user_Removed AND comments>5".
+ * Predicates on type, os, label, user (author), assignee and title are
+ * answered from the indexes, most selective first; only the remaining
+ * predicates (comments, desc) visit issues, and only the candidates the
+ * indexes left.
+ * @param query The query, see QueryParser
+ * @param explain True to describe the plan instead of running it for
+ * titles
+ * @return the title of each matching issue, "(BLANK)" if none match, the
+ * plan with the number of issues examined if explain is set, or
+ * "(ERROR)" and a reason if the query is invalid
+ */
+std::string IssueTracker::filterIssues(std::string query, bool explain) {
+  QueryNode root;
+  std::string error;
+  if (!QueryParser::parse(query, &root, &error) ||
+      !checkQuery(root, &error)) {
+    return "(ERROR) " + error;
+  }
+
+  std::string plan;
+  uint64_t examined;
+  Bitmap matched = evaluate(root, &plan, &examined);
+  if (explain) {
+    return plan + "examined " + std::to_string(examined) + " of " +
+           std::to_string(issues.size()) + " issues, matched " +
+           std::to_string(matched.cardinality()) + "\n";
+  }
+  std::vector<uint32_t> ids = matched.values();
+  if (ids.empty()) return "(BLANK)[^";
+  std::string result;
+  for (int i = 0; i < ids.size(); i++) {
+    result += issuesById[ids[i]]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Saves a filterIssues query under a name and materializes its matches.
+ * The matches are updated whenever an issue changes, so reading the view
+ * never runs the query again. Saving over an existing name replaces it.
+ * @param name Name of the view, which may not contain "^]"
+ * @param query The query, see QueryParser
+ * @return a message with the number of matching issues, or "(ERROR)" and
+ * a reason if the query is invalid
+ */
+std::string IssueTracker::saveView(std::string name, std::string query) {
+  if (name.empty() || name.find("^]") != std::string::npos ||
+      name.find('\n') != std::string::npos) {
+    return "(ERROR) invalid view name";
+  }
+  if (query.find('\n') != std::string::npos ||
+      query.find("^]") != std::string::npos) {
+    return "(ERROR) invalid query";
+  }
+  SavedView view;
+  std::string error;
+  if (!QueryParser::parse(query, &view.root, &error) ||
+      !checkQuery(view.root, &error)) {
+    return "(ERROR) " + error;
+  }
+  view.query = query;
+  std::string plan;
+  uint64_t examined;
+  view.ids = evaluate(view.root, &plan, &examined);
+  uint64_t count = view.ids.cardinality();
+  views[name] = std::move(view);
+
+  changes.record("saveView", name);
+  writeViews();
+  return "View " + name + " saved with " + std::to_string(count) + " issues";
+}
+
+/**
+ * Retrieves the issues of a saved view, at a cost that follows the
+ * number of matches rather than the number of issues
+ * @param name Name of the view
+ * @return the title of each matching issue, "(BLANK)" if none match, or
+ * "(ERROR)" if there is no such view
+ */
+std::string IssueTracker::getView(std::string name) {
+  auto found = views.find(name);
+  if (found == views.end()) return "(ERROR) no view named " + name;
+  std::vector<uint32_t> ids = found->second.ids.values();
+  if (ids.empty()) return "(BLANK)[^";
+  std::string result;
+  for (int i = 0; i < ids.size(); i++) {
+    result += issuesById[ids[i]]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Deletes a saved view
+ * @param name Name of the view
+ * @return a message saying whether the view was deleted
+ */
+std::string IssueTracker::deleteView(std::string name) {
+  if (views.erase(name) == 0) return "(BLANK)";
+  changes.record("deleteView", name);
+  writeViews();
+  return "View " + name + " has been removed.";
+}
+
+/**
+ * Retrieves every saved view
+ * @return "name^]query^]count^]" for each view by name, "(BLANK)" if
+ * there are none
+ */
+std::string IssueTracker::listViews() {
+  if (views.empty()) return "(BLANK)";
+  std::string result;
+  for (auto view = views.begin(); view != views.end(); ++view) {
+    result += view->first + "^]" + view->second.query + "^]" +
+              std::to_string(view->second.ids.cardinality()) + "^]";
+  }
+  return result;
+}
+
+/**
+ * Runs a query, from the indexes where it can be
+ * @param root parsed and checked query
+ * @param plan set to a description of each step
+ * @param examined set to the number of issues visited
+ * @return ids of the matching issues
+ */
+Bitmap IssueTracker::evaluate(const QueryNode& root, std::string* plan,
+                              uint64_t* examined) {
+  *examined = 0;
+  if (!needsScan(root)) return runQuery(root, 0, plan, examined);
+
+  // No index narrows the candidates
+  Bitmap matched;
+  for (int i = 0; i < issues.size(); i++) {
+    if (matchesQuery(issues[i], root)) matched.add(issues[i]->getId());
+  }
+  *examined = issues.size();
+  *plan = "scan " + QueryParser::describe(root) + " on " +
+          std::to_string(*examined) + " issues (" +
+          std::to_string(matched.cardinality()) + " kept)\n";
+  return matched;
+}
+
+/**
+ * Checks whether a query has an index for a predicate
+ * @param term TERM node
+ * @return true if the predicate is answered without visiting issues
+ */
+bool IssueTracker::indexed(const QueryNode& term) {
+  const std::string& f = term.field;
+  if (f == "title") return term.value.size() >= 3;  // Needs a trigram
+  return f == "type" || f == "os" || f == "label" || f == "user" ||
+         f == "author" || f == "assign" || f == "assignee";
+}
+
+/**
+ * Checks whether a query can only be answered by visiting issues
+ * @param node query node
+ * @return true if some predicate without an index decides the result
+ */
+bool IssueTracker::needsScan(const QueryNode& node) {
+  switch (node.kind) {
+    case QueryNode::TERM:
+      return !indexed(node);
+    case QueryNode::NOT:
+      return needsScan(node.children[0]);
+    case QueryNode::OR:  // Every alternative has to come from an index
+      for (size_t i = 0; i < node.children.size(); i++) {
+        if (needsScan(node.children[i])) return true;
+      }
+      return false;
+    default:  // AND: one indexed operand is enough to narrow the rest
+      for (size_t i = 0; i < node.children.size(); i++) {
+        if (!needsScan(node.children[i])) return false;
+      }
+      return true;
+  }
+}
+
+/**
+ * Checks a query against one issue without using any index
+ * @param i Issue pointer
+ * @param node query node
+ * @return true if the issue matches
+ */
+bool IssueTracker::matchesQuery(Issue* i, const QueryNode& node) {
+  switch (node.kind) {
+    case QueryNode::AND:
+      for (size_t c = 0; c < node.children.size(); c++) {
+        if (!matchesQuery(i, node.children[c])) return false;
+      }
+      return true;
+    case QueryNode::OR:
+      for (size_t c = 0; c < node.children.size(); c++) {
+        if (matchesQuery(i, node.children[c])) return true;
+      }
+      return false;
+    case QueryNode::NOT:
+      return !matchesQuery(i, node.children[0]);
+    default:
+      break;
+  }
+
+  const std::string& f = node.field;
+  if (f == "comments") {
+    int64_t count = i->getCommentNum();
+    int64_t value = strtoll(node.value.c_str(), NULL, 10);
+    if (node.op == ">") return count > value;
+    if (node.op == ">=") return count >= value;
+    if (node.op == "<") return count < value;
+    if (node.op == "<=") return count <= value;
+    return count == value;
+  }
+  if (f == "type") return i->getIssueType() == node.value;
+  if (f == "os") return i->getIssueOS() == node.value;
+  if (f == "user" || f == "author") return i->getIssueUser() == node.value;
+  if (f == "assign" || f == "assignee") {
+    return i->getIssueAssignee() == node.value;
+  }
+  if (f == "title") return containsFolded(i->getIssueTitle(), node.value);
+  if (f == "label") {
+    std::vector<std::string> labels = i->getLabels();
+    return std::find(labels.begin(), labels.end(), node.value) !=
+           labels.end();
+  }
+  return containsFolded(i->getIssueDesc(), node.value);  // desc
+}
+
+/**
+ * Gets the issues an index holds for a predicate
+ * @param term TERM node, for which indexed is true
+ * @return ids of the matching issues
+ */
+Bitmap IssueTracker::lookupTerm(const QueryNode& term) {
+  const std::string& f = term.field;
+  if (f == "type" || f == "os" || f == "label") {
+    return facets.get(f + ":" + term.value);
+  }
+
+  Bitmap ids;
+  if (f == "title") {
+    std::vector<std::string> titles =
+        titleGrams.substring(term.value, issues.size());
+    for (int t = 0; t < titles.size(); t++) {
+      // Every issue with the title, as the scan would find
+      const std::vector<Issue*>& same = issuesByTitle[titles[t]];
+      for (int s = 0; s < same.size(); s++) ids.add(same[s]->getId());
+    }
+    return ids;
+  }
+  const PostingIndex& index = f == "user" || f == "author" ? byUser : byAssign;
+  const std::vector<uint64_t>& list = index.get(term.value);
+  for (int l = 0; l < list.size(); l++) ids.add(list[l]);
+  return ids;
+}
+
+/**
+ * Answers a query from the indexes, filtering the candidates they leave
+ * by any predicates that have no index
+ * @param node query node, for which needsScan is false
+ * @param depth nesting depth, for indenting the plan
+ * @param plan set to a description of each step
+ * @param examined incremented by the number of issues visited
+ * @return ids of the matching issues
+ */
+Bitmap IssueTracker::runQuery(const QueryNode& node, int depth,
+                              std::string* plan, uint64_t* examined) {
+  std::string indent(2 * depth, ' ');
+  if (node.kind == QueryNode::TERM) {
+    Bitmap ids = lookupTerm(node);
+    *plan = indent + "index " + QueryParser::describe(node) + " (" +
+            std::to_string(ids.cardinality()) + " ids)\n";
+    return ids;
+  }
+
+  std::string steps;
+  Bitmap result;
+  if (node.kind == QueryNode::NOT) {
+    result = Bitmap::subtract(
+        allIds, runQuery(node.children[0], depth + 1, &steps, examined));
+  } else if (node.kind == QueryNode::OR) {
+    for (size_t c = 0; c < node.children.size(); c++) {
+      std::string step;
+      result = Bitmap::unite(
+          result, runQuery(node.children[c], depth + 1, &step, examined));
+      steps += step;
+    }
+  } else {
+    // Operands with an index are intersected from the most selective up;
+    // the others only check the issues that are left
+    std::vector<std::pair<Bitmap, std::string>> sets;
+    std::vector<const QueryNode*> filters;
+    for (size_t c = 0; c < node.children.size(); c++) {
+      if (needsScan(node.children[c])) {
+        filters.push_back(&node.children[c]);
+      } else {
+        std::string step;
+        Bitmap ids = runQuery(node.children[c], depth + 1, &step, examined);
+        sets.push_back(std::make_pair(std::move(ids), step));
+      }
+    }
+    std::stable_sort(sets.begin(), sets.end(),
+                     [](const std::pair<Bitmap, std::string>& a,
+                        const std::pair<Bitmap, std::string>& b) {
+                       return a.first.cardinality() < b.first.cardinality();
+                     });
+    result = sets[0].first;
+    for (size_t s = 0; s < sets.size(); s++) {
+      if (s > 0) result = Bitmap::intersect(result, sets[s].first);
+      steps += sets[s].second;
+    }
+    if (!filters.empty()) {
+      std::vector<uint32_t> candidates = result.values();
+      Bitmap kept;
+      std::string checks;
+      for (int c = 0; c < candidates.size(); c++) {
+        bool match = true;
+        for (size_t f = 0; f < filters.size() && match; f++) {
+          match = matchesQuery(issuesById[candidates[c]], *filters[f]);
+        }
+        if (match) kept.add(candidates[c]);
+      }
+      for (size_t f = 0; f < filters.size(); f++) {
+        checks += (f > 0 ? " AND " : "") + QueryParser::describe(*filters[f]);
+      }
+      *examined += candidates.size();
+      steps += indent + "  filter " + checks + " on " +
+               std::to_string(candidates.size()) + " issues (" +
+               std::to_string(kept.cardinality()) + " kept)\n";
+      result = kept;
+    }
+  }
+
+  const char* names[] = {"AND", "OR", "NOT"};
+  *plan = indent + names[node.kind] + " (" +
+          std::to_string(result.cardinality()) + " ids)\n" + steps;
+  return result;
+}
+
+/**
+ * Ranks issues against a full-text query over titles, descriptions and
+ * comments using BM25
+ * @param query The search text
+ * @param k Most issues returned
+ * @return the title of each matching issue, best first, or "(BLANK)"
+ */
+std::string IssueTracker::searchIssues(std::string query, size_t k) {
+  std::vector<std::pair<uint64_t, double>> hits = text.search(query, k);
+  if (hits.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < hits.size(); i++) {
+    result += issuesById[hits[i].first]->getIssueTitle() + "[^";
+  }
+  return result;
+}
+
+/**
+ * Finds issues whose title contains a fragment, allowing a few typos
+ * @param fragment The remembered piece of the title
+ * @param maxEdits Most typos allowed, 0 for an exact substring
+ * @param limit Most titles returned
+ * @return the matching titles, closest first, or "(BLANK)" if none match
+ */
+std::string IssueTracker::findIssueTitles(std::string fragment, int maxEdits,
+                                          size_t limit) {
+  std::vector<std::string> titles =
+      titleGrams.fuzzy(fragment, maxEdits, limit);
+  if (titles.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < titles.size(); i++) result += titles[i] + "[^";
+  return result;
+}
+
+/**
+ * Completes the start of an issue title
+ * @param prefix The start typed so far, matched ignoring case
+ * @param limit Most titles returned
+ * @return the first titles alphabetically starting with prefix, or
+ * "(BLANK)" if there are none
+ */
+std::string IssueTracker::completeIssueTitles(std::string prefix,
+                                              size_t limit) {
+  std::vector<std::string> titles = titlePrefixes.complete(prefix, limit);
+  if (titles.empty()) return "(BLANK)[^";
+
+  std::string result;
+  for (int i = 0; i < titles.size(); i++) result += titles[i] + "[^";
+  return result;
+}
+
 /**
  * Creates a new user object and adds them to a vector of users and
  * writes them to a text file
@@ -194,7 +1199,8 @@ std::string IssueTracker::createUser(std::string username) {
     writeFile.close();
     result = username;
     User* newUser = new User(username);
-    users.push_back(newUser);
+    addToUserVec(newUser);
+    changes.record("createUser", username);
   } else {  // If taken, return "(TAKEN)" as result to client
     result = "(TAKEN)";
   }
@@ -238,6 +1244,57 @@ std::string IssueTracker::getAllUsers() {
   return result;
 }
 
+/**
+ * Retrieves one page of usernames in alphabetical order. If more users
+ * follow, the page ends with "(MORE)" and the cursor to resume from.
+ * @param after cursor from the previous page, "" for the first page
+ * @param limit most usernames returned
+ * @return the usernames on the page separated by '-'
+ */
+std::string IssueTracker::getUserPage(const std::string& after,
+                                      size_t limit) {
+  std::string result;
+  size_t count = 0;
+  // The cursor is the last name sent, which stays valid if it is deleted
+  auto it = userNames.upper_bound(after);
+  std::string last = after;
+  for (; it != userNames.end() && count < limit; ++it, count++) {
+    result += *it + '-';
+    last = *it;
+  }
+  if (it != userNames.end()) result += "(MORE)" + last + '-';
+  return result;
+}
+
+/**
+ * Finds users whose name contains a fragment, allowing a few typos
+ * @param fragment The remembered piece of the username
+ * @param maxEdits Most typos allowed, 0 for an exact substring
+ * @param limit Most usernames returned
+ * @return the matching usernames separated by '-', closest first
+ */
+std::string IssueTracker::findUsers(std::string fragment, int maxEdits,
+                                    size_t limit) {
+  std::vector<std::string> names = userGrams.fuzzy(fragment, maxEdits, limit);
+  std::string result;
+  for (int i = 0; i < names.size(); i++) result += names[i] + '-';
+  return result;
+}
+
+/**
+ * Completes the start of a username
+ * @param prefix The start typed so far, matched ignoring case
+ * @param limit Most usernames returned
+ * @return the first usernames alphabetically starting with prefix,
+ * separated by '-'
+ */
+std::string IssueTracker::completeUsers(std::string prefix, size_t limit) {
+  std::vector<std::string> names = userPrefixes.complete(prefix, limit);
+  std::string result;
+  for (int i = 0; i < names.size(); i++) result += names[i] + '-';
+  return result;
+}
+
 /**
  * Deletes an existing user from the users vector as well as from
  * comments and issues and re-writes the text files
@@ -284,14 +1341,31 @@ std::string IssueTracker::deleteUser(std::string username) {
   }
   if (users.size() == 1) {
     users.clear();
+    userNames.clear();
+    userGrams.clear();
+    userPrefixes.clear();
   } else {
     users.erase(users.begin() + index);
+    userNames.erase(vectorRemove);
+    userGrams.remove(vectorRemove);
+    userPrefixes.remove(vectorRemove);
   }
 
   // Delete user from assignee
+  std::vector<bool> touched(issues.size(), false);
   for (int i = 0; i < issues.size(); i++) {
     if (vectorRemove == issues.at(i)->getIssueAssignee()) {
+      byAssign.remove(vectorRemove, issues.at(i)->getId());
       issues.at(i)->setAssignee("");
+      byAssign.add(issues.at(i)->getIssueAssignee(), issues.at(i)->getId());
+      touched[i] = true;
+    }
+    // Authored issues now display "user_Removed"
+    if (vectorRemove == issues.at(i)->getIssueUser()) {
+      byUser.remove(vectorRemove, issues.at(i)->getId());
+      issues.at(i)->setUser("user_Removed");
+      byUser.add(issues.at(i)->getIssueUser(), issues.at(i)->getId());
+      touched[i] = true;
     }
   }
 
@@ -301,6 +1375,18 @@ std::string IssueTracker::deleteUser(std::string username) {
     for (int j = 0; j < issues.at(i)->getCommentNum(); j++) {
       if (vectorRemove == comment.at(j)->getCommentUser()) {
         issues.at(i)->setCommentUser(j);
+        touched[i] = true;
+      }
+    }
+  }
+
+  // Record the removal and every issue it rewrote in the change feed
+  if (!vectorRemove.empty()) {
+    changes.record("removeUser", vectorRemove);
+    for (int i = 0; i < issues.size(); i++) {
+      if (touched[i]) {
+        refreshViews(issues[i]);
+        changes.record("updateIssue", issues[i]->getIssueTitle());
       }
     }
   }
@@ -325,6 +1411,11 @@ void IssueTracker::addToCommentVec(std::string issueTitle, std::string comment,
   for (int i = 0; i < issues.size(); i++) {
     if (issues[i]->getIssueTitle() == issueTitle) {
       issues[i]->addToComments(newComment);
+      text.add(issues[i]->getId(), comment);
+      commentTotal++;
+      activity.record(issues[i]->getId(), clockSeconds());
+      refreshViews(issues[i]);
+      changes.record("addComment", issueTitle);
       writeFile();
       result = "New comment added";  // Result sent back to client
     }
@@ -345,6 +1436,48 @@ std::string IssueTracker::getComments(Issue* issue) {
   return comments;
 }
 
+/**
+ * Gets the changes committed after a version the client has already seen,
+ * or a full snapshot of the issue titles if the client is too far behind
+ * @param since version the client has already seen
+ * @return "(DELTA)" followed by the version and kind/key pairs, or
+ * "(SNAPSHOT)" followed by the version and every issue title
+ */
+std::string IssueTracker::getChangesSince(uint64_t since) {
+  if (!changes.covers(since)) return getSnapshot();  // Client too far behind
+
+  std::string result = "(DELTA)^]" + std::to_string(getVersion()) + "^]";
+  std::vector<Change> delta = changes.since(since);
+  for (int i = 0; i < delta.size(); i++) {
+    result += delta[i].kind + "^]" + delta[i].key + "^]";
+  }
+  return result;
+}
+
+/**
+ * Gets a full snapshot of the issue titles with the current version
+ * @return "(SNAPSHOT)" followed by the version and every issue title
+ */
+std::string IssueTracker::getSnapshot() {
+  std::string result = "(SNAPSHOT)^]" + std::to_string(getVersion()) + "^]";
+  for (int i = 0; i < issues.size(); i++) {
+    result += issues[i]->getIssueTitle() + "^]";
+  }
+  return result;
+}
+
+/**
+ * Gets the changes committed after a version as records
+ * @param since version the caller has already seen
+ * @param delta filled with the changes, oldest first
+ * @return false if that version is no longer covered by the change ring
+ */
+bool IssueTracker::getChangeList(uint64_t since, std::vector<Change>& delta) {
+  if (!changes.covers(since)) return false;
+  delta = changes.since(since);
+  return true;
+}
+
 /**
  * Reads from comments.txt and context.txt when server is first started and
  * extracts data from them in order to parse data and create appropriate
@@ -352,6 +1485,7 @@ std::string IssueTracker::getComments(Issue* issue) {
  * be created and nothing will be extracted.
  */
 void IssueTracker::readFile() {
+  loadingFile = true;  // Text is indexed once every issue is loaded
   std::ifstream saveFile;
   std::ifstream commentFile;
   saveFile.open("context.txt");
@@ -380,6 +1514,22 @@ void IssueTracker::readFile() {
   std::stringstream commentData;
   commentData << commentFile.rdbuf();
   std::string commentContent = commentData.str();
+  storeChecksum = std::to_string(checksum(0, contents)) + " " +
+                  std::to_string(checksum(0, commentContent));
+  // Files written before every issue had a block leave out issues without
+  // comments; those can only be paired with their blocks by title
+  size_t records = 0;
+  for (size_t p = contents.find(delim); p != std::string::npos;
+       p = contents.find(delim, p + delim.length())) {
+    records++;
+  }
+  size_t blocks = 0;
+  for (size_t p = commentContent.find(sep); p != std::string::npos;
+       p = commentContent.find(sep, p + sep.length())) {
+    blocks++;
+  }
+  bool positional = blocks == records / 6;
+
   /**
    * Parses out: title, text, os, type, user, assignee
    * from string based on delimiter
@@ -417,6 +1567,12 @@ void IssueTracker::readFile() {
 
       size_t firstStar = commentContent.find_first_of(sep);
       std::string startDelim = commentContent.substr(0, firstStar);
+      // The next block is this issue's, unless the file leaves out issues
+      // without comments and it belongs to a later one
+      bool ownBlock =
+          positional ||
+          startDelim.substr(0, startDelim.find(delim)) == tempIssueTitle;
+      if (!ownBlock) startDelim.clear();
       // only pass in comments for current issue
       while ((cpos = startDelim.find(delim)) != std::string::npos) {
         ctok = startDelim.substr(0, cpos);
@@ -438,7 +1594,9 @@ void IssueTracker::readFile() {
         }
         startDelim.erase(0, cpos + delim.length());  // erase ^] move on
       }
-      commentContent.erase(0, firstStar + sep.length());  // erase ** move on
+      if (ownBlock) {
+        commentContent.erase(0, firstStar + sep.length());  // erase ** move on
+      }
 
       // PUSHBACK ISSUES
       addToIssueVec(transferI);
@@ -450,13 +1608,67 @@ void IssueTracker::readFile() {
   // CLOSE FILE
   saveFile.close();
 
+  // Reuse the saved search index if it was written for this data, which
+  // also needs the issues to hold the ids it was saved with
+  loadingFile = false;
+  bool savedIds = true;
+  for (int i = 0; i < issues.size(); i++) {
+    if (issues[i]->getId() != i + 1) savedIds = false;
+  }
+  indexSaved = savedIds && text.load("search.idx", storeChecksum);
+  if (!indexSaved) {
+    text.clear();
+    for (int i = 0; i < issues.size(); i++) {
+      text.add(issues[i]->getId(), issueText(issues[i]));
+    }
+  }
+
+  // Labels of each issue, which are not part of context.txt
+  std::ifstream labelFile("labels.txt");
+  std::string line;
+  while (getline(labelFile, line)) {
+    size_t end = line.find(delim);
+    if (end == std::string::npos) continue;
+    Issue* issue = latestIssue(line.substr(0, end));
+    if (issue == NULL) continue;
+    for (size_t start = end + delim.length();
+         (end = line.find(delim, start)) != std::string::npos;
+         start = end + delim.length()) {
+      labelIssue(issue, line.substr(start, end - start));
+    }
+  }
+  labelFile.close();
+
+  // Saved views, one "name ^] query ^]" line each, matched against the
+  // issues just loaded
+  std::ifstream viewFile("views.txt");
+  while (getline(viewFile, line)) {
+    size_t end = line.find(delim);
+    if (end == std::string::npos) continue;
+    size_t queryEnd = line.find(delim, end + delim.length());
+    if (queryEnd == std::string::npos) continue;
+    SavedView view;
+    std::string error;
+    view.query = line.substr(end + delim.length(),
+                             queryEnd - end - delim.length());
+    if (!QueryParser::parse(view.query, &view.root, &error) ||
+        !checkQuery(view.root, &error)) {
+      continue;
+    }
+    std::string plan;
+    uint64_t examined;
+    view.ids = evaluate(view.root, &plan, &examined);
+    views[line.substr(0, end)] = std::move(view);
+  }
+  viewFile.close();
+
   std::ifstream userFile;
   std::string name = "";
   userFile.open("users.txt");
   if (userFile) {
     while (getline(userFile, name)) {
       User* newUser = new User(name);
-      users.push_back(newUser);
+      addToUserVec(newUser);
     }
   }
   userFile.close();
@@ -475,6 +1687,8 @@ void IssueTracker::writeFile() {
   ISSUE OSTYPE
   */
   // TEXT
+  TraceSpan span("writeFile");
+  auto started = std::chrono::steady_clock::now();
   std::ofstream saveFile;
   std::ofstream commentFile;
   saveFile.open("context.txt");
@@ -494,6 +1708,8 @@ void IssueTracker::writeFile() {
   bool delUser = true;
   bool delAssign = true;
   bool delCommentUser = true;
+  uLong contextCrc = 0;
+  uLong commentCrc = 0;
   for (int i = 0; i < issues.size(); i++) {
     std::string title = issues.at(i)->getIssueTitle();
     std::string text = issues.at(i)->getIssueDesc();
@@ -523,8 +1739,10 @@ void IssueTracker::writeFile() {
       assign = "user_Removed";
     }
     // CONTEXT.TXT---
-    saveFile << title << "^]" << text << "^]" << os << "^]" << type << "^]"
-             << user << "^]" << assign << "^]";
+    std::string record = title + "^]" + text + "^]" + os + "^]" + type +
+                         "^]" + user + "^]" + assign + "^]";
+    saveFile << record;
+    contextCrc = checksum(contextCrc, record);
     // COMMENTS.TXT---
     std::vector<Comment*> cWrite = issues.at(i)->getCommentVec();
 
@@ -538,21 +1756,78 @@ void IssueTracker::writeFile() {
         }
       }
     }
-    if (!cWrite.empty()) {
-      commentFile << title << "^]";
+    // Every issue gets a block, empty or not, so readFile can pair them
+    // by position even when titles repeat
+    {
+      std::string block = title + "^]";
       for (int j = 0; j < issues.at(i)->getCommentNum(); j++) {
-        commentFile << cWrite.at(j)->getCommentText() << "^]";
+        block += cWrite.at(j)->getCommentText() + "^]";
         if (delCommentUser == true) {
-          commentFile << "userRemoved"
-                      << "^]";
+          block += "userRemoved^]";
         } else {
-          commentFile << cWrite.at(j)->getCommentUser() << "^]";
+          block += cWrite.at(j)->getCommentUser() + "^]";
         }
       }
-      commentFile << "**";  // seperate comments per issue title
+      block += "**";  // seperate comments per issue
+      commentFile << block;
+      commentCrc = checksum(commentCrc, block);
     }
   }
   // CLOSE FILE
+  uint64_t bytes = std::max<int64_t>(saveFile.tellp(), 0) +
+                   std::max<int64_t>(commentFile.tellp(), 0);
   saveFile.close();
   commentFile.close();
+
+  // LABELS.TXT--- one line per labelled issue: title ^] label ^] ...
+  std::ofstream labelFile("labels.txt");
+  for (int i = 0; i < issues.size(); i++) {
+    std::vector<std::string> labels = issues[i]->getLabels();
+    if (labels.empty()) continue;
+    labelFile << issues[i]->getIssueTitle() << "^]";
+    for (int l = 0; l < labels.size(); l++) labelFile << labels[l] << "^]";
+    labelFile << '\n';
+  }
+  bytes += std::max<int64_t>(labelFile.tellp(), 0);
+  labelFile.close();
+
+  // search.idx lags the store until saveIndex catches it up
+  storeChecksum =
+      std::to_string(contextCrc) + " " + std::to_string(commentCrc);
+  indexSaved = false;
+
+  writeCount++;
+  writeBytes += bytes;
+  writeMicros += std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - started)
+                     .count();
+}
+
+/**
+ * Writes the saved views to views.txt
+ */
+void IssueTracker::writeViews() {
+  std::ofstream viewFile("views.txt");
+  for (auto view = views.begin(); view != views.end(); ++view) {
+    viewFile << view->first << "^]" << view->second.query << "^]\n";
+  }
+  viewFile.close();
+}
+
+/**
+ * Saves the search index to search.idx, stamped with the checksums of
+ * the store files it matches, if the store changed since the index was
+ * last saved or loaded
+ * @return true if the index was written
+ */
+bool IssueTracker::saveIndex() {
+  if (indexSaved) return false;
+  // Ids are saved as file positions, which readFile reassigns
+  std::unordered_map<uint64_t, uint64_t> positions;
+  for (int i = 0; i < issues.size(); i++) {
+    positions[issues[i]->getId()] = i + 1;
+  }
+  text.save("search.idx", positions, storeChecksum);
+  indexSaved = true;
+  return true;
 }
@@ -111,6 +111,73 @@ void IssueTrackerUI::displayIssues() {
   std::cin >> returnHome;
 }
 
+/**
+ *  Prompts user for the filters of an issue search, blank for any value
+ *  @param os operating system filter
+ *  @param type issue type filter
+ *  @param user author filter
+ *  @param assign assignee filter
+ */
+void IssueTrackerUI::enterIssueFilters(std::string& os, std::string& type,
+                                       std::string& user,
+                                       std::string& assign) {
+  printf("\e[1;1H\e[2J");  // "Clear" the screen
+  std::cout << "\nWhite Water Reporting - Find Issues" << std::endl;
+  std::cout << "Leave a filter blank to match anything." << std::endl;
+  std::cin.ignore();
+  std::cout << "\nOperating System (Linux/MacOS/Windows): " << std::endl;
+  std::getline(std::cin, os);
+  std::cout << "\nIssue Type (Feature/Bug/Task): " << std::endl;
+  std::getline(std::cin, type);
+  std::cout << "\nAuthor: " << std::endl;
+  std::getline(std::cin, user);
+  std::cout << "\nAssignee: " << std::endl;
+  std::getline(std::cin, assign);
+}
+
+/**
+ *  Prompts user for the text of a full-text search
+ *  @return the search text
+ */
+std::string IssueTrackerUI::enterSearch() {
+  printf("\e[1;1H\e[2J");  // "Clear" the screen
+  std::cout << "\nWhite Water Reporting - Search Issues" << std::endl;
+  std::cout << "\nSearch titles, descriptions and comments for: " << std::endl;
+  std::string query;
+  std::cin.ignore();
+  std::getline(std::cin, query);
+  return query;
+}
+
+/**
+ *  Prompts user for the start or part of an issue title, blank to list
+ *  every issue
+ *  @return the title fragment
+ */
+std::string IssueTrackerUI::enterTitleFragment() {
+  printf("\e[1;1H\e[2J");  // "Clear" the screen
+  std::cout << "\nWhite Water Reporting - Retrieve an Issue" << std::endl;
+  std::cout << "\nStart of the issue title (leave blank to list all): "
+            << std::endl;
+  std::string fragment;
+  std::cin.ignore();
+  std::getline(std::cin, fragment);
+  return fragment;
+}
+
+/**
+ *  Prompts user for the first letters of the user to assign an issue to
+ *  @return the username prefix, blank for the first users alphabetically
+ */
+std::string IssueTrackerUI::enterAssigneePrefix() {
+  std::cout << "\nAssignee's username starts with (leave blank to list "
+               "users): "
+            << std::endl;
+  std::string prefix;
+  std::getline(std::cin, prefix);
+  return prefix;
+}
+
 /**
  *  Displays main menu and all available options
  */
@@ -124,6 +191,8 @@ void IssueTrackerUI::displayMainMenu() {
   std::cout << "\t(1) Retrieve an Issue" << std::endl;
   std::cout << "\t(2) List All Issues" << std::endl;
   std::cout << "\t(3) Delete an Issue" << std::endl;
+  std::cout << "\t(8) Find Issues" << std::endl;
+  std::cout << "\t(9) Search Issues" << std::endl;
   std::cout << "\nUser Options:" << std::endl;
   std::cout << "\t(4) List All Users" << std::endl;
   std::cout << "\t(5) Delete Your Account" << std::endl;
@@ -139,7 +208,7 @@ void IssueTrackerUI::displayMainMenu() {
 int IssueTrackerUI::mainMenuChoice() {
   // User input error checking for available menu options
   int menuChoice;
-  while (!(std::cin >> menuChoice) || menuChoice < 0 || menuChoice > 7) {
+  while (!(std::cin >> menuChoice) || menuChoice < 0 || menuChoice > 9) {
     std::cout << "INVALID INPUT\n ";
     std::cin.clear();
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -207,20 +276,19 @@ std::string IssueTrackerUI::loginUser() {
 
 /**
  *  Displays issue creation page and takes in user input as fields for issues
- *  in order to create a new issue
+ *  in order to create a new issue. The assignee is picked afterwards from
+ *  the usernames completing enterAssigneePrefix.
  *  @param title issue title
  *  @param desc issue description
  *  @param os operating system of machine(s) affected by issue
  *  @param type type of issues (bug/feature/task)
  *  @param user author of issue
- *  @param assign user assigned to issue
  */
 void IssueTrackerUI::enterIssueFields(std::string& title, std::string& desc,
                                       std::string& os, std::string& type,
-                                      std::string& user, std::string& assign) {
+                                      std::string& user) {
   int osSelect = -1;
   int typeSelect = -1;
-  int userSelect = -1;
   bool titleMatch = false;
   printf("\e[1;1H\e[2J");  // "Clear" the screen
   std::cout << "\nWhite Water Reporting - Create Issue" << std::endl;
@@ -291,9 +359,8 @@ void IssueTrackerUI::enterIssueFields(std::string& title, std::string& desc,
   }
   // User creating the issue is automatically set as author
   user = getActiveUser();
-  // User assigns issue to an active user (can be themself)
-  userSelect = selectAssignee();
-  assign = issueData[userSelect];
+  // Leaves the line clear for enterAssigneePrefix
+  std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
 /**
@@ -355,12 +422,24 @@ void IssueTrackerUI::parseMessage(std::string message) {
       }
     }
   }
+
+  // Paged messages end with "(MORE)" and the cursor of the next page
+  std::vector<std::string>& items =
+      foundTitle != std::string::npos && found == std::string::npos
+          ? titleData
+          : issueData;
+  nextCursor = "";
+  if (!items.empty() && items.back().compare(0, 6, "(MORE)") == 0) {
+    nextCursor = items.back().substr(6);
+    items.pop_back();
+  }
 }
 
 /**
- *  Lists all active users
+ *  Lists one page of active users
+ *  @return true if the user asked for the next page
  */
-void IssueTrackerUI::listAllUsers() {
+bool IssueTrackerUI::listAllUsers() {
   printf("\e[1;1H\e[2J");  // "Clear" the screen
   std::cout << "\nWhite Water Reporting - All Active Users" << std::endl;
 
@@ -374,10 +453,17 @@ void IssueTrackerUI::listAllUsers() {
     std::cout << "\nNo active users found." << std::endl;
   }
 
-  // Prompts user to return to main menu
+  // Prompts user for the next page or to return to main menu
   std::string returnHome;
+  if (!nextCursor.empty()) {
+    std::cout << "\nEnter n for more users or any other key to return home."
+              << std::endl;
+    std::cin >> returnHome;
+    return returnHome == "n";
+  }
   std::cout << "\nPress any key to return home." << std::endl;
   std::cin >> returnHome;
+  return false;
 }
 
 /**
@@ -592,17 +678,22 @@ std::string IssueTrackerUI::displaySingleIssue() {
      * Performs input error checking as well
      */
     int selection;
-    while ((std::cout << "\nWhat would you like to do next?"
-                      << "\n\t(0) Add a comment"
-                      << "\n\t(1) Return home" << std::endl) &&
-               !(std::cin >> selection) ||
-           selection < 0 || selection > 1) {
+    int options = nextCursor.empty() ? 1 : 2;  // More comments to page to
+    while (((std::cout << "\nWhat would you like to do next?"
+                       << "\n\t(0) Add a comment"
+                       << "\n\t(1) Return home"
+                       << (options == 2 ? "\n\t(2) Show more comments" : "")
+                       << std::endl) &&
+            !(std::cin >> selection)) ||
+           selection < 0 || selection > options) {
       std::cout << "INVALID INPUT\n";
       std::cin.clear();
       std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
     if (selection == 0) {
       comment = addComment();
+    } else if (selection == 2) {
+      comment = "(MoreComments)";
     } else {
       comment =
           "(NoComment)";  // Returns (NoComment) in order to skip commenting
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Values below 2^SUB_BITS are counted exactly; above that every power of
+ * two range is split into 2^(SUB_BITS - 1) buckets
+ */
+static const int SUB_BITS = 7;
+static const uint64_t SUB_COUNT = 1 << SUB_BITS;
+static const uint64_t HALF_COUNT = SUB_COUNT / 2;
+static const size_t BUCKETS = SUB_COUNT + (64 - SUB_BITS) * HALF_COUNT;
+
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKETS, 0), total(0), smallest(0), largest(0), sum(0) {}
+
+/**
+ * Records a value
+ * @param value the latency, in whatever unit the caller uses throughout
+ */
+void LatencyHistogram::record(uint64_t value) {
+  counts[bucketOf(value)]++;
+  if (total == 0 || value < smallest) smallest = value;
+  if (value > largest) largest = value;
+  total++;
+  sum += value;
+}
+
+/**
+ * Adds every value recorded by another histogram
+ * @param other the histogram
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  if (other.total == 0) return;
+  for (size_t b = 0; b < BUCKETS; b++) counts[b] += other.counts[b];
+  if (total == 0 || other.smallest < smallest) smallest = other.smallest;
+  largest = std::max(largest, other.largest);
+  total += other.total;
+  sum += other.sum;
+}
+
+/**
+ * Gets the value below which a share of the recorded values fall
+ * @param percent share of the values, from 0 to 100
+ * @return the percentile, 0 if nothing was recorded
+ */
+uint64_t LatencyHistogram::percentile(double percent) const {
+  if (total == 0) return 0;
+  double wanted = percent / 100 * total;
+  uint64_t rank = wanted < 1 ? 1 : static_cast<uint64_t>(wanted + 0.5);
+  if (rank > total) rank = total;
+  uint64_t seen = 0;
+  for (size_t b = 0; b < BUCKETS; b++) {
+    seen += counts[b];
+    if (seen >= rank) {
+      return std::max(smallest, std::min(largest, highestIn(b)));
+    }
+  }
+  return largest;
+}
+
+/**
+ * Gets the number of values recorded
+ * @return number of values
+ */
+uint64_t LatencyHistogram::count() const { return total; }
+
+/**
+ * Gets the smallest value recorded
+ * @return the minimum, 0 if nothing was recorded
+ */
+uint64_t LatencyHistogram::min() const { return smallest; }
+
+/**
+ * Gets the largest value recorded
+ * @return the maximum, 0 if nothing was recorded
+ */
+uint64_t LatencyHistogram::max() const { return largest; }
+
+/**
+ * Gets the average of the values recorded
+ * @return the mean, 0 if nothing was recorded
+ */
+double LatencyHistogram::mean() const { return total ? sum / total : 0; }
+
+/**
+ * Removes every value
+ */
+void LatencyHistogram::clear() {
+  std::fill(counts.begin(), counts.end(), 0);
+  total = smallest = largest = 0;
+  sum = 0;
+}
+
+/**
+ * Finds the bucket counting a value
+ * @param value the value
+ * @return index into counts
+ */
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+  if (value < SUB_COUNT) return value;
+  int top = 63 - __builtin_clzll(value);
+  int shift = top - (SUB_BITS - 1);  // Keeps the SUB_BITS highest bits
+  return SUB_COUNT + (shift - 1) * HALF_COUNT +
+         ((value >> shift) - HALF_COUNT);
+}
+
+/**
+ * Gets the largest value a bucket counts
+ * @param bucket index into counts
+ * @return the value reported for the bucket
+ */
+uint64_t LatencyHistogram::highestIn(size_t bucket) {
+  if (bucket < SUB_COUNT) return bucket;
+  int shift = (bucket - SUB_COUNT) / HALF_COUNT + 1;
+  uint64_t high = (bucket - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+  return ((high + 1) << shift) - 1;
+}
@@ -0,0 +1,293 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "Metrics.h"
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+/**
+ * Source of Metrics ids
+ */
+static std::atomic<uint64_t> nextId(1);
+
+/**
+ * Adds to a counter only the calling thread writes, without the cost of
+ * an atomic read-modify-write
+ * @param counter the counter
+ * @param amount what to add
+ */
+static inline void bump(std::atomic<uint64_t>* counter, uint64_t amount) {
+  counter->store(counter->load(std::memory_order_relaxed) + amount,
+                 std::memory_order_relaxed);
+}
+
+/**
+ * Formats a number the way Prometheus reads it
+ * @param value the number
+ * @return the value to 15 significant digits, e.g. "1e-06"
+ */
+static std::string number(double value) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.15g", value);
+  return text;
+}
+
+/**
+ * @param prefix start of every metric name, e.g. "issueserver"
+ * @param operations name of each operation, by number
+ */
+Metrics::Metrics(const std::string& prefix,
+                 const std::vector<std::string>& operations)
+    : prefix(prefix), operations(operations), id(nextId++) {}
+
+/**
+ * Records one request; safe to call from any thread
+ * @param operation number of the operation, out of range ones ignored
+ * @param micros how long it took
+ * @param failed whether it failed
+ */
+void Metrics::observe(size_t operation, uint64_t micros, bool failed) {
+  if (operation >= operations.size()) return;
+  Slot& slot = shard()->slots[operation];
+  // Bucket i holds latencies up to 2^i microseconds
+  int bucket = micros <= 1 ? 0 : 64 - __builtin_clzll(micros - 1);
+  if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+  bump(&slot.count, 1);
+  bump(&slot.micros, micros);
+  bump(&slot.buckets[bucket], 1);
+  if (failed) bump(&slot.errors, 1);
+}
+
+/**
+ * Records what one request allocated; safe to call from any thread
+ * @param operation number of the operation, out of range ones ignored
+ * @param allocations heap allocations it made
+ * @param bytes bytes they asked for
+ */
+void Metrics::observeAllocations(size_t operation, uint64_t allocations,
+                                 uint64_t bytes) {
+  if (operation >= operations.size()) return;
+  Slot& slot = shard()->slots[operation];
+  bump(&slot.allocations, allocations);
+  bump(&slot.allocatedBytes, bytes);
+}
+
+/**
+ * Sums an operation over all threads
+ * @param operation number of the operation
+ * @return its totals
+ */
+Metrics::Totals Metrics::totals(size_t operation) {
+  Totals sum = {};
+  if (operation >= operations.size()) return sum;
+  std::lock_guard<std::mutex> guard(lock);
+  for (auto shard = shards.begin(); shard != shards.end(); ++shard) {
+    const Slot& slot = shard->second->slots[operation];
+    sum.count += slot.count.load(std::memory_order_relaxed);
+    sum.errors += slot.errors.load(std::memory_order_relaxed);
+    sum.micros += slot.micros.load(std::memory_order_relaxed);
+    for (int b = 0; b < BUCKETS; b++) {
+      sum.buckets[b] += slot.buckets[b].load(std::memory_order_relaxed);
+    }
+    sum.allocations += slot.allocations.load(std::memory_order_relaxed);
+    sum.allocatedBytes +=
+        slot.allocatedBytes.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+/**
+ * Formats the request counters and histograms, leaving out histograms of
+ * operations never requested, and allocations per request if any were
+ * recorded
+ * @return Prometheus text exposition lines
+ */
+std::string Metrics::format() {
+  std::vector<Totals> all(operations.size());
+  for (size_t op = 0; op < operations.size(); op++) all[op] = totals(op);
+
+  std::string out;
+  std::string name = prefix + "_requests_total";
+  out += "# HELP " + name + " Requests handled, by operation.\n";
+  out += "# TYPE " + name + " counter\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    out += name + "{op=\"" + operations[op] + "\"} " +
+           std::to_string(all[op].count) + "\n";
+  }
+  name = prefix + "_request_errors_total";
+  out += "# HELP " + name + " Requests that failed, by operation.\n";
+  out += "# TYPE " + name + " counter\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    out += name + "{op=\"" + operations[op] + "\"} " +
+           std::to_string(all[op].errors) + "\n";
+  }
+
+  name = prefix + "_request_duration_seconds";
+  out += "# HELP " + name + " Time to handle a request, by operation.\n";
+  out += "# TYPE " + name + " histogram\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    if (all[op].count == 0) continue;
+    std::string label = "{op=\"" + operations[op] + "\",le=\"";
+    uint64_t cumulative = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+      cumulative += all[op].buckets[b];
+      std::string bound =
+          b == BUCKETS - 1 ? "+Inf" : number((1ULL << b) / 1e6);
+      out += name + "_bucket" + label + bound + "\"} " +
+             std::to_string(cumulative) + "\n";
+    }
+    out += name + "_sum{op=\"" + operations[op] + "\"} " +
+           number(all[op].micros / 1e6) + "\n";
+    out += name + "_count{op=\"" + operations[op] + "\"} " +
+           std::to_string(all[op].count) + "\n";
+  }
+
+  uint64_t allocations = 0;
+  for (size_t op = 0; op < operations.size(); op++) {
+    allocations += all[op].allocations;
+  }
+  if (allocations == 0) return out;
+  name = prefix + "_request_allocations_total";
+  out += "# HELP " + name + " Heap allocations made, by operation.\n";
+  out += "# TYPE " + name + " counter\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    out += name + "{op=\"" + operations[op] + "\"} " +
+           std::to_string(all[op].allocations) + "\n";
+  }
+  name = prefix + "_request_allocated_bytes_total";
+  out += "# HELP " + name + " Bytes heap allocations asked for, by "
+         "operation.\n";
+  out += "# TYPE " + name + " counter\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    out += name + "{op=\"" + operations[op] + "\"} " +
+           std::to_string(all[op].allocatedBytes) + "\n";
+  }
+  // Averages since startup, readable without a query
+  name = prefix + "_allocations_per_request";
+  out += "# HELP " + name + " Mean heap allocations per request, by "
+         "operation.\n";
+  out += "# TYPE " + name + " gauge\n";
+  for (size_t op = 0; op < operations.size(); op++) {
+    if (all[op].count == 0) continue;
+    out += name + "{op=\"" + operations[op] + "\"} " +
+           number(static_cast<double>(all[op].allocations) / all[op].count) +
+           "\n";
+  }
+  return out;
+}
+
+/**
+ * Appends one gauge or counter in the Prometheus text format
+ * @param out text to append to
+ * @param name metric name
+ * @param type "gauge" or "counter"
+ * @param help description of the metric
+ * @param value the value
+ */
+void Metrics::append(std::string* out, const std::string& name,
+                     const std::string& type, const std::string& help,
+                     double value) {
+  *out += "# HELP " + name + " " + help + "\n";
+  *out += "# TYPE " + name + " " + type + "\n";
+  *out += name + " " + number(value) + "\n";
+}
+
+/**
+ * Gets the resident memory of this process
+ * @return bytes in RAM, 0 if unknown
+ */
+uint64_t Metrics::residentBytes() {
+  // The second field of statm is the resident size in pages
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm == NULL) return 0;
+  unsigned long long pages = 0;  // NOLINT
+  unsigned long long resident = 0;  // NOLINT
+  int read = fscanf(statm, "%llu %llu", &pages, &resident);
+  fclose(statm);
+  if (read != 2) return 0;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Reads the state of the malloc heap from malloc_info
+ * @param stats filled in with the heap totals
+ * @return false if malloc_info is unavailable or could not be read
+ */
+bool Metrics::heapStats(HeapStats* stats) {
+  *stats = HeapStats();
+  char* xml = NULL;
+  size_t length = 0;
+  FILE* out = open_memstream(&xml, &length);
+  if (out == NULL) return false;
+  int failed = malloc_info(0, out);
+  fclose(out);
+  std::string info(xml, length);
+  free(xml);
+  if (failed != 0) return false;
+
+  // Totals over every arena follow the last per-arena <heap> element
+  for (size_t at = info.find("<heap nr="); at != std::string::npos;
+       at = info.find("<heap nr=", at + 1)) {
+    stats->arenas++;
+  }
+  size_t end = info.rfind("</heap>");
+  std::string totals = info.substr(end == std::string::npos ? 0 : end);
+  std::istringstream lines(totals);
+  std::string line;
+  while (getline(lines, line)) {
+    unsigned long long count = 0;  // NOLINT
+    unsigned long long size = 0;  // NOLINT
+    char type[16];
+    if (sscanf(line.c_str(), " <total type=\"%15[a-z]\" count=\"%llu\" "
+               "size=\"%llu\"", type, &count, &size) == 3) {
+      if (strcmp(type, "mmap") == 0) {
+        stats->mmapChunks = count;
+        stats->mmapBytes = size;
+      } else {  // fast and rest: free chunks in fastbins and other bins
+        stats->freeChunks += count;
+        stats->freeBytes += size;
+      }
+    } else if (sscanf(line.c_str(), " <system type=\"%15[a-z]\" "
+                      "size=\"%llu\"", type, &size) == 2) {
+      if (strcmp(type, "current") == 0) stats->systemBytes = size;
+      if (strcmp(type, "max") == 0) stats->maxSystemBytes = size;
+    }
+  }
+  return stats->systemBytes > 0;
+}
+
+/**
+ * Gets the calling thread's shard, creating it on first use
+ * @return the shard
+ */
+Metrics::Shard* Metrics::shard() {
+  thread_local uint64_t cachedId = 0;
+  thread_local Shard* cached = NULL;
+  if (cachedId == id) return cached;
+
+  std::lock_guard<std::mutex> guard(lock);
+  std::unique_ptr<Shard>& mine = shards[std::this_thread::get_id()];
+  if (!mine) {
+    mine.reset(new Shard());
+    // Value-initialized, so every counter starts at zero
+    mine->slots.reset(new Slot[operations.size()]());
+  }
+  cachedId = id;
+  cached = mine.get();
+  return cached;
+}
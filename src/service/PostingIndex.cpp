@@ -0,0 +1,102 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "PostingIndex.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * Adds an issue to the posting list of a value
+ * @param value field value of the issue
+ * @param id issue id
+ */
+void PostingIndex::add(const std::string& value, uint64_t id) {
+  std::vector<uint64_t>& list = postings[value];
+  if (list.empty() || list.back() < id) {  // Usual case: newest issue
+    list.push_back(id);
+    return;
+  }
+  auto pos = std::lower_bound(list.begin(), list.end(), id);
+  if (pos == list.end() || *pos != id) list.insert(pos, id);
+}
+
+/**
+ * Removes an issue from the posting list of a value
+ * @param value field value the issue was indexed under
+ * @param id issue id
+ */
+void PostingIndex::remove(const std::string& value, uint64_t id) {
+  auto found = postings.find(value);
+  if (found == postings.end()) return;
+  std::vector<uint64_t>& list = found->second;
+  auto pos = std::lower_bound(list.begin(), list.end(), id);
+  if (pos != list.end() && *pos == id) list.erase(pos);
+  if (list.empty()) postings.erase(found);  // Drop values nobody has
+}
+
+/**
+ * Gets the ids of the issues with a value
+ * @param value field value
+ * @return sorted issue ids, empty if no issue has the value
+ */
+const std::vector<uint64_t>& PostingIndex::get(
+    const std::string& value) const {
+  static const std::vector<uint64_t> none;
+  auto found = postings.find(value);
+  return found == postings.end() ? none : found->second;
+}
+
+/**
+ * Checks whether an issue is indexed under a value
+ * @param value field value
+ * @param id issue id
+ * @return true if the issue has the value
+ */
+bool PostingIndex::contains(const std::string& value, uint64_t id) const {
+  const std::vector<uint64_t>& list = get(value);
+  return std::binary_search(list.begin(), list.end(), id);
+}
+
+/**
+ * Gets the distinct values that have at least one issue
+ * @return number of posting lists
+ */
+size_t PostingIndex::size() const { return postings.size(); }
+
+/**
+ * Gets the number of issues with each value, read off the posting lists
+ * @return value and issue count pairs, in no particular order
+ */
+std::vector<std::pair<std::string, size_t>> PostingIndex::counts() const {
+  std::vector<std::pair<std::string, size_t>> result;
+  result.reserve(postings.size());
+  for (auto it = postings.begin(); it != postings.end(); ++it) {
+    result.push_back(std::make_pair(it->first, it->second.size()));
+  }
+  return result;
+}
+
+/**
+ * Gets the approximate memory held by the index
+ * @return bytes used by the values and posting lists
+ */
+size_t PostingIndex::bytes() const {
+  size_t used = postings.bucket_count() * sizeof(void*);
+  for (auto it = postings.begin(); it != postings.end(); ++it) {
+    used += sizeof(*it) + 2 * sizeof(void*) + StringBytes::heap(it->first) +
+            it->second.capacity() * sizeof(uint64_t);
+  }
+  return used;
+}
+
+/**
+ * Removes every posting list
+ */
+void PostingIndex::clear() { postings.clear(); }
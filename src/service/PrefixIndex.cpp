@@ -0,0 +1,107 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "PrefixIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * Orders strings ignoring case
+ * @param a first string
+ * @param b second string
+ * @return true if a sorts before b when both are lowercased
+ */
+bool PrefixIndex::foldedBefore(const std::string& a, const std::string& b) {
+  size_t common = std::min(a.size(), b.size());
+  for (size_t i = 0; i < common; i++) {
+    int x = tolower(static_cast<unsigned char>(a[i]));
+    int y = tolower(static_cast<unsigned char>(b[i]));
+    if (x != y) return x < y;
+  }
+  return a.size() < b.size();
+}
+
+/**
+ * Orders strings ignoring case, then by exact bytes
+ * @param a first string
+ * @param b second string
+ * @return true if a sorts before b
+ */
+bool PrefixIndex::before(const std::string& a, const std::string& b) {
+  if (foldedBefore(a, b)) return true;
+  if (foldedBefore(b, a)) return false;
+  return a < b;  // Same letters, different case
+}
+
+/**
+ * Adds a string
+ * @param key the string
+ */
+void PrefixIndex::add(const std::string& key) {
+  auto pos = std::lower_bound(sorted.begin(), sorted.end(), key, before);
+  if (pos == sorted.end() || *pos != key) sorted.insert(pos, key);
+}
+
+/**
+ * Removes a string
+ * @param key the string
+ */
+void PrefixIndex::remove(const std::string& key) {
+  auto pos = std::lower_bound(sorted.begin(), sorted.end(), key, before);
+  if (pos != sorted.end() && *pos == key) sorted.erase(pos);
+}
+
+/**
+ * Gets the first strings, in alphabetical order, starting with a prefix
+ * @param prefix the start typed so far, matched ignoring case
+ * @param limit most strings returned
+ * @return the completions
+ */
+std::vector<std::string> PrefixIndex::complete(const std::string& prefix,
+                                               size_t limit) {
+  std::vector<std::string> completions;
+  // A prefix sorts before everything it starts, whatever their case
+  auto pos =
+      std::lower_bound(sorted.begin(), sorted.end(), prefix, foldedBefore);
+  for (; pos != sorted.end() && completions.size() < limit; ++pos) {
+    if (pos->size() < prefix.size()) break;
+    bool starts = true;
+    for (size_t i = 0; i < prefix.size() && starts; i++) {
+      starts = tolower(static_cast<unsigned char>((*pos)[i])) ==
+               tolower(static_cast<unsigned char>(prefix[i]));
+    }
+    if (!starts) break;  // Past the run of completions
+    completions.push_back(*pos);
+  }
+  return completions;
+}
+
+/**
+ * Gets the number of indexed strings
+ * @return number of strings
+ */
+size_t PrefixIndex::size() { return sorted.size(); }
+
+/**
+ * Gets the approximate memory held by the index
+ * @return bytes used by the array and its strings
+ */
+size_t PrefixIndex::bytes() {
+  size_t used = sorted.capacity() * sizeof(std::string);
+  for (size_t i = 0; i < sorted.size(); i++) {
+    used += StringBytes::heap(sorted[i]);
+  }
+  return used;
+}
+
+/**
+ * Removes every string
+ */
+void PrefixIndex::clear() { sorted.clear(); }
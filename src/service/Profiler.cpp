@@ -0,0 +1,254 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "Profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+const int Profiler::MAX_DEPTH;
+static const int STRIDE = Profiler::MAX_DEPTH;
+
+/**
+ * Largest gap between one frame and its caller's; anything further is
+ * taken to be a register that no longer holds a frame pointer
+ */
+static const uintptr_t MAX_FRAME_SIZE = 1 << 20;
+
+/**
+ * Guards starting and stopping
+ */
+static std::mutex profilerLock;
+static bool started = false;
+
+/**
+ * Sample i keeps its frames at frames[i * STRIDE] and its depth at
+ * depths[i], stored last so a sample is only read once complete. The
+ * buffers outlive stop, so a signal still in flight writes to valid memory.
+ */
+static std::unique_ptr<void*[]> frames;
+static std::unique_ptr<std::atomic<int>[]> depths;
+static std::atomic<size_t> sampleCapacity(0);
+static std::atomic<size_t> nextSample(0);
+static std::atomic<uint64_t> droppedSamples(0);
+
+/**
+ * Reads a frame record, the caller's frame pointer followed by the return
+ * address, without faulting if the address turns out not to be one
+ * @param frame where the record should be
+ * @param record set to the two words
+ * @return false if the memory cannot be read
+ */
+static bool read_frame(uintptr_t frame, uintptr_t record[2]) {
+  iovec local = {record, 2 * sizeof(uintptr_t)};
+  iovec remote = {reinterpret_cast<void*>(frame), 2 * sizeof(uintptr_t)};
+  return process_vm_readv(getpid(), &local, 1, &remote, 1, 0) ==
+         static_cast<ssize_t>(2 * sizeof(uintptr_t));
+}
+
+/**
+ * Walks the interrupted thread's frame pointers
+ * @param context the ucontext_t the signal handler was given
+ * @param stack filled with the interrupted instruction, then the return
+ * address of each caller
+ * @return frames filled, at most STRIDE
+ */
+static int walk_stack(void* context, void** stack) {
+  const mcontext_t& registers = static_cast<ucontext_t*>(context)->uc_mcontext;
+#if defined(__x86_64__)
+  uintptr_t pc = registers.gregs[REG_RIP];
+  uintptr_t frame = registers.gregs[REG_RBP];
+  uintptr_t sp = registers.gregs[REG_RSP];
+#elif defined(__aarch64__)
+  uintptr_t pc = registers.pc;
+  uintptr_t frame = registers.regs[29];
+  uintptr_t sp = registers.sp;
+#else
+  return 0;  // No known frame layout
+#endif
+  int depth = 0;
+  stack[depth++] = reinterpret_cast<void*>(pc);
+  // Each frame lies above the last, since stacks grow down
+  for (uintptr_t floor = sp; depth < STRIDE; depth++) {
+    uintptr_t record[2];
+    if (frame < floor || frame - floor > MAX_FRAME_SIZE ||
+        frame % sizeof(uintptr_t) != 0 || !read_frame(frame, record) ||
+        record[1] == 0) {
+      break;
+    }
+    stack[depth] = reinterpret_cast<void*>(record[1]);
+    floor = frame + 2 * sizeof(uintptr_t);
+    frame = record[0];
+  }
+  return depth;
+}
+
+/**
+ * SIGPROF handler; only async-signal-safe work: an atomic add and a walk
+ * of frame pointers, each read through a system call that fails instead of
+ * faulting. backtrace is not used, since its unwinder can take the loader
+ * lock.
+ */
+static void take_sample(int, siginfo_t*, void* context) {
+  int savedErrno = errno;
+  size_t sample = nextSample.fetch_add(1, std::memory_order_relaxed);
+  if (sample < sampleCapacity.load(std::memory_order_relaxed)) {
+    int depth = walk_stack(context, &frames[sample * STRIDE]);
+    depths[sample].store(depth, std::memory_order_release);
+  } else {
+    droppedSamples.fetch_add(1, std::memory_order_relaxed);
+  }
+  errno = savedErrno;
+}
+
+/**
+ * Points SIGPROF at take_sample, or ignores it
+ * @param sampling false to ignore SIGPROF, so a signal still pending after
+ * the timer stops cannot end the process
+ * @return false if it could not be set
+ */
+static bool set_handler(bool sampling) {
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  if (sampling) {
+    action.sa_sigaction = take_sample;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+  } else {
+    action.sa_handler = SIG_IGN;
+    action.sa_flags = SA_RESTART;
+  }
+  sigemptyset(&action.sa_mask);
+  return sigaction(SIGPROF, &action, NULL) == 0;
+}
+
+/**
+ * Names a code address
+ * @param address where the code is
+ * @return the demangled function, or module+offset if it has no symbol
+ */
+static std::string frame_name(void* address) {
+  Dl_info info;
+  if (dladdr(address, &info) == 0 || info.dli_fname == NULL) return "??";
+  if (info.dli_sname != NULL) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+    std::string name = status == 0 ? demangled : info.dli_sname;
+    free(demangled);
+    return name;
+  }
+  const char* module = strrchr(info.dli_fname, '/');
+  module = module == NULL ? info.dli_fname : module + 1;
+  char name[256];
+  snprintf(name, sizeof(name), "%s+0x%lx", module,
+           static_cast<unsigned long>(  // NOLINT
+               static_cast<char*>(address) -
+               static_cast<char*>(info.dli_fbase)));
+  return name;
+}
+
+/**
+ * Starts sampling the whole process
+ * @param hz samples per second of CPU time, 1 to 1000
+ * @param capacity samples to keep; later ones are counted as dropped
+ * @return false if already started or the timer could not be set
+ */
+bool Profiler::start(int hz, size_t capacity) {
+  std::lock_guard<std::mutex> guard(profilerLock);
+  if (started || hz < 1 || hz > 1000 || capacity == 0) return false;
+
+  frames.reset(new void*[capacity * STRIDE]);
+  depths.reset(new std::atomic<int>[capacity]());
+  nextSample = 0;
+  droppedSamples = 0;
+  sampleCapacity = capacity;
+  if (!set_handler(true)) return false;
+
+  long micros = 1000000 / hz;  // NOLINT
+  itimerval timer;
+  timer.it_interval.tv_sec = micros / 1000000;
+  timer.it_interval.tv_usec = micros % 1000000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+    set_handler(false);
+    return false;
+  }
+  started = true;
+  return true;
+}
+
+/**
+ * Checks whether the profiler is sampling
+ * @return true between start and stop
+ */
+bool Profiler::running() {
+  std::lock_guard<std::mutex> guard(profilerLock);
+  return started;
+}
+
+/**
+ * Stops sampling and folds the samples taken
+ * @return "outer;...;inner count" lines sorted by stack, or "" if not
+ * started
+ */
+std::string Profiler::stop() {
+  std::lock_guard<std::mutex> guard(profilerLock);
+  if (!started) return "";
+  itimerval off;
+  memset(&off, 0, sizeof(off));
+  setitimer(ITIMER_PROF, &off, NULL);
+  set_handler(false);
+  size_t taken = std::min(nextSample.load(), sampleCapacity.load());
+  sampleCapacity = 0;
+  started = false;
+
+  // Samples at different instructions of the same functions fold together
+  std::map<void*, std::string> names;
+  std::map<std::string, uint64_t> stacks;
+  for (size_t s = 0; s < taken; s++) {
+    int depth = depths[s].load(std::memory_order_acquire);
+    if (depth == 0) continue;
+    void** stack = &frames[s * STRIDE];
+    std::string folded;
+    for (int f = depth - 1; f >= 0; f--) {
+      // Outer frames hold return addresses, just past the call
+      void* address = static_cast<char*>(stack[f]) - (f == 0 ? 0 : 1);
+      auto name = names.find(address);
+      if (name == names.end()) {
+        name = names.insert({address, frame_name(address)}).first;
+      }
+      if (!folded.empty()) folded += ';';
+      folded += name->second;
+    }
+    stacks[folded]++;
+  }
+
+  std::string out;
+  for (auto stack = stacks.begin(); stack != stacks.end(); ++stack) {
+    out += stack->first + " " + std::to_string(stack->second) + "\n";
+  }
+  return out;
+}
+
+/**
+ * Gets the samples the last run could not keep
+ * @return samples beyond its capacity
+ */
+uint64_t Profiler::dropped() { return droppedSamples; }
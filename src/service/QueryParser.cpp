@@ -0,0 +1,275 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "QueryParser.h"
+
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+const size_t QueryParser::MAX_DEPTH;
+
+/**
+ * Parses a query
+ * @param text the query
+ * @param root set to the parsed query
+ * @param error set to what is wrong with the query when parsing fails
+ * @return false if the query is malformed
+ */
+bool QueryParser::parse(const std::string& text, QueryNode* root,
+                        std::string* error) {
+  QueryParser parser(text);
+  parser.skipSpaces();
+  if (parser.pos == text.size()) {
+    *error = "empty query";
+    return false;
+  }
+  if (!parser.parseOr(root)) {
+    *error = parser.error;
+    return false;
+  }
+  if (parser.pos != text.size()) {
+    parser.fail("AND, OR or the end of the query");
+    *error = parser.error;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Writes a query back out, fully parenthesized
+ * @param node the query
+ * @return the query text
+ */
+std::string QueryParser::describe(const QueryNode& node) {
+  if (node.kind == QueryNode::TERM) {
+    bool quote = node.value.empty() ||
+                 node.value.find_first_of(" \t()") != std::string::npos;
+    return node.field + node.op +
+           (quote ? "\"" + node.value + "\"" : node.value);
+  }
+  if (node.kind == QueryNode::NOT) return "NOT " + describe(node.children[0]);
+
+  std::string joiner = node.kind == QueryNode::AND ? " AND " : " OR ";
+  std::string result = "(";
+  for (size_t i = 0; i < node.children.size(); i++) {
+    if (i > 0) result += joiner;
+    result += describe(node.children[i]);
+  }
+  return result + ")";
+}
+
+/**
+ * Parses operands joined by OR
+ * @param node set to the parsed expression
+ * @return false on a syntax error
+ */
+bool QueryParser::parseOr(QueryNode* node) {
+  QueryNode first;
+  if (!parseAnd(&first)) return false;
+  if (!keyword("OR")) {
+    *node = std::move(first);
+    return true;
+  }
+
+  node->kind = QueryNode::OR;
+  node->children.push_back(std::move(first));
+  do {
+    QueryNode next;
+    if (!parseAnd(&next)) return false;
+    node->children.push_back(std::move(next));
+  } while (keyword("OR"));
+  return true;
+}
+
+/**
+ * Parses operands joined by AND or written next to each other
+ * @param node set to the parsed expression
+ * @return false on a syntax error
+ */
+bool QueryParser::parseAnd(QueryNode* node) {
+  QueryNode first;
+  if (!parseUnary(&first)) return false;
+  bool joined = keyword("AND");
+  if (!joined && !atOperand()) {
+    *node = std::move(first);
+    return true;
+  }
+
+  node->kind = QueryNode::AND;
+  node->children.push_back(std::move(first));
+  while (true) {
+    QueryNode next;
+    if (!parseUnary(&next)) return false;
+    node->children.push_back(std::move(next));
+    if (!keyword("AND") && !atOperand()) return true;
+  }
+}
+
+/**
+ * Parses a predicate, a parenthesized query or NOT followed by either
+ * @param node set to the parsed expression
+ * @return false on a syntax error
+ */
+bool QueryParser::parseUnary(QueryNode* node) {
+  skipSpaces();
+  if (keyword("NOT")) {
+    node->kind = QueryNode::NOT;
+    node->children.resize(1);
+    return parseNested(&node->children[0], &QueryParser::parseUnary);
+  }
+  if (pos < text.size() && text[pos] == '(') {
+    pos++;
+    if (!parseNested(node, &QueryParser::parseOr)) return false;
+    skipSpaces();
+    if (pos == text.size() || text[pos] != ')') return fail("\")\"");
+    pos++;
+    skipSpaces();
+    return true;
+  }
+  return parseTerm(node);
+}
+
+/**
+ * Parses the operand of a NOT or the inside of parentheses, one level
+ * deeper
+ * @param node set to the parsed expression
+ * @param inner parseUnary or parseOr
+ * @return false on a syntax error or when nested too deeply
+ */
+bool QueryParser::parseNested(QueryNode* node,
+                              bool (QueryParser::*inner)(QueryNode*)) {
+  if (depth == MAX_DEPTH) {
+    if (error.empty()) error = "query nested too deeply";
+    return false;
+  }
+  depth++;
+  bool parsed = (this->*inner)(node);
+  depth--;
+  return parsed;
+}
+
+/**
+ * Parses a field, operator and value
+ * @param node set to the parsed predicate
+ * @return false on a syntax error
+ */
+bool QueryParser::parseTerm(QueryNode* node) {
+  node->kind = QueryNode::TERM;
+  size_t start = pos;
+  while (pos < text.size() && (isalnum(static_cast<unsigned char>(text[pos])) ||
+                               text[pos] == '_')) {
+    pos++;
+  }
+  if (pos == start) return fail("a field name");
+  node->field = text.substr(start, pos - start);
+  for (size_t i = 0; i < node->field.size(); i++) {
+    node->field[i] = tolower(static_cast<unsigned char>(node->field[i]));
+  }
+
+  // Two character operators first, so ">=" is not read as ">"
+  static const char* ops[] = {"!=", ">=", "<=", ":", "=", ">", "<"};
+  for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+    if (text.compare(pos, std::string(ops[i]).size(), ops[i]) == 0) {
+      node->op = ops[i];
+      break;
+    }
+  }
+  if (node->op.empty()) return fail("an operator after " + node->field);
+  pos += node->op.size();
+  if (node->op == "=") node->op = ":";  // Both mean equals
+
+  if (pos < text.size() && text[pos] == '"') {
+    size_t close = text.find('"', pos + 1);
+    if (close == std::string::npos) return fail("a closing quote");
+    node->value = text.substr(pos + 1, close - pos - 1);
+    pos = close + 1;
+  } else {
+    start = pos;
+    while (pos < text.size() && !isspace(static_cast<unsigned char>(text[pos]))
+           && text[pos] != '(' && text[pos] != ')') {
+      pos++;
+    }
+    if (pos == start) return fail("a value for " + node->field);
+    node->value = text.substr(start, pos - start);
+  }
+  skipSpaces();
+
+  if (node->op == "!=") {  // Planned like any other NOT
+    node->op = ":";
+    QueryNode term = std::move(*node);
+    node->kind = QueryNode::NOT;
+    node->field = node->op = node->value = "";
+    node->children.assign(1, std::move(term));
+  }
+  return true;
+}
+
+/**
+ * Consumes a keyword if it comes next as a whole word
+ * @param word the keyword, in upper case
+ * @return true if the keyword was consumed
+ */
+bool QueryParser::keyword(const char* word) {
+  skipSpaces();
+  size_t length = std::string(word).size();
+  if (pos + length > text.size()) return false;
+  for (size_t i = 0; i < length; i++) {
+    if (toupper(static_cast<unsigned char>(text[pos + i])) != word[i]) {
+      return false;
+    }
+  }
+  // "NOTE:x" or "order>2" are predicates, not keywords
+  if (pos + length < text.size() &&
+      (isalnum(static_cast<unsigned char>(text[pos + length])) ||
+       text[pos + length] == '_' || text[pos + length] == ':' ||
+       text[pos + length] == '=' || text[pos + length] == '!' ||
+       text[pos + length] == '<' || text[pos + length] == '>')) {
+    return false;
+  }
+  pos += length;
+  skipSpaces();
+  return true;
+}
+
+/**
+ * Checks whether the rest of the query could start another operand
+ * @return true at a predicate, "(" or NOT
+ */
+bool QueryParser::atOperand() {
+  skipSpaces();
+  if (pos == text.size()) return false;
+  if (text[pos] == '(') return true;
+  if (!isalnum(static_cast<unsigned char>(text[pos])) && text[pos] != '_') {
+    return false;
+  }
+  // OR ends an AND chain rather than starting an operand
+  size_t saved = pos;
+  bool isOr = keyword("OR");
+  pos = saved;
+  return !isOr;
+}
+
+/**
+ * Skips whitespace
+ */
+void QueryParser::skipSpaces() {
+  while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) {
+    pos++;
+  }
+}
+
+/**
+ * Records a syntax error at the current position
+ * @param what what was expected
+ * @return false
+ */
+bool QueryParser::fail(const std::string& what) {
+  if (error.empty()) {
+    error = "expected " + what + " at position " + std::to_string(pos);
+  }
+  return false;
+}
@@ -0,0 +1,162 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "RequestLog.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "WireFrame.h"
+
+/**
+ * First bytes of every log, including the format version
+ */
+static const char MAGIC[] = "IRQL1\n";
+static const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+/**
+ * Buffered bytes that make record write them out at once
+ */
+static const size_t FLUSH_SIZE = 64 * 1024;
+
+RequestLog::RequestLog() : file(NULL), started(false) {}
+
+RequestLog::~RequestLog() { close(); }
+
+/**
+ * Starts capturing to a file, replacing it
+ * @param path the file
+ * @return false if the file could not be created
+ */
+bool RequestLog::open(const std::string& path) {
+  close();
+  std::lock_guard<std::mutex> guard(lock);
+  file = fopen(path.c_str(), "wb");
+  if (file == NULL) return false;
+  buffer.assign(MAGIC, MAGIC_SIZE);
+  started = false;
+  return true;
+}
+
+/**
+ * Checks whether requests are being captured
+ * @return true if a file is open
+ */
+bool RequestLog::isOpen() {
+  std::lock_guard<std::mutex> guard(lock);
+  return file != NULL;
+}
+
+/**
+ * Adds a request that just arrived; safe to call from any thread
+ * @param kind WireFrame::GET_REQUEST or WireFrame::POST_REQUEST
+ * @param payload the request in WebSocket form
+ */
+void RequestLog::record(int kind, const std::string& payload) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (file == NULL) return;
+  // Taken under the lock, so the gaps between records are never negative
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  uint64_t gap = 0;
+  if (started) {
+    gap = std::chrono::duration_cast<std::chrono::microseconds>(now - last)
+              .count();
+  }
+  last = now;
+  started = true;
+
+  std::string frame = WireFrame::encode(kind, gap, payload);
+  uint64_t size = frame.size();
+  do {  // LEB128 varint, as in WireFrame
+    uint8_t byte = size & 0x7F;
+    size >>= 7;
+    if (size != 0) byte |= 0x80;
+    buffer += static_cast<char>(byte);
+  } while (size != 0);
+  buffer += frame;
+  if (buffer.size() >= FLUSH_SIZE) write();
+}
+
+/**
+ * Writes the records collected so far to the file
+ */
+void RequestLog::flush() {
+  std::lock_guard<std::mutex> guard(lock);
+  write();
+}
+
+/**
+ * Writes what is left and stops capturing
+ */
+void RequestLog::close() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (file == NULL) return;
+  write();
+  fclose(file);
+  file = NULL;
+}
+
+/**
+ * Writes the buffer without taking the lock
+ */
+void RequestLog::write() {
+  if (file == NULL || buffer.empty()) return;
+  if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+    fprintf(stderr, "Request capture failed, no longer capturing\n");
+    fclose(file);
+    file = NULL;
+  } else {
+    fflush(file);
+  }
+  buffer.clear();
+}
+
+/**
+ * Reads a whole log, stopping at a record cut off by a crash
+ * @param path the file
+ * @param entries filled with the requests in arrival order
+ * @return false if the file cannot be read or is not a request log
+ */
+bool RequestLog::read(const std::string& path, std::vector<Entry>* entries) {
+  FILE* in = fopen(path.c_str(), "rb");
+  if (in == NULL) return false;
+  std::string data;
+  char chunk[65536];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) data.append(chunk, n);
+  fclose(in);
+  if (data.compare(0, MAGIC_SIZE, MAGIC, MAGIC_SIZE) != 0) return false;
+
+  uint64_t micros = 0;
+  size_t pos = MAGIC_SIZE;
+  while (pos < data.size()) {
+    uint64_t size = 0;
+    bool complete = false;
+    for (int shift = 0; pos < data.size() && shift <= 63; shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(data[pos++]);
+      size |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        complete = true;
+        break;
+      }
+    }
+    if (!complete || size > data.size() - pos) break;
+
+    Entry entry;
+    uint64_t gap;
+    if (!WireFrame::decode(data.substr(pos, size), &entry.kind, &gap,
+                           &entry.payload)) {
+      break;
+    }
+    pos += size;
+    micros += gap;
+    entry.micros = micros;
+    entries->push_back(entry);
+  }
+  return true;
+}
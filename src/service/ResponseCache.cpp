@@ -0,0 +1,73 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "ResponseCache.h"
+
+#include <string>
+#include <utility>
+
+/**
+ * Constructor for ResponseCache
+ * @param maxEntries entries kept before the cache starts over
+ */
+ResponseCache::ResponseCache(size_t maxEntries)
+    : cachedVersion(0), capacity(maxEntries), usedBytes(0) {}
+
+/**
+ * Looks up a response
+ * @param key request key, including the response encoding
+ * @param version current tracker version
+ * @param body set to the cached response body
+ * @param encoding set to the Content-Encoding of the body ("" if none)
+ * @return true on a hit for this version
+ */
+bool ResponseCache::get(const std::string& key, uint64_t version,
+                        std::string* body, std::string* encoding) {
+  if (version != cachedVersion) return false;  // Data changed since
+  auto found = entries.find(key);
+  if (found == entries.end()) return false;
+  *body = found->second.body;
+  *encoding = found->second.encoding;
+  return true;
+}
+
+/**
+ * Stores a response
+ * @param key request key, including the response encoding
+ * @param version tracker version the response was built from
+ * @param body the response body
+ * @param encoding the Content-Encoding of the body ("" if none)
+ */
+void ResponseCache::put(const std::string& key, uint64_t version,
+                        const std::string& body, const std::string& encoding) {
+  // A new version or a full cache starts over
+  if (version != cachedVersion || entries.size() >= capacity) {
+    entries.clear();
+    usedBytes = 0;
+    cachedVersion = version;
+  }
+  auto found = entries.find(key);
+  if (found == entries.end()) {
+    found = entries.insert(std::make_pair(key, Entry())).first;
+    usedBytes += key.size();
+  }
+  Entry& entry = found->second;
+  usedBytes -= entry.body.size();
+  entry.body = body;
+  entry.encoding = encoding;
+  usedBytes += body.size();
+}
+
+/**
+ * Gets the number of cached responses
+ * @return number of entries
+ */
+size_t ResponseCache::size() { return entries.size(); }
+
+/**
+ * Gets the bytes held by cached response bodies and keys
+ * @return approximate bytes used
+ */
+size_t ResponseCache::bytes() { return usedBytes; }
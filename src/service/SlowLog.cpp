@@ -0,0 +1,132 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "SlowLog.h"
+
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+const size_t SlowLog::MAX_QUEUED;
+
+SlowLog::SlowLog()
+    : file(NULL), threshold(0), logged(0), dropped(0), stopping(false) {}
+
+SlowLog::~SlowLog() { close(); }
+
+/**
+ * Starts logging to a file, appending to it
+ * @param path the file
+ * @param thresholdMicros requests taking at least this long are logged
+ * @return false if the file could not be opened
+ */
+bool SlowLog::open(const std::string& path, uint64_t thresholdMicros) {
+  close();
+  FILE* opened = fopen(path.c_str(), "a");
+  if (opened == NULL) return false;
+  std::lock_guard<std::mutex> guard(lock);
+  file = opened;
+  threshold = thresholdMicros;
+  logged = 0;
+  dropped = 0;
+  stopping = false;
+  writer = std::thread(&SlowLog::run, this);
+  return true;
+}
+
+/**
+ * Checks whether slow requests are being logged
+ * @return true if a file is open
+ */
+bool SlowLog::isOpen() {
+  std::lock_guard<std::mutex> guard(lock);
+  return file != NULL;
+}
+
+/**
+ * Gets the time from which requests are logged
+ * @return microseconds
+ */
+uint64_t SlowLog::getThreshold() {
+  std::lock_guard<std::mutex> guard(lock);
+  return threshold;
+}
+
+/**
+ * Queues a line; safe to call from any thread and never waits on I/O
+ * @param line the entry, without a newline
+ */
+void SlowLog::write(const std::string& line) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (file == NULL || stopping) return;
+    if (queue.size() >= MAX_QUEUED) {
+      dropped++;
+      return;
+    }
+    queue.push_back(line);
+    logged++;
+  }
+  wake.notify_one();
+}
+
+/**
+ * Gets the number of lines written or waiting to be
+ * @return lines accepted since opening
+ */
+uint64_t SlowLog::getLogged() {
+  std::lock_guard<std::mutex> guard(lock);
+  return logged;
+}
+
+/**
+ * Gets the number of lines dropped because the queue was full
+ * @return lines dropped since opening
+ */
+uint64_t SlowLog::getDropped() {
+  std::lock_guard<std::mutex> guard(lock);
+  return dropped;
+}
+
+/**
+ * Writes every queued line and stops logging
+ */
+void SlowLog::close() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (file == NULL) return;
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+  std::lock_guard<std::mutex> guard(lock);
+  fclose(file);
+  file = NULL;
+}
+
+/**
+ * Writes queued lines until closed
+ */
+void SlowLog::run() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    wake.wait(guard, [this]() { return stopping || !queue.empty(); });
+    if (queue.empty()) return;  // Stopping with nothing left
+
+    // Takes every waiting line, so the disk is written without the lock
+    std::deque<std::string> batch;
+    batch.swap(queue);
+    guard.unlock();
+    for (size_t i = 0; i < batch.size(); i++) {
+      fputs(batch[i].c_str(), file);
+      fputc('\n', file);
+    }
+    fflush(file);
+    guard.lock();
+  }
+}
@@ -0,0 +1,20 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "StringBytes.h"
+
+#include <string>
+
+/**
+ * Gets the heap memory a string holds beyond its own object. Short
+ * strings are stored inside the object, up to the capacity an empty
+ * string reports, and hold none.
+ * @param s the string
+ * @return its buffer and terminator, or 0 for a short string
+ */
+size_t StringBytes::heap(const std::string& s) {
+  static const size_t inlineCapacity = std::string().capacity();
+  return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0;
+}
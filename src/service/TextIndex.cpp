@@ -0,0 +1,374 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "TextIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * BM25 term frequency saturation
+ */
+const double K1 = 1.2;
+
+/**
+ * BM25 document length normalization
+ */
+const double B = 0.75;
+
+TextIndex::TextIndex() : totalLength(0) {}
+
+/**
+ * Splits text into lowercase alphanumeric terms
+ * @param text the text to split
+ * @return the terms in order of appearance
+ */
+std::vector<std::string> TextIndex::tokenize(const std::string& text) {
+  std::vector<std::string> tokens;
+  std::string token;
+  for (size_t i = 0; i <= text.size(); i++) {
+    unsigned char c = i < text.size() ? text[i] : ' ';
+    if (isalnum(c)) {
+      token += static_cast<char>(tolower(c));
+    } else if (!token.empty()) {
+      tokens.push_back(token);
+      token.clear();
+    }
+  }
+  return tokens;
+}
+
+/**
+ * Adds to or subtracts from the tf of a term in a document
+ * @param term the term
+ * @param doc document id
+ * @param delta change in tf
+ */
+void TextIndex::update(const std::string& term, uint64_t doc, int64_t delta) {
+  auto found = terms.find(term);
+  if (found == terms.end()) {
+    if (delta <= 0) return;
+    found = terms.insert(std::make_pair(term, Term())).first;
+  }
+  Term& entry = found->second;
+  auto byDoc = [](const Posting& p, uint64_t d) { return p.doc < d; };
+
+  // Find the posting in the main list, then in the side list
+  std::vector<Posting>* list = &entry.postings;
+  auto pos = std::lower_bound(list->begin(), list->end(), doc, byDoc);
+  if (pos == list->end() || pos->doc != doc) {
+    list = &entry.pending;
+    pos = std::lower_bound(list->begin(), list->end(), doc, byDoc);
+  }
+  if (pos == list->end() || pos->doc != doc) {  // Term is new to doc
+    if (delta <= 0) return;
+    if (entry.postings.empty() || entry.postings.back().doc < doc) {
+      list = &entry.postings;  // Usual case: newest issue
+      pos = list->insert(list->end(), {doc, 0});
+    } else {
+      pos = list->insert(pos, {doc, 0});
+    }
+  }
+
+  int64_t tf = static_cast<int64_t>(pos->tf) + delta;
+  if (tf > 0) {
+    pos->tf = static_cast<uint32_t>(tf);
+    if (pos->tf > entry.maxTf) entry.maxTf = pos->tf;
+  } else {
+    list->erase(pos);
+  }
+  if (entry.postings.empty() && entry.pending.empty()) {
+    terms.erase(found);  // Drop terms nobody uses
+  } else if (entry.pending.size() > 32 &&
+             entry.pending.size() * entry.pending.size() >
+                 entry.postings.size()) {
+    // Side list capped near sqrt(n): inserting into it and merging it
+    // both cost O(sqrt(n)) per added posting
+    merge(&entry);
+  }
+}
+
+/**
+ * Merges the side list of a term into its postings
+ * @param entry the term
+ */
+void TextIndex::merge(Term* entry) {
+  if (entry->pending.empty()) return;
+  std::vector<Posting> merged;
+  merged.reserve(entry->postings.size() + entry->pending.size());
+  std::merge(entry->postings.begin(), entry->postings.end(),
+             entry->pending.begin(), entry->pending.end(),
+             std::back_inserter(merged),
+             [](const Posting& a, const Posting& b) { return a.doc < b.doc; });
+  entry->postings.swap(merged);
+  entry->pending.clear();
+}
+
+/**
+ * Adds text to a document, creating the document if it is new
+ * @param doc document id
+ * @param text text added to the document
+ */
+void TextIndex::add(uint64_t doc, const std::string& text) {
+  std::vector<std::string> tokens = tokenize(text);
+  std::unordered_map<std::string, int64_t> counts;
+  for (size_t i = 0; i < tokens.size(); i++) counts[tokens[i]]++;
+  for (auto it = counts.begin(); it != counts.end(); ++it) {
+    update(it->first, doc, it->second);
+  }
+  lengths[doc] += tokens.size();
+  totalLength += tokens.size();
+}
+
+/**
+ * Removes a document entirely
+ * @param doc document id
+ * @param text every piece of text that was added to the document
+ */
+void TextIndex::remove(uint64_t doc, const std::string& text) {
+  std::vector<std::string> tokens = tokenize(text);
+  std::unordered_map<std::string, int64_t> counts;
+  for (size_t i = 0; i < tokens.size(); i++) counts[tokens[i]]++;
+  for (auto it = counts.begin(); it != counts.end(); ++it) {
+    update(it->first, doc, -it->second);
+  }
+  auto found = lengths.find(doc);
+  if (found != lengths.end()) {
+    totalLength -= found->second;
+    lengths.erase(found);
+  }
+}
+
+/**
+ * Finds the best matching documents for a query. Documents are visited in
+ * id order and terms whose best possible score cannot lift a document
+ * into the current top k are only probed for documents that could still
+ * make it (MaxScore pruning).
+ * @param query the search text
+ * @param k most results returned
+ * @return document ids and scores, best first
+ */
+std::vector<std::pair<uint64_t, double>> TextIndex::search(
+    const std::string& query, size_t k) {
+  std::vector<std::pair<uint64_t, double>> results;
+  if (k == 0 || lengths.empty()) return results;
+  double docs = lengths.size();
+  double avgLength = static_cast<double>(totalLength) / docs;
+
+  // One cursor per distinct query term that has postings
+  struct Cursor {
+    const std::vector<Posting>* list;
+    size_t pos;
+    double idf;
+    double bound;  // Best score this term can add to any document
+  };
+  std::vector<std::string> tokens = tokenize(query);
+  std::sort(tokens.begin(), tokens.end());
+  tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+  std::vector<Cursor> cursors;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    auto found = terms.find(tokens[i]);
+    if (found == terms.end()) continue;
+    merge(&found->second);
+    double df = found->second.postings.size();
+    double idf = log(1 + (docs - df + 0.5) / (df + 0.5));
+    double tf = found->second.maxTf;
+    // Shortest possible document gives the largest term score
+    double bound = idf * tf * (K1 + 1) / (tf + K1 * (1 - B));
+    cursors.push_back({&found->second.postings, 0, idf, bound});
+  }
+  if (cursors.empty()) return results;
+
+  // Terms with the smallest bounds first; prefix[i] sums bounds below i
+  std::sort(cursors.begin(), cursors.end(),
+            [](const Cursor& a, const Cursor& b) { return a.bound < b.bound; });
+  std::vector<double> prefix(cursors.size() + 1, 0);
+  for (size_t i = 0; i < cursors.size(); i++) {
+    prefix[i + 1] = prefix[i] + cursors[i].bound;
+  }
+
+  // Min-heap of the best k so far; its top is the score to beat
+  typedef std::pair<double, uint64_t> Scored;
+  std::priority_queue<Scored, std::vector<Scored>, std::greater<Scored>> top;
+  double threshold = 0;
+  size_t firstEssential = 0;  // Terms below this cannot reach top k alone
+
+  auto termScore = [&](const Cursor& c, uint64_t doc) {
+    double tf = (*c.list)[c.pos].tf;
+    double norm = K1 * (1 - B + B * lengths[doc] / avgLength);
+    return c.idf * tf * (K1 + 1) / (tf + norm);
+  };
+
+  while (firstEssential < cursors.size()) {
+    // Next candidate is the smallest document in any essential list
+    uint64_t doc = UINT64_MAX;
+    for (size_t i = firstEssential; i < cursors.size(); i++) {
+      const Cursor& c = cursors[i];
+      if (c.pos < c.list->size() && (*c.list)[c.pos].doc < doc) {
+        doc = (*c.list)[c.pos].doc;
+      }
+    }
+    if (doc == UINT64_MAX) break;  // Essential lists exhausted
+
+    double score = 0;
+    for (size_t i = firstEssential; i < cursors.size(); i++) {
+      Cursor& c = cursors[i];
+      if (c.pos < c.list->size() && (*c.list)[c.pos].doc == doc) {
+        score += termScore(c, doc);
+        c.pos++;
+      }
+    }
+    // Probe non-essential lists only while the document can still qualify
+    for (size_t i = firstEssential; i-- > 0;) {
+      if (top.size() == k && score + prefix[i + 1] <= threshold) break;
+      Cursor& c = cursors[i];
+      auto pos = std::lower_bound(
+          c.list->begin() + c.pos, c.list->end(), doc,
+          [](const Posting& p, uint64_t d) { return p.doc < d; });
+      c.pos = pos - c.list->begin();
+      if (pos != c.list->end() && pos->doc == doc) score += termScore(c, doc);
+    }
+
+    if (top.size() < k) {
+      top.push(Scored(score, doc));
+    } else if (score > threshold) {
+      top.pop();
+      top.push(Scored(score, doc));
+    }
+    if (top.size() == k) {
+      threshold = top.top().first;
+      // Terms whose bounds together cannot beat the threshold stop driving
+      while (firstEssential < cursors.size() &&
+             prefix[firstEssential + 1] <= threshold) {
+        firstEssential++;
+      }
+    }
+  }
+
+  while (!top.empty()) {
+    results.push_back(std::make_pair(top.top().second, top.top().first));
+    top.pop();
+  }
+  std::reverse(results.begin(), results.end());
+  return results;
+}
+
+/**
+ * Gets the number of indexed documents
+ * @return number of documents
+ */
+size_t TextIndex::documents() { return lengths.size(); }
+
+/**
+ * Gets the approximate memory held by the index
+ * @return bytes used by postings, terms and document lengths
+ */
+size_t TextIndex::bytes() {
+  size_t used = lengths.size() * (sizeof(uint64_t) + sizeof(uint32_t) +
+                                  2 * sizeof(void*));
+  for (auto it = terms.begin(); it != terms.end(); ++it) {
+    used += sizeof(*it) + StringBytes::heap(it->first) + 2 * sizeof(void*) +
+            (it->second.postings.capacity() + it->second.pending.capacity()) *
+                sizeof(Posting);
+  }
+  return used;
+}
+
+/**
+ * Removes every document
+ */
+void TextIndex::clear() {
+  terms.clear();
+  lengths.clear();
+  totalLength = 0;
+}
+
+/**
+ * Writes the index to a file
+ * @param path file to write
+ * @param docs maps each document id to the id it is saved under
+ * @param stamp value checked on load to tell whether the file is current
+ */
+void TextIndex::save(const std::string& path,
+                     const std::unordered_map<uint64_t, uint64_t>& docs,
+                     const std::string& stamp) {
+  std::ofstream out(path.c_str());
+  // Header: format, stamp, then the document lengths
+  out << "TEXTINDEX 1 " << stamp << '\n' << lengths.size() << '\n';
+  for (auto it = lengths.begin(); it != lengths.end(); ++it) {
+    out << docs.at(it->first) << ' ' << it->second << '\n';
+  }
+  // One line per term: term, maxTf, count, then doc/tf pairs
+  out << terms.size() << '\n';
+  for (auto it = terms.begin(); it != terms.end(); ++it) {
+    merge(&it->second);
+    const std::vector<Posting>& list = it->second.postings;
+    out << it->first << ' ' << it->second.maxTf << ' ' << list.size();
+    for (size_t i = 0; i < list.size(); i++) {
+      out << ' ' << docs.at(list[i].doc) << ' ' << list[i].tf;
+    }
+    out << '\n';
+  }
+}
+
+/**
+ * Replaces the index with one written by save
+ * @param path file to read
+ * @param stamp value the file must have been saved with
+ * @return false if the file is missing, corrupt or has another stamp
+ */
+bool TextIndex::load(const std::string& path, const std::string& stamp) {
+  std::ifstream in(path.c_str());
+  std::string line, magic, savedStamp;
+  int format;
+  if (!getline(in, line)) return false;
+  std::stringstream header(line);
+  header >> magic >> format;
+  getline(header >> std::ws, savedStamp);
+  if (magic != "TEXTINDEX" || format != 1 || savedStamp != stamp) {
+    return false;
+  }
+
+  clear();
+  size_t count;
+  in >> count;
+  for (size_t i = 0; i < count && in; i++) {
+    uint64_t doc;
+    uint32_t length;
+    in >> doc >> length;
+    lengths[doc] = length;
+    totalLength += length;
+  }
+  in >> count;
+  for (size_t i = 0; i < count && in; i++) {
+    std::string term;
+    size_t size;
+    Term entry;
+    in >> term >> entry.maxTf >> size;
+    entry.postings.resize(size);
+    for (size_t p = 0; p < size && in; p++) {
+      in >> entry.postings[p].doc >> entry.postings[p].tf;
+    }
+    terms[term].postings.swap(entry.postings);
+    terms[term].maxTf = entry.maxTf;
+  }
+  if (!in) {  // Truncated file, leave an empty index to be rebuilt
+    clear();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,237 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+const size_t Tracer::RING_SIZE;
+
+/**
+ * One recorded span
+ */
+struct TraceEvent {
+  const char* name;
+  uint64_t request;
+  uint64_t start;
+  uint64_t end;
+};
+
+/**
+ * The spans of one thread. Only that thread writes them, so its lock is
+ * only ever contended by dump and clear.
+ */
+struct TraceRing {
+  std::mutex lock;
+  std::vector<TraceEvent> events;
+  /**
+   * Spans ever recorded; the latest is at (written - 1) % RING_SIZE
+   */
+  uint64_t written = 0;
+  /**
+   * Thread number shown in the trace
+   */
+  uint32_t thread = 0;
+};
+
+/**
+ * Every thread's ring, kept after the thread exits so its spans can still
+ * be dumped
+ */
+static std::mutex ringsLock;
+static std::vector<std::shared_ptr<TraceRing>> rings;
+
+static std::atomic<uint32_t> sampleEvery(0);
+static std::atomic<uint64_t> requestsSeen(0);
+static std::atomic<uint64_t> nextRequest(1);
+static std::atomic<bool> timePhases(false);
+
+/**
+ * The calling thread's traced request, 0 if none, and its ring
+ */
+static thread_local uint64_t currentRequest = 0;
+static thread_local TraceRing* threadRing = NULL;
+/**
+ * Whether the calling thread's current request times its phases, and the
+ * times so far
+ */
+static thread_local bool timing = false;
+static thread_local std::vector<std::pair<const char*, uint64_t>> phaseTimes;
+
+/**
+ * Sets how many requests are traced
+ * @param every trace one request in this many, 0 to trace none
+ */
+void Tracer::setSampling(uint32_t every) { sampleEvery = every; }
+
+/**
+ * Gets how many requests are traced
+ * @return one request in this many is traced, 0 if none
+ */
+uint32_t Tracer::getSampling() { return sampleEvery; }
+
+/**
+ * Turns timing the phases of every request on or off
+ * @param on whether spans are timed outside sampled requests too
+ */
+void Tracer::setPhaseTiming(bool on) { timePhases = on; }
+
+/**
+ * Starts a request on the calling thread, sampled or not
+ * @return id of the request if it is traced, 0 if not
+ */
+uint64_t Tracer::beginRequest() {
+  uint32_t every = sampleEvery.load(std::memory_order_relaxed);
+  currentRequest = 0;
+  timing = timePhases.load(std::memory_order_relaxed);
+  phaseTimes.clear();
+  if (every == 0 ||
+      requestsSeen.fetch_add(1, std::memory_order_relaxed) % every != 0) {
+    return 0;
+  }
+  currentRequest = nextRequest.fetch_add(1, std::memory_order_relaxed);
+  return currentRequest;
+}
+
+/**
+ * Makes a request current on the calling thread again, e.g. in a
+ * callback that continues it, with no phases timed yet
+ * @param request id from beginRequest, 0 for an untraced request
+ */
+void Tracer::resumeRequest(uint64_t request) {
+  currentRequest = request;
+  timing = timePhases.load(std::memory_order_relaxed);
+  phaseTimes.clear();
+}
+
+/**
+ * Ends the calling thread's current request
+ */
+void Tracer::endRequest() {
+  currentRequest = 0;
+  timing = false;
+}
+
+/**
+ * Checks whether the calling thread is in a traced or timed request
+ * @return true if spans are being recorded or timed
+ */
+bool Tracer::active() { return currentRequest != 0 || timing; }
+
+/**
+ * Gets the time of each phase of the calling thread's current request,
+ * if phase timing is on. Nested phases are counted in their own entry
+ * and in the one around them.
+ * @return phase names, in order first seen, with total nanoseconds
+ */
+const std::vector<std::pair<const char*, uint64_t>>& Tracer::phases() {
+  return phaseTimes;
+}
+
+/**
+ * Gets the time spans are measured in
+ * @return nanoseconds on the steady clock, never 0
+ */
+uint64_t Tracer::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * Records a span of the current request if it is traced, and adds it
+ * to the request's phase times if they are timed
+ * @param name what was done; must outlive the tracer, e.g. a literal
+ * @param start when it started, from now()
+ * @param end when it ended, from now()
+ */
+void Tracer::record(const char* name, uint64_t start, uint64_t end) {
+  if (timing) {  // A request goes through a handful of phases at most
+    size_t p = 0;
+    while (p < phaseTimes.size() && strcmp(phaseTimes[p].first, name) != 0) {
+      p++;
+    }
+    if (p == phaseTimes.size()) phaseTimes.push_back({name, 0});
+    phaseTimes[p].second += end - start;
+  }
+  if (currentRequest == 0) return;
+  if (threadRing == NULL) {
+    std::shared_ptr<TraceRing> ring(new TraceRing());
+    ring->events.resize(RING_SIZE);
+    std::lock_guard<std::mutex> guard(ringsLock);
+    ring->thread = rings.size() + 1;
+    rings.push_back(ring);
+    threadRing = ring.get();
+  }
+  std::lock_guard<std::mutex> guard(threadRing->lock);
+  threadRing->events[threadRing->written % RING_SIZE] = {name, currentRequest,
+                                                         start, end};
+  threadRing->written++;
+}
+
+/**
+ * Formats every recorded span
+ * @return Chrome trace-event JSON
+ */
+std::string Tracer::dump() {
+  std::vector<std::pair<uint32_t, TraceEvent>> events;
+  {
+    std::lock_guard<std::mutex> guard(ringsLock);
+    for (size_t r = 0; r < rings.size(); r++) {
+      TraceRing& ring = *rings[r];
+      std::lock_guard<std::mutex> ringGuard(ring.lock);
+      uint64_t kept = std::min<uint64_t>(ring.written, RING_SIZE);
+      for (uint64_t e = ring.written - kept; e < ring.written; e++) {
+        events.push_back({ring.thread, ring.events[e % RING_SIZE]});
+      }
+    }
+  }
+  // Outer spans first where they start together, so viewers nest them
+  std::sort(events.begin(), events.end(),
+            [](const std::pair<uint32_t, TraceEvent>& a,
+               const std::pair<uint32_t, TraceEvent>& b) {
+              if (a.second.start != b.second.start) {
+                return a.second.start < b.second.start;
+              }
+              return a.second.end > b.second.end;
+            });
+
+  // Complete ("X") events, times in microseconds from the first span
+  uint64_t origin = events.empty() ? 0 : events[0].second.start;
+  std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  char line[256];
+  for (size_t e = 0; e < events.size(); e++) {
+    const TraceEvent& event = events[e].second;
+    snprintf(line, sizeof(line),
+             "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+             "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"request\":%llu}}",
+             e == 0 ? "" : ",", event.name, events[e].first,
+             (event.start - origin) / 1e3, (event.end - event.start) / 1e3,
+             static_cast<unsigned long long>(event.request));  // NOLINT
+    json += line;
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+/**
+ * Forgets every recorded span
+ */
+void Tracer::clear() {
+  std::lock_guard<std::mutex> guard(ringsLock);
+  for (size_t r = 0; r < rings.size(); r++) {
+    std::lock_guard<std::mutex> ringGuard(rings[r]->lock);
+    rings[r]->written = 0;
+  }
+}
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "TrigramIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "StringBytes.h"
+
+/**
+ * Lowercases a string
+ * @param text the string
+ * @return lowercased copy
+ */
+std::string TrigramIndex::lower(const std::string& text) {
+  std::string folded = text;
+  for (size_t i = 0; i < folded.size(); i++) {
+    folded[i] = tolower(static_cast<unsigned char>(folded[i]));
+  }
+  return folded;
+}
+
+/**
+ * Gets the distinct trigrams of a lowercased string
+ * @param text lowercased string
+ * @return packed trigrams, sorted
+ */
+std::vector<uint32_t> TrigramIndex::grams(const std::string& text) {
+  std::vector<uint32_t> found;
+  for (size_t i = 0; i + 3 <= text.size(); i++) {
+    found.push_back(static_cast<uint32_t>(
+        static_cast<unsigned char>(text[i]) << 16 |
+        static_cast<unsigned char>(text[i + 1]) << 8 |
+        static_cast<unsigned char>(text[i + 2])));
+  }
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  return found;
+}
+
+/**
+ * Checks whether an id holds a string rather than a free slot
+ * @param id internal id
+ * @return true if the string at id is indexed
+ */
+bool TrigramIndex::live(uint32_t id) {
+  auto found = ids.find(keys[id]);
+  return found != ids.end() && found->second == id;
+}
+
+/**
+ * Adds a string
+ * @param key the string
+ */
+void TrigramIndex::add(const std::string& key) {
+  if (ids.count(key)) return;
+  uint32_t id;
+  if (!freeIds.empty()) {  // Reuse the slot of a removed string
+    id = freeIds.back();
+    freeIds.pop_back();
+    keys[id] = key;
+    folded[id] = lower(key);
+  } else {
+    id = keys.size();
+    keys.push_back(key);
+    folded.push_back(lower(key));
+  }
+  ids[key] = id;
+
+  std::vector<uint32_t> keyGrams = grams(folded[id]);
+  for (size_t g = 0; g < keyGrams.size(); g++) {
+    std::vector<uint32_t>& list = postings[keyGrams[g]];
+    list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+  }
+}
+
+/**
+ * Removes a string
+ * @param key the string
+ */
+void TrigramIndex::remove(const std::string& key) {
+  auto found = ids.find(key);
+  if (found == ids.end()) return;
+  uint32_t id = found->second;
+
+  std::vector<uint32_t> keyGrams = grams(folded[id]);
+  for (size_t g = 0; g < keyGrams.size(); g++) {
+    auto list = postings.find(keyGrams[g]);
+    auto pos = std::lower_bound(list->second.begin(), list->second.end(), id);
+    list->second.erase(pos);
+    if (list->second.empty()) postings.erase(list);
+  }
+  keys[id].clear();
+  folded[id].clear();
+  freeIds.push_back(id);
+  ids.erase(found);
+}
+
+/**
+ * Finds the strings containing a fragment. Candidates come from
+ * intersecting the posting lists of the fragment's trigrams and are then
+ * checked directly.
+ * @param fragment the piece to look for
+ * @param limit most strings returned
+ * @return matching strings in index order
+ */
+std::vector<std::string> TrigramIndex::substring(const std::string& fragment,
+                                                 size_t limit) {
+  std::vector<std::string> matches;
+  std::string f = lower(fragment);
+  std::vector<uint32_t> queryGrams = grams(f);
+
+  if (queryGrams.empty()) {  // Under three letters, check every string
+    for (size_t id = 0; id < keys.size() && matches.size() < limit; id++) {
+      if (live(id) && folded[id].find(f) != std::string::npos) {
+        matches.push_back(keys[id]);
+      }
+    }
+    return matches;
+  }
+
+  // Shortest posting list drives, the others are probed
+  std::vector<const std::vector<uint32_t>*> lists;
+  for (size_t g = 0; g < queryGrams.size(); g++) {
+    auto list = postings.find(queryGrams[g]);
+    if (list == postings.end()) return matches;  // Some trigram never occurs
+    lists.push_back(&list->second);
+  }
+  std::sort(lists.begin(), lists.end(),
+            [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+              return a->size() < b->size();
+            });
+  const std::vector<uint32_t>& driver = *lists[0];
+  for (size_t c = 0; c < driver.size() && matches.size() < limit; c++) {
+    bool candidate = true;
+    for (size_t l = 1; l < lists.size() && candidate; l++) {
+      candidate =
+          std::binary_search(lists[l]->begin(), lists[l]->end(), driver[c]);
+    }
+    // Trigrams may appear out of order, so the candidate is checked
+    if (candidate && folded[driver[c]].find(f) != std::string::npos) {
+      matches.push_back(keys[driver[c]]);
+    }
+  }
+  return matches;
+}
+
+/**
+ * Finds the strings containing a fragment with at most a few typos
+ * (insertions, deletions or substitutions). Strings sharing too few
+ * trigrams with the fragment are never compared.
+ * @param fragment the piece to look for
+ * @param maxEdits most typos allowed
+ * @param limit most strings returned
+ * @return matching strings, fewest typos first
+ */
+std::vector<std::string> TrigramIndex::fuzzy(const std::string& fragment,
+                                             int maxEdits, size_t limit) {
+  if (maxEdits <= 0) return substring(fragment, limit);
+  std::string f = lower(fragment);
+  std::vector<uint32_t> queryGrams = grams(f);
+
+  // One edit changes at most three trigrams of the fragment
+  int needed = static_cast<int>(queryGrams.size()) - 3 * maxEdits;
+  std::vector<uint32_t> candidates;
+  if (needed <= 0) {  // Too short to filter, check every string
+    for (size_t id = 0; id < keys.size(); id++) {
+      if (live(id)) candidates.push_back(id);
+    }
+  } else {
+    std::vector<int> shared(keys.size(), 0);  // Trigrams in common by id
+    for (size_t g = 0; g < queryGrams.size(); g++) {
+      auto list = postings.find(queryGrams[g]);
+      if (list == postings.end()) continue;
+      for (size_t i = 0; i < list->second.size(); i++) {
+        if (++shared[list->second[i]] == needed) {
+          candidates.push_back(list->second[i]);
+        }
+      }
+    }
+  }
+
+  // Candidates are verified with the edit distance
+  std::vector<std::pair<int, uint32_t>> scored;
+  for (size_t c = 0; c < candidates.size(); c++) {
+    int distance = substringDistance(f, folded[candidates[c]], maxEdits);
+    if (distance <= maxEdits) {
+      scored.push_back(std::make_pair(distance, candidates[c]));
+    }
+  }
+  std::sort(scored.begin(), scored.end(),
+            [this](const std::pair<int, uint32_t>& a,
+                   const std::pair<int, uint32_t>& b) {
+              if (a.first != b.first) return a.first < b.first;
+              if (keys[a.second].size() != keys[b.second].size()) {
+                return keys[a.second].size() < keys[b.second].size();
+              }
+              return a.second < b.second;
+            });
+
+  std::vector<std::string> matches;
+  for (size_t s = 0; s < scored.size() && matches.size() < limit; s++) {
+    matches.push_back(keys[scored[s].second]);
+  }
+  return matches;
+}
+
+/**
+ * Gets the fewest edits turning a fragment into some substring of a text
+ * @param fragment the piece to look for
+ * @param text the text to look in
+ * @param bound distances above this are not computed exactly
+ * @return the edit distance (0 if fragment occurs in text), or bound + 1
+ * if it is larger than bound
+ */
+int TrigramIndex::substringDistance(const std::string& fragment,
+                                    const std::string& text, int bound) {
+  // Levenshtein where the match may start and end anywhere in text
+  std::vector<int> previous(text.size() + 1, 0);
+  std::vector<int> current(text.size() + 1);
+  for (size_t i = 1; i <= fragment.size(); i++) {
+    current[0] = i;
+    int rowBest = current[0];
+    for (size_t j = 1; j <= text.size(); j++) {
+      int substitute = previous[j - 1] + (fragment[i - 1] != text[j - 1]);
+      current[j] = std::min(std::min(previous[j], current[j - 1]) + 1,
+                            substitute);
+      rowBest = std::min(rowBest, current[j]);
+    }
+    // Row minimums never decrease, so the answer is already too large
+    if (rowBest > bound) return bound + 1;
+    previous.swap(current);
+  }
+  return *std::min_element(previous.begin(), previous.end());
+}
+
+/**
+ * Gets the number of indexed strings
+ * @return number of strings
+ */
+size_t TrigramIndex::size() { return ids.size(); }
+
+/**
+ * Gets the approximate memory held by the index
+ * @return bytes used by strings and posting lists
+ */
+size_t TrigramIndex::bytes() {
+  size_t used = 0;
+  for (size_t id = 0; id < keys.size(); id++) {
+    used += 2 * sizeof(std::string) + StringBytes::heap(keys[id]) +
+            StringBytes::heap(folded[id]);
+  }
+  for (auto it = ids.begin(); it != ids.end(); ++it) {
+    used += sizeof(*it) + 2 * sizeof(void*) + StringBytes::heap(it->first);
+  }
+  for (auto it = postings.begin(); it != postings.end(); ++it) {
+    used += sizeof(uint32_t) + sizeof(std::vector<uint32_t>) +
+            2 * sizeof(void*) + it->second.capacity() * sizeof(uint32_t);
+  }
+  return used;
+}
+
+/**
+ * Removes every string
+ */
+void TrigramIndex::clear() {
+  ids.clear();
+  folded.clear();
+  keys.clear();
+  freeIds.clear();
+  postings.clear();
+}
@@ -7,6 +7,9 @@
 
 #include <iostream>
 #include <string>
+
+#include "StringBytes.h"
+
 /**
  * Constructor for User
  * @param n Username of new user
@@ -22,3 +25,9 @@ User::User(std::string n) {
  * @return username of user as string name
  */
 std::string User::getName() { return name; }
+
+/**
+ * Gets the approximate memory held by a user
+ * @return bytes used by the user and its name
+ */
+size_t User::bytes() { return sizeof(User) + StringBytes::heap(name); }
@@ -0,0 +1,189 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "WebSocketClient.h"
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "WebSocketCodec.h"
+
+WebSocketClient::WebSocketClient() : fd(-1) {}
+WebSocketClient::~WebSocketClient() { close(); }
+
+/**
+ * Opens a TCP connection and performs the WebSocket handshake
+ * @param host server host name
+ * @param port server port
+ * @param path resource path to upgrade
+ * @return true if the server accepted the upgrade
+ */
+bool WebSocketClient::connect(const std::string& host, int port,
+                              const std::string& path) {
+  close();
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = NULL;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                  &addresses) != 0) {
+    return false;
+  }
+  for (addrinfo* a = addresses; a != NULL && fd < 0; a = a->ai_next) {
+    fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0) return false;
+
+  // Random 16 byte nonce for Sec-WebSocket-Key
+  srand(time(NULL) ^ getpid());
+  std::string nonce;
+  for (int i = 0; i < 16; i++) nonce += static_cast<char>(rand() & 0xFF);
+  std::string key = WebSocketCodec::base64(nonce);
+  std::string handshake = "GET " + path + " HTTP/1.1\r\n" + "Host: " + host +
+                          ":" + std::to_string(port) + "\r\n" +
+                          "Upgrade: websocket\r\n" +
+                          "Connection: Upgrade\r\n" +
+                          "Sec-WebSocket-Key: " + key + "\r\n" +
+                          "Sec-WebSocket-Version: 13\r\n\r\n";
+  if (!writeAll(handshake)) return false;
+
+  // Reads the response headers, anything after them is frame data
+  size_t end;
+  while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+    if (!fill(5000)) {
+      close();
+      return false;
+    }
+  }
+  std::string headers = buffer.substr(0, end);
+  buffer.erase(0, end + 4);
+  if (headers.find(" 101") == std::string::npos ||
+      headers.find(WebSocketCodec::acceptKey(key)) == std::string::npos) {
+    close();  // Server does not speak WebSocket on this path
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Checks whether the connection is open
+ * @return true if open
+ */
+bool WebSocketClient::isOpen() { return fd >= 0; }
+
+/**
+ * Sends a binary message
+ * @param payload the message
+ * @return false if the connection failed
+ */
+bool WebSocketClient::send(const std::string& payload) {
+  if (fd < 0) return false;
+  return writeAll(WebSocketCodec::encode(WebSocketCodec::BINARY, payload,
+                                         true));
+}
+
+/**
+ * Receives the next data message, answering pings along the way
+ * @param payload set to the message
+ * @param timeoutMs milliseconds to wait, negative to block
+ * @return false on timeout or if the connection closed
+ */
+bool WebSocketClient::receive(std::string* payload, int timeoutMs) {
+  while (fd >= 0) {
+    bool fin;
+    int opcode;
+    std::string data;
+    if (!WebSocketCodec::decode(&buffer, &fin, &opcode, &data)) {
+      if (!fill(timeoutMs)) return false;
+      continue;
+    }
+    switch (opcode) {
+      case WebSocketCodec::PING: {
+        writeAll(WebSocketCodec::encode(WebSocketCodec::PONG, data, true));
+        break;
+      }
+      case WebSocketCodec::CLOSE: {
+        close();
+        return false;
+      }
+      case WebSocketCodec::PONG: {
+        break;
+      }
+      default: {  // Data frames, possibly fragmented
+        partial += data;
+        if (fin) {
+          payload->swap(partial);
+          partial.clear();
+          return true;
+        }
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Sends a close frame and closes the connection
+ */
+void WebSocketClient::close() {
+  if (fd < 0) return;
+  std::string frame = WebSocketCodec::encode(WebSocketCodec::CLOSE, "", true);
+  ::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+  ::close(fd);
+  fd = -1;
+  buffer.clear();
+  partial.clear();
+}
+
+/**
+ * Writes all bytes to the socket
+ * @param data the bytes
+ * @return false if the connection failed
+ */
+bool WebSocketClient::writeAll(const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = ::send(fd, data.data() + sent, data.size() - sent,
+                       MSG_NOSIGNAL);
+    if (n <= 0) {
+      ::close(fd);
+      fd = -1;
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+/**
+ * Waits for and appends more bytes to buffer
+ * @param timeoutMs milliseconds to wait, negative to block
+ * @return false on timeout or if the connection closed
+ */
+bool WebSocketClient::fill(int timeoutMs) {
+  pollfd p = {fd, POLLIN, 0};
+  if (poll(&p, 1, timeoutMs) <= 0) return false;  // Timed out
+  char chunk[4096];
+  ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+  if (n <= 0) {  // Server went away
+    ::close(fd);
+    fd = -1;
+    return false;
+  }
+  buffer.append(chunk, n);
+  return true;
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "WebSocketCodec.h"
+
+#include <cstdlib>
+#include <string>
+
+/**
+ * Rotates a 32 bit word left
+ * @param value the word
+ * @param bits number of bits to rotate by
+ * @return the rotated word
+ */
+static uint32_t rotl(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+/**
+ * Computes the SHA-1 digest of a string
+ * @param data the bytes to hash
+ * @return the 20 byte raw digest
+ */
+std::string WebSocketCodec::sha1(const std::string& data) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                   0xC3D2E1F0};
+
+  // Pads the message to a multiple of 64 bytes ending in its bit length
+  std::string msg = data;
+  uint64_t bitLength = static_cast<uint64_t>(data.size()) * 8;
+  msg += static_cast<char>(0x80);
+  while (msg.size() % 64 != 56) msg += static_cast<char>(0);
+  for (int i = 7; i >= 0; i--) {
+    msg += static_cast<char>((bitLength >> (i * 8)) & 0xFF);
+  }
+
+  for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+    uint32_t w[80];
+    const uint8_t* block = reinterpret_cast<const uint8_t*>(msg.data()) + chunk;
+    for (int i = 0; i < 16; i++) {  // Big-endian words of the block
+      w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+             (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+             (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+             static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; i++) {
+      w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rotl(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  std::string digest;
+  for (int i = 0; i < 5; i++) {
+    for (int j = 3; j >= 0; j--) {
+      digest += static_cast<char>((h[i] >> (j * 8)) & 0xFF);
+    }
+  }
+  return digest;
+}
+
+/**
+ * Encodes bytes as base64
+ * @param data the bytes to encode
+ * @return the base64 text
+ */
+std::string WebSocketCodec::base64(const std::string& data) {
+  static const char* alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string result;
+  size_t i = 0;
+  for (; i + 2 < data.size(); i += 3) {  // Whole 3 byte groups
+    uint32_t n = (static_cast<uint8_t>(data[i]) << 16) |
+                 (static_cast<uint8_t>(data[i + 1]) << 8) |
+                 static_cast<uint8_t>(data[i + 2]);
+    result += alphabet[(n >> 18) & 63];
+    result += alphabet[(n >> 12) & 63];
+    result += alphabet[(n >> 6) & 63];
+    result += alphabet[n & 63];
+  }
+  if (i < data.size()) {  // Trailing 1 or 2 bytes are padded with '='
+    uint32_t n = static_cast<uint8_t>(data[i]) << 16;
+    if (i + 1 < data.size()) n |= static_cast<uint8_t>(data[i + 1]) << 8;
+    result += alphabet[(n >> 18) & 63];
+    result += alphabet[(n >> 12) & 63];
+    result += i + 1 < data.size() ? alphabet[(n >> 6) & 63] : '=';
+    result += '=';
+  }
+  return result;
+}
+
+/**
+ * Computes the Sec-WebSocket-Accept value for a Sec-WebSocket-Key
+ * @param key the client's Sec-WebSocket-Key header
+ * @return the value the server must answer with
+ */
+std::string WebSocketCodec::acceptKey(const std::string& key) {
+  return base64(sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"));
+}
+
+/**
+ * Encodes a single unfragmented frame
+ * @param opcode frame opcode
+ * @param payload frame payload
+ * @param mask true for client to server frames, which must be masked
+ * @return the frame bytes
+ */
+std::string WebSocketCodec::encode(int opcode, const std::string& payload,
+                                   bool mask) {
+  std::string frame;
+  frame += static_cast<char>(0x80 | (opcode & 0x0F));  // FIN + opcode
+  uint8_t maskBit = mask ? 0x80 : 0x00;
+  uint64_t length = payload.size();
+  if (length < 126) {
+    frame += static_cast<char>(maskBit | length);
+  } else if (length <= 0xFFFF) {
+    frame += static_cast<char>(maskBit | 126);
+    frame += static_cast<char>((length >> 8) & 0xFF);
+    frame += static_cast<char>(length & 0xFF);
+  } else {
+    frame += static_cast<char>(maskBit | 127);
+    for (int i = 7; i >= 0; i--) {
+      frame += static_cast<char>((length >> (i * 8)) & 0xFF);
+    }
+  }
+
+  if (!mask) return frame + payload;
+  char key[4];
+  for (int i = 0; i < 4; i++) key[i] = static_cast<char>(rand() & 0xFF);
+  frame.append(key, 4);
+  size_t start = frame.size();
+  frame += payload;
+  for (size_t i = 0; i < payload.size(); i++) frame[start + i] ^= key[i % 4];
+  return frame;
+}
+
+/**
+ * Decodes one frame from the front of a buffer and removes it
+ * @param buffer bytes received so far
+ * @param fin set to true if this is the final fragment of a message
+ * @param opcode set to the frame opcode
+ * @param payload set to the unmasked payload
+ * @return false if the buffer does not yet hold a complete frame
+ */
+bool WebSocketCodec::decode(std::string* buffer, bool* fin, int* opcode,
+                            std::string* payload) {
+  if (buffer->size() < 2) return false;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer->data());
+  size_t header = 2;
+  uint64_t length = bytes[1] & 0x7F;
+  if (length == 126) {
+    header += 2;
+    if (buffer->size() < header) return false;
+    length = (bytes[2] << 8) | bytes[3];
+  } else if (length == 127) {
+    header += 8;
+    if (buffer->size() < header) return false;
+    length = 0;
+    for (int i = 0; i < 8; i++) length = (length << 8) | bytes[2 + i];
+  }
+  bool masked = (bytes[1] & 0x80) != 0;
+  size_t maskStart = header;
+  if (masked) header += 4;
+  if (buffer->size() < header + length) return false;  // Frame incomplete
+
+  *fin = (bytes[0] & 0x80) != 0;
+  *opcode = bytes[0] & 0x0F;
+  payload->assign(*buffer, header, length);
+  if (masked) {
+    for (size_t i = 0; i < length; i++) {
+      (*payload)[i] ^= (*buffer)[maskStart + i % 4];
+    }
+  }
+  buffer->erase(0, header + length);
+  return true;
+}
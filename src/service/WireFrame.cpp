@@ -0,0 +1,158 @@
+/**
+ * Copyright 2020 Cole_Anderson, Christian_Walker, Micheal_Wynnychuk,
+ * Radek_Lewandowski
+ */
+
+#include "WireFrame.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Encodes a frame
+ * @param kind frame kind
+ * @param id request id or version, depending on kind
+ * @param payload frame payload
+ * @return the encoded frame
+ */
+std::string WireFrame::encode(int kind, uint64_t id,
+                              const std::string& payload) {
+  std::string frame;
+  frame.reserve(payload.size() + 11);
+  frame += static_cast<char>(kind);
+  do {  // LEB128 varint, 7 bits per byte with a continuation bit
+    uint8_t byte = id & 0x7F;
+    id >>= 7;
+    if (id != 0) byte |= 0x80;
+    frame += static_cast<char>(byte);
+  } while (id != 0);
+  frame += payload;
+  return frame;
+}
+
+/**
+ * Decodes a frame
+ * @param frame the encoded frame
+ * @param kind set to the frame kind
+ * @param id set to the request id or version
+ * @param payload set to the frame payload
+ * @return false if the frame is malformed
+ */
+bool WireFrame::decode(const std::string& frame, int* kind, uint64_t* id,
+                       std::string* payload) {
+  if (frame.empty()) return false;
+  *kind = static_cast<uint8_t>(frame[0]);
+  *id = 0;
+  size_t pos = 1;
+  for (int shift = 0;; shift += 7) {
+    if (pos >= frame.size() || shift > 63) return false;  // Truncated varint
+    uint8_t byte = static_cast<uint8_t>(frame[pos++]);
+    *id |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) break;
+  }
+  payload->assign(frame, pos, std::string::npos);
+  return true;
+}
+
+/**
+ * Escapes the characters a GET_REQUEST payload gives meaning to
+ * @param text a key or value
+ * @return text with "%" and "~" percent-encoded
+ */
+static std::string escapeField(const std::string& text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '%') {
+      escaped += "%25";
+    } else if (text[i] == '~') {
+      escaped += "%7E";
+    } else {
+      escaped += text[i];
+    }
+  }
+  return escaped;
+}
+
+/**
+ * Reads one hex digit
+ * @param c the digit
+ * @return its value, or -1 if c is not a hex digit
+ */
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Undoes escapeField
+ * @param text an escaped key or value
+ * @param field set to the original text
+ * @return false if a "%" is not followed by two hex digits
+ */
+static bool unescapeField(const std::string& text, std::string* field) {
+  field->clear();
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] != '%') {
+      *field += text[i];
+      continue;
+    }
+    if (i + 2 >= text.size()) return false;
+    int high = hexDigit(text[i + 1]);
+    int low = hexDigit(text[i + 2]);
+    if (high < 0 || low < 0) return false;
+    *field += static_cast<char>(high * 16 + low);
+    i += 2;
+  }
+  return true;
+}
+
+/**
+ * Joins query parameters into a GET_REQUEST payload
+ * @param params the parameters, in order
+ * @return "key~value" pairs joined by "~", with "%" and "~" escaped
+ */
+std::string WireFrame::encodeParams(
+    const std::vector<std::pair<std::string, std::string>>& params) {
+  std::string payload;
+  for (size_t i = 0; i < params.size(); i++) {
+    if (i > 0) payload += '~';
+    payload += escapeField(params[i].first) + "~" +
+               escapeField(params[i].second);
+  }
+  return payload;
+}
+
+/**
+ * Splits a GET_REQUEST payload back into query parameters
+ * @param payload the payload
+ * @param params set to the parameters, in order
+ * @return false if a key has no value or an escape is malformed
+ */
+bool WireFrame::decodeParams(
+    const std::string& payload,
+    std::vector<std::pair<std::string, std::string>>* params) {
+  params->clear();
+  if (payload.empty()) return true;
+  std::vector<std::string> fields;
+  size_t start = 0;
+  for (size_t tilde; (tilde = payload.find('~', start)) != std::string::npos;
+       start = tilde + 1) {
+    fields.push_back(payload.substr(start, tilde - start));
+  }
+  fields.push_back(payload.substr(start));
+  if (fields.size() % 2 != 0) return false;
+
+  for (size_t f = 0; f < fields.size(); f += 2) {
+    std::pair<std::string, std::string> param;
+    if (!unescapeField(fields[f], &param.first) ||
+        !unescapeField(fields[f + 1], &param.second)) {
+      return false;
+    }
+    params->push_back(param);
+  }
+  return true;
+}
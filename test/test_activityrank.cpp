@@ -0,0 +1,47 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <utility>
+#include <vector>
+
+#include "ActivityRank.h"
+#include "gtest/gtest.h"
+
+TEST(ActivityRankTest, Test_Top) {
+  ActivityRank* rank = new ActivityRank(10);  // Ten second half-life
+  rank->record(1, 0, 4);
+  rank->record(2, 0);
+  rank->record(3, 0, 2);
+  ASSERT_EQ(3, rank->size());
+  std::vector<std::pair<uint64_t, double>> top = rank->top(2, 0);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ(1, top[0].first);
+  ASSERT_DOUBLE_EQ(4, top[0].second);
+  ASSERT_EQ(3, top[1].first);
+
+  // Three recent comments outweigh four from two half-lives ago
+  rank->record(2, 20, 3);
+  top = rank->top(3, 20);
+  ASSERT_EQ(2, top[0].first);
+  ASSERT_DOUBLE_EQ(3.25, top[0].second);
+  ASSERT_DOUBLE_EQ(1, top[1].second);
+  ASSERT_EQ(3, top[2].first);
+
+  // Far past the landmark scores are rescaled without changing the order
+  rank->record(3, 10000);
+  top = rank->top(10, 10000);
+  ASSERT_EQ(3, top[0].first);
+  ASSERT_DOUBLE_EQ(1, top[0].second);
+  ASSERT_EQ(3, top.size());
+
+  rank->remove(3);
+  rank->remove(42);  // Not ranked
+  top = rank->top(10, 10000);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ(2, top[0].first);
+  ASSERT_GT(rank->bytes(), 0);
+
+  rank->clear();
+  ASSERT_TRUE(rank->top(10, 0).empty());
+  delete rank;
+}
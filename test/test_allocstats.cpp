@@ -0,0 +1,43 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <thread>  // NOLINT
+
+#include "AllocStats.h"
+#include "gtest/gtest.h"
+
+TEST(AllocStatsTest, Test_Record) {
+  // The test binary keeps the usual operator new, so only these count
+  AllocStats::setEnabled(false);
+  AllocStats::Counts before = AllocStats::thread();
+  AllocStats::record(100);
+  ASSERT_FALSE(AllocStats::enabled());
+  ASSERT_EQ(before.allocations, AllocStats::thread().allocations);
+
+  AllocStats::setEnabled(true);
+  ASSERT_TRUE(AllocStats::enabled());
+  AllocStats::record(100);
+  AllocStats::beginRequest();
+  AllocStats::record(16);
+  AllocStats::record(48);
+  AllocStats::Counts request = AllocStats::request();
+  ASSERT_EQ(2, request.allocations);
+  ASSERT_EQ(64, request.bytes);
+  ASSERT_EQ(before.allocations + 3, AllocStats::thread().allocations);
+  ASSERT_EQ(before.bytes + 164, AllocStats::thread().bytes);
+
+  // Another thread's allocations are its own
+  std::thread other([]() {
+    AllocStats::beginRequest();
+    AllocStats::record(1000);
+    ASSERT_EQ(1, AllocStats::request().allocations);
+    ASSERT_EQ(1000, AllocStats::thread().bytes);
+  });
+  other.join();
+  ASSERT_EQ(2, AllocStats::request().allocations);
+
+  AllocStats::beginRequest();
+  ASSERT_EQ(0, AllocStats::request().allocations);
+  ASSERT_EQ(0, AllocStats::request().bytes);
+  AllocStats::setEnabled(false);
+}
@@ -0,0 +1,75 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bitmap.h"
+#include "BitmapIndex.h"
+#include "gtest/gtest.h"
+
+TEST(BitmapTest, Test_SetAlgebra) {
+  Bitmap* evens = new Bitmap();
+  Bitmap* small = new Bitmap();
+  for (uint32_t i = 0; i < 200000; i += 2) evens->add(i);  // Dense groups
+  for (uint32_t i = 0; i < 200000; i += 1000) small->add(i + 1);
+  small->add(4);
+  small->add(4);  // Already present
+  ASSERT_EQ(100000, evens->cardinality());
+  ASSERT_EQ(201, small->cardinality());
+  ASSERT_TRUE(evens->contains(65536));
+  ASSERT_FALSE(evens->contains(65537));
+
+  // Only 4 is both even and in small
+  std::vector<uint32_t> expected = {4};
+  ASSERT_EQ(expected, Bitmap::intersect(*evens, *small).values());
+  ASSERT_EQ(1, Bitmap::intersectCount(*evens, *small));
+  ASSERT_EQ(100200, Bitmap::unite(*evens, *small).cardinality());
+  ASSERT_EQ(200, Bitmap::subtract(*small, *evens).cardinality());
+  Bitmap odd = Bitmap::subtract(*evens, *small);
+  ASSERT_EQ(99999, odd.cardinality());
+  ASSERT_FALSE(odd.contains(4));
+
+  // Removing most of a dense group turns it back into an array
+  for (uint32_t i = 0; i < 65536; i += 2) {
+    if (i != 10) evens->remove(i);
+  }
+  std::vector<uint32_t> first = evens->values();
+  ASSERT_EQ(10, first[0]);
+  ASSERT_EQ(65536, first[1]);
+  ASSERT_EQ(Bitmap::intersect(*evens, *evens).cardinality(),
+            evens->cardinality());
+  ASSERT_GT(evens->bytes(), small->bytes());
+
+  evens->clear();
+  ASSERT_TRUE(evens->empty());
+  ASSERT_TRUE(Bitmap::intersect(*evens, *small).empty());
+  delete evens;
+  delete small;
+}
+
+TEST(BitmapTest, Test_Index) {
+  BitmapIndex* index = new BitmapIndex();
+  index->add("label:ui", 1);
+  index->add("label:ui", 3);
+  index->add("type:Bug", 3);
+  index->add("type:Bug", 4);
+  ASSERT_EQ(2, index->get("label:ui").cardinality());
+  ASSERT_TRUE(index->get("label:none").empty());
+
+  Bitmap within;
+  within.add(3);
+  within.add(4);
+  std::vector<std::pair<std::string, uint64_t>> expected = {
+      {"label:ui", 1}, {"type:Bug", 2}};
+  ASSERT_EQ(expected, index->counts(within));
+
+  index->remove("label:ui", 1);
+  index->remove("label:ui", 3);
+  ASSERT_EQ(1, index->size());  // Empty facets are dropped
+  ASSERT_GT(index->bytes(), 0);
+  index->clear();
+  ASSERT_EQ(0, index->size());
+  delete index;
+}
@@ -0,0 +1,42 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include "ChangeLog.h"
+#include "gtest/gtest.h"
+
+TEST(ChangeLogTest, Test_Since) {
+  ChangeLog* log = new ChangeLog(3);
+  ASSERT_EQ(0, log->getVersion());
+  ASSERT_TRUE(log->covers(0));
+  ASSERT_TRUE(log->since(0).empty());
+
+  log->record("addIssue", "first");
+  log->record("addComment", "first");
+  ASSERT_EQ(2, log->getVersion());
+  std::vector<Change> delta = log->since(0);
+  ASSERT_EQ(2, delta.size());
+  ASSERT_EQ("addIssue", delta[0].kind);
+  ASSERT_EQ("first", delta[1].key);
+  ASSERT_EQ(2, delta[1].seq);
+
+  // Versions newer than the log (e.g. from another run) are not covered
+  ASSERT_FALSE(log->covers(5));
+  delete log;
+}
+TEST(ChangeLogTest, Test_Wraparound) {
+  ChangeLog* log = new ChangeLog(3);
+  log->record("addIssue", "a");
+  log->record("addIssue", "b");
+  log->record("addIssue", "c");
+  log->record("deleteIssue", "a");
+
+  // Change 1 was overwritten, so a client at version 0 is too far behind
+  ASSERT_FALSE(log->covers(0));
+  ASSERT_TRUE(log->since(0).empty());
+  std::vector<Change> delta = log->since(1);
+  ASSERT_EQ(3, delta.size());
+  ASSERT_EQ("b", delta[0].key);
+  ASSERT_EQ("deleteIssue", delta[2].kind);
+  ASSERT_GE(log->bytes(), 3 * sizeof(Change));
+  delete log;
+}
@@ -0,0 +1,46 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+
+#include "Compression.h"
+#include "ResponseCache.h"
+#include "gtest/gtest.h"
+
+TEST(CompressionTest, Test_RoundTrip) {
+  std::string body;
+  for (int i = 0; i < 500; i++) body += "{\"title\":\"issue\"}^]";
+  std::string packed = Compression::gzip(body);
+  ASSERT_LT(packed.size(), body.size() / 10);
+  ASSERT_EQ('\x1f', packed[0]);  // gzip magic
+  std::string unpacked;
+  ASSERT_TRUE(Compression::gunzip(packed, &unpacked));
+  ASSERT_EQ(body, unpacked);
+  ASSERT_FALSE(Compression::gunzip("not gzip", &unpacked));
+
+  ASSERT_TRUE(Compression::acceptsGzip("gzip, deflate, br"));
+  ASSERT_TRUE(Compression::acceptsGzip("br;q=1.0, gzip;q=0.5"));
+  ASSERT_TRUE(Compression::acceptsGzip("*"));
+  ASSERT_FALSE(Compression::acceptsGzip("gzip;q=0"));
+  ASSERT_FALSE(Compression::acceptsGzip("identity"));
+  ASSERT_FALSE(Compression::acceptsGzip(""));
+}
+
+TEST(ResponseCacheTest, Test_Version) {
+  ResponseCache* cache = new ResponseCache(2);
+  std::string body, encoding;
+  ASSERT_FALSE(cache->get("a", 0, &body, &encoding));
+  cache->put("a", 1, "zipped", "gzip");
+  ASSERT_TRUE(cache->get("a", 1, &body, &encoding));
+  ASSERT_EQ("zipped", body);
+  ASSERT_EQ("gzip", encoding);
+  ASSERT_FALSE(cache->get("a", 2, &body, &encoding));
+
+  cache->put("b", 2, "plain", "");
+  ASSERT_EQ(1, cache->size());  // Version 1 entries dropped
+  cache->put("c", 2, "plain", "");
+  cache->put("d", 2, "plain", "");
+  ASSERT_EQ(1, cache->size());  // Full cache started over
+  ASSERT_EQ(6, cache->bytes());
+  delete cache;
+}
@@ -0,0 +1,107 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "DatasetGenerator.h"
+#include "IssueTracker.h"
+#include "gtest/gtest.h"
+
+TEST(DatasetGeneratorTest, Test_Distributions) {
+  std::mt19937_64 random(7);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  auto next = [&]() { return uniform(random); };
+
+  // With s = 1 and ten ranks the first comes up 1 / H(10) = 34% of the time
+  ZipfDistribution zipf(10, 1.0);
+  AliasTable table(10, 1.0);
+  std::vector<int> zipfCounts(11, 0);
+  std::vector<int> tableCounts(11, 0);
+  for (int i = 0; i < 100000; i++) {
+    uint64_t rank = zipf.sample(next);
+    ASSERT_GE(rank, 1);
+    ASSERT_LE(rank, 10);
+    zipfCounts[rank]++;
+    rank = table.sample(random());
+    ASSERT_GE(rank, 1);
+    ASSERT_LE(rank, 10);
+    tableCounts[rank]++;
+  }
+  ASSERT_NEAR(34142, zipfCounts[1], 1000);
+  ASSERT_NEAR(34142, tableCounts[1], 1000);
+  ASSERT_NEAR(3414, zipfCounts[10], 400);
+  ASSERT_NEAR(3414, tableCounts[10], 400);
+
+  // s = 0 is uniform
+  ZipfDistribution flat(4, 0);
+  std::vector<int> flatCounts(5, 0);
+  for (int i = 0; i < 40000; i++) flatCounts[flat.sample(next)]++;
+  for (int r = 1; r <= 4; r++) ASSERT_NEAR(10000, flatCounts[r], 500);
+
+  // Every rank spells its own word
+  std::set<std::string> words;
+  for (uint64_t rank = 1; rank <= 5000; rank++) {
+    words.insert(DatasetGenerator::word(rank));
+  }
+  ASSERT_EQ(5000, words.size());
+  ASSERT_EQ("ka", DatasetGenerator::word(1));
+  ASSERT_EQ("kaka", DatasetGenerator::word(17));
+}
+
+TEST(DatasetGeneratorTest, Test_WriteLoads) {
+  DatasetSpec spec;
+  spec.issues = 200;
+  spec.comments = 1000;
+  spec.users = 20;
+  spec.labels = 5;
+  spec.labelsPerIssue = 1;
+  spec.commentSkew = 1.2;
+  DatasetGenerator generator(spec);
+  std::string error;
+  ASSERT_TRUE(generator.write("", &error));
+  ASSERT_GT(generator.bytesWritten(), 0);
+
+  IssueTracker* tracker = new IssueTracker();
+  tracker->readFile();
+  std::vector<Issue*> issues = tracker->getIssueVec();
+  ASSERT_EQ(200, issues.size());
+  ASSERT_EQ(20, tracker->getUserVec().size());
+  uint64_t comments = 0;
+  uint64_t labelled = 0;
+  for (int i = 0; i < issues.size(); i++) {
+    comments += issues[i]->getCommentNum();
+    if (!issues[i]->getLabels().empty()) labelled++;
+  }
+  ASSERT_EQ(1000, comments);
+  ASSERT_EQ(200, labelled);
+  ASSERT_GT(issues[0]->getCommentNum(), issues[199]->getCommentNum());
+
+  // Every comment block reached its own issue, even past issues without
+  // a block
+  std::map<std::string, int> blocks;
+  std::ifstream file("comments.txt");
+  std::string block;
+  while (getline(file, block, '*')) {
+    if (block.empty()) continue;
+    int separators = 0;
+    for (size_t p = block.find("^]"); p != std::string::npos;
+         p = block.find("^]", p + 2)) {
+      separators++;
+    }
+    blocks[block.substr(0, block.find("^]"))] = (separators - 1) / 2;
+  }
+  ASSERT_LT(blocks.size(), 200);
+  for (int i = 0; i < issues.size(); i++) {
+    ASSERT_EQ(blocks[issues[i]->getIssueTitle()], issues[i]->getCommentNum());
+  }
+
+  tracker->memoryCleanCom();
+  tracker->memoryCleanIssues();
+  delete tracker;
+}
@@ -1,6 +1,12 @@
 // Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
 // Radek_Lewandowski
 
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "Issue.h"
 #include "IssueTracker.h"
 #include "User.h"
@@ -177,6 +183,563 @@ TEST(MockIssueTracker, getAllUsers) {
 
   delete IssueTracker;
 }
+TEST(MockIssueTracker, version) {
+  MockIssueTracker* issuetracker = new MockIssueTracker();
+  Issue* i = new Issue("Versioned", "desc", "Linux", "Bug", "user", "user");
+  std::string result;
+  ASSERT_EQ(0, issuetracker->getVersion());
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToCommentVec("Versioned", "first", "user", result);
+  ASSERT_EQ(1, issuetracker->getVersion());
+  // Comments on missing issues change nothing
+  issuetracker->addToCommentVec("Missing", "second", "user", result);
+  ASSERT_EQ(1, issuetracker->getVersion());
+
+  issuetracker->memoryCleanCom();
+  delete i;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, changeFeed) {
+  MockIssueTracker* issuetracker = new MockIssueTracker();
+  Issue* i = new Issue("Feed", "desc", "Linux", "Bug", "user", "user");
+  std::string result;
+  issuetracker->addToIssueVec(i);
+  ASSERT_EQ("(DELTA)^]0^]", issuetracker->getChangesSince(0));
+  issuetracker->addToCommentVec("Feed", "first", "user", result);
+  ASSERT_EQ("(DELTA)^]1^]addComment^]Feed^]",
+            issuetracker->getChangesSince(0));
+  ASSERT_EQ("(DELTA)^]1^]", issuetracker->getChangesSince(1));
+  // Unknown versions fall back to a snapshot of every title
+  ASSERT_EQ("(SNAPSHOT)^]1^]Feed^]", issuetracker->getChangesSince(7));
+
+  issuetracker->memoryCleanCom();
+  delete i;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, queryIssues) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Crash", "desc", "Linux", "Bug", "ann", "bob");
+  Issue* i1 = new Issue("Theme", "desc", "Linux", "Feature", "bob", "ann");
+  Issue* i2 = new Issue("Leak", "desc", "MacOS", "Bug", "ann", "bob");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToIssueVec(i2);
+  ASSERT_EQ(1, i->getId());
+  ASSERT_EQ(3, i2->getId());
+
+  ASSERT_EQ("Crash[^Leak[^", issuetracker->queryIssues("", "Bug", "", ""));
+  ASSERT_EQ("Crash[^", issuetracker->queryIssues("Linux", "Bug", "", "bob"));
+  ASSERT_EQ("Theme[^", issuetracker->queryIssues("", "", "bob", ""));
+  ASSERT_EQ("(BLANK)[^", issuetracker->queryIssues("Windows", "", "", ""));
+  ASSERT_EQ(3, issuetracker->findIssues("", "", "", "").size());
+
+  // Deleted issues leave every index
+  issuetracker->deleteIssue("Crash");
+  ASSERT_EQ("Leak[^", issuetracker->queryIssues("", "Bug", "ann", ""));
+
+  delete i;
+  delete i1;
+  delete i2;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, pagination) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("One", "desc", "Linux", "Bug", "ann", "bob");
+  Issue* i1 = new Issue("Two", "desc", "Linux", "Bug", "ann", "bob");
+  Issue* i2 = new Issue("Three", "desc", "Linux", "Bug", "ann", "bob");
+  User* u = new User("cat");
+  User* u1 = new User("ann");
+  User* u2 = new User("bob");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToIssueVec(i2);
+  issuetracker->addToUserVec(u);
+  issuetracker->addToUserVec(u1);
+  issuetracker->addToUserVec(u2);
+
+  // Issue pages resume after the id of the last title sent
+  ASSERT_EQ("One[^Two[^(MORE)2[^", issuetracker->getIssuePage(0, 2));
+  ASSERT_EQ("Three[^", issuetracker->getIssuePage(2, 2));
+  issuetracker->deleteIssue("Two");
+  ASSERT_EQ("Three[^", issuetracker->getIssuePage(1, 2));
+
+  // User pages are alphabetical and resume after the last name sent
+  ASSERT_EQ("ann-bob-(MORE)bob-", issuetracker->getUserPage("", 2));
+  ASSERT_EQ("cat-", issuetracker->getUserPage("bob", 2));
+
+  // Comment pages repeat the issue fields
+  for (int c = 0; c < 3; c++) {
+    Comment* com = new Comment();
+    com->setText("c" + std::to_string(c));
+    com->setUser("cat");
+    i->addToComments(com);
+  }
+  ASSERT_EQ("One^]desc^]Linux^]Bug^]ann^]bob^]c0^]cat^]c1^]cat^](MORE)2^]",
+            issuetracker->getAnIssuePage("One", 0, 2));
+  ASSERT_EQ("One^]desc^]Linux^]Bug^]ann^]bob^]c2^]cat^]",
+            issuetracker->getAnIssuePage("One", 2, 2));
+  // A cursor near the top of size_t does not wrap around to the start
+  ASSERT_EQ("One^]desc^]Linux^]Bug^]ann^]bob^]",
+            issuetracker->getAnIssuePage("One", SIZE_MAX - 1, 2));
+  ASSERT_EQ("(BLANK)[^", issuetracker->getAnIssuePage("Two", 0, 2));
+
+  i->memoryCleanComments();
+  delete i;
+  delete i1;
+  delete i2;
+  delete u;
+  delete u1;
+  delete u2;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, searchIssues) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Login crash", "App crashes on login", "Linux", "Bug",
+                       "ann", "bob");
+  Issue* i1 = new Issue("Dark theme", "Add a dark theme", "Linux", "Feature",
+                        "bob", "ann");
+  Issue* i2 = new Issue("Slow login", "Login takes ages", "MacOS", "Bug",
+                        "ann", "bob");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToIssueVec(i2);
+  std::string result;
+
+  ASSERT_EQ("Login crash[^", issuetracker->searchIssues("CRASH", 10));
+  ASSERT_EQ("Dark theme[^", issuetracker->searchIssues("theme", 1));
+  ASSERT_EQ("(BLANK)[^", issuetracker->searchIssues("printer", 10));
+  // Comments are searchable as soon as they are added
+  issuetracker->addToCommentVec("Dark theme", "the printer dialog too",
+                                "ann", result);
+  ASSERT_EQ("Dark theme[^", issuetracker->searchIssues("printer", 10));
+  issuetracker->deleteIssue("Login crash");
+  ASSERT_EQ("Slow login[^", issuetracker->searchIssues("login crash", 10));
+
+  // The index is saved once per change, and reused on the next start
+  ASSERT_TRUE(issuetracker->saveIndex());
+  ASSERT_FALSE(issuetracker->saveIndex());
+  IssueTracker* reloaded = new IssueTracker();
+  reloaded->readFile();
+  ASSERT_FALSE(reloaded->saveIndex());
+  ASSERT_EQ("Dark theme[^", reloaded->searchIssues("printer", 10));
+
+  // An edit that keeps the store the same size still rebuilds the index
+  std::ifstream in("context.txt");
+  std::stringstream data;
+  data << in.rdbuf();
+  in.close();
+  std::string contents = data.str();
+  contents.replace(contents.find("ages"), 4, "days");
+  std::ofstream out("context.txt");
+  out << contents;
+  out.close();
+  IssueTracker* edited = new IssueTracker();
+  edited->readFile();
+  ASSERT_EQ("Slow login[^", edited->searchIssues("days", 10));
+  ASSERT_TRUE(edited->saveIndex());
+
+  issuetracker->memoryCleanCom();
+  reloaded->memoryCleanCom();
+  reloaded->memoryCleanIssues();
+  edited->memoryCleanCom();
+  edited->memoryCleanIssues();
+  delete i;
+  delete i1;
+  delete i2;
+  delete issuetracker;
+  delete reloaded;
+  delete edited;
+}
+TEST(MockIssueTracker, findIssueTitles) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Login crash on startup", "d", "Linux", "Bug", "ann",
+                       "bob");
+  Issue* i1 = new Issue("Dark theme", "d", "Linux", "Feature", "bob", "ann");
+  User* u = new User("annabelle");
+  User* u1 = new User("bob");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToUserVec(u);
+  issuetracker->addToUserVec(u1);
+
+  ASSERT_EQ("Login crash on startup[^",
+            issuetracker->findIssueTitles("CRASH ON", 0, 10));
+  ASSERT_EQ("(BLANK)[^", issuetracker->findIssueTitles("logn crash", 0, 10));
+  ASSERT_EQ("Login crash on startup[^",
+            issuetracker->findIssueTitles("logn crash", 1, 10));
+  ASSERT_EQ("Dark theme[^", issuetracker->findIssueTitles("dark", 0, 10));
+  ASSERT_EQ("annabelle-", issuetracker->findUsers("belle", 0, 10));
+  ASSERT_EQ("annabelle-", issuetracker->findUsers("anabelle", 1, 10));
+
+  delete i;
+  delete i1;
+  delete u;
+  delete u1;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, completeIssueTitles) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Login crash on startup", "d", "Linux", "Bug", "ann",
+                       "bob");
+  Issue* i1 = new Issue("login timeout", "d", "Linux", "Bug", "bob", "ann");
+  User* u = new User("annabelle");
+  User* u1 = new User("Anton");
+  User* u2 = new User("bob");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToUserVec(u);
+  issuetracker->addToUserVec(u1);
+  issuetracker->addToUserVec(u2);
+
+  ASSERT_EQ("Login crash on startup[^login timeout[^",
+            issuetracker->completeIssueTitles("LOG", 10));
+  ASSERT_EQ("Login crash on startup[^",
+            issuetracker->completeIssueTitles("log", 1));
+  ASSERT_EQ("(BLANK)[^", issuetracker->completeIssueTitles("crash", 10));
+  ASSERT_EQ("annabelle-Anton-", issuetracker->completeUsers("an", 10));
+  ASSERT_EQ("", issuetracker->completeUsers("carl", 10));
+
+  issuetracker->deleteIssue("login timeout");
+  ASSERT_EQ("Login crash on startup[^",
+            issuetracker->completeIssueTitles("log", 10));
+
+  delete i;
+  delete i1;
+  delete u;
+  delete u1;
+  delete u2;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, getStats) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Crash", "d", "Linux", "Bug", "ann", "bob");
+  Issue* i1 = new Issue("Theme", "d", "Linux", "Feature", "bob", "ann");
+  Issue* i2 = new Issue("Docs", "d", "Windows", "Task", "ann", "ann");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToIssueVec(i2);
+  issuetracker->addToCommentVec("Crash", "seen", "bob", "");
+  issuetracker->addToCommentVec("Docs", "typo", "ann", "");
+
+  std::string stats = issuetracker->getStats();
+  ASSERT_EQ(0, stats.find("total^]issues^]3^]total^]comments^]2^]"));
+  ASSERT_NE(std::string::npos, stats.find("os^]Linux^]2^]"));
+  ASSERT_NE(std::string::npos, stats.find("type^]Task^]1^]"));
+  ASSERT_NE(std::string::npos, stats.find("user^]ann^]2^]"));
+  ASSERT_NE(std::string::npos, stats.find("assign^]ann^]2^]"));
+
+  issuetracker->deleteIssue("Crash");
+  stats = issuetracker->getStats();
+  ASSERT_EQ(0, stats.find("total^]issues^]2^]total^]comments^]1^]"));
+  ASSERT_EQ(std::string::npos, stats.find("type^]Bug^]"));
+  ASSERT_NE(std::string::npos, stats.find("os^]Linux^]1^]"));
+
+  delete i;
+  delete i1;
+  delete i2;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, getStatsAfterRemovingUser) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Crash", "d", "Linux", "Bug", "ann", "bob");
+  Issue* i1 = new Issue("Theme", "d", "Linux", "Feature", "bob", "ann");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->createUser("ann");
+  issuetracker->createUser("bob");
+
+  // Issues of a removed user are counted under "user_Removed"
+  issuetracker->deleteUser("ann");
+  std::string stats = issuetracker->getStats();
+  ASSERT_EQ(std::string::npos, stats.find("^]ann^]"));
+  ASSERT_NE(std::string::npos, stats.find("user^]user_Removed^]1^]"));
+  ASSERT_NE(std::string::npos, stats.find("assign^]user_Removed^]1^]"));
+  ASSERT_EQ("Crash[^", issuetracker->queryIssues("", "", "user_Removed", ""));
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, getHotIssues) {
+  IssueTracker* issuetracker = new IssueTracker();
+  Issue* i = new Issue("Crash", "d", "Linux", "Bug", "ann", "bob");
+  Issue* i1 = new Issue("Theme", "d", "Linux", "Feature", "bob", "ann");
+  Issue* i2 = new Issue("Docs", "d", "Windows", "Task", "ann", "ann");
+  issuetracker->addToIssueVec(i);
+  issuetracker->addToIssueVec(i1);
+  issuetracker->addToIssueVec(i2);
+  ASSERT_EQ("(BLANK)[^", issuetracker->getHotIssues(10));
+
+  issuetracker->addToCommentVec("Docs", "typo", "ann", "");
+  issuetracker->addToCommentVec("Crash", "seen", "bob", "");
+  issuetracker->addToCommentVec("Crash", "again", "ann", "");
+  ASSERT_EQ("Crash[^Docs[^", issuetracker->getHotIssues(10));
+  ASSERT_EQ("Crash[^", issuetracker->getHotIssues(1));
+
+  issuetracker->deleteIssue("Crash");
+  ASSERT_EQ("Docs[^", issuetracker->getHotIssues(10));
+
+  delete i;
+  delete i1;
+  delete i2;
+  delete issuetracker;
+}
+TEST(MockIssueTracker, labels) {
+  IssueTracker* issuetracker = new IssueTracker();
+  issuetracker->addToIssueVec(
+      new Issue("Crash", "d", "Linux", "Bug", "ann", "bob"));
+  issuetracker->addToIssueVec(
+      new Issue("Theme", "d", "Linux", "Feature", "bob", "ann"));
+  issuetracker->addToIssueVec(
+      new Issue("Docs", "d", "Windows", "Task", "ann", "ann"));
+  ASSERT_EQ("Crash is now ui", issuetracker->addLabel("Crash", "ui"));
+  ASSERT_EQ("Crash is already ui", issuetracker->addLabel("Crash", "ui"));
+  issuetracker->addLabel("Theme", "ui");
+  issuetracker->addLabel("Theme", "easy");
+  issuetracker->addLabel("Docs", "easy");
+  ASSERT_EQ("Invalid label", issuetracker->addLabel("Docs", "a,b"));
+  ASSERT_EQ("(BLANK)", issuetracker->addLabel("Missing", "ui"));
+
+  ASSERT_EQ("Crash[^Theme[^", issuetracker->labelQuery("ui", "", ""));
+  ASSERT_EQ("Theme[^", issuetracker->labelQuery("ui,easy", "", ""));
+  ASSERT_EQ("Theme[^Docs[^", issuetracker->labelQuery("", "easy", ""));
+  ASSERT_EQ("Crash[^Docs[^",
+            issuetracker->labelQuery("", "type:Bug,os:Windows", ""));
+  ASSERT_EQ("Crash[^", issuetracker->labelQuery("os:Linux", "", "easy"));
+  ASSERT_EQ("Docs[^", issuetracker->labelQuery("", "", "ui,os:Linux"));
+  ASSERT_EQ("(BLANK)[^", issuetracker->labelQuery("ui,type:Task", "", ""));
+  ASSERT_EQ("total^]2^]label:easy^]1^]label:ui^]2^]os:Linux^]2^]"
+            "type:Bug^]1^]type:Feature^]1^]",
+            issuetracker->facetCounts("ui", "", ""));
+
+  // Labels are saved to labels.txt and read back
+  IssueTracker* reloaded = new IssueTracker();
+  reloaded->readFile();
+  ASSERT_EQ("Theme[^Docs[^", reloaded->labelQuery("easy", "", ""));
+  ASSERT_EQ("Theme is no longer ui", reloaded->removeLabel("Theme", "ui"));
+  ASSERT_EQ("Theme is not ui", reloaded->removeLabel("Theme", "ui"));
+  ASSERT_EQ("Crash[^", reloaded->labelQuery("ui", "", ""));
+  reloaded->deleteIssue("Crash");
+  ASSERT_EQ("(BLANK)[^", reloaded->labelQuery("ui", "", ""));
+
+  issuetracker->memoryCleanIssues();
+  reloaded->memoryCleanIssues();
+  delete issuetracker;
+  delete reloaded;
+}
+TEST(MockIssueTracker, filterIssues) {
+  IssueTracker* issuetracker = new IssueTracker();
+  issuetracker->addToIssueVec(
+      new Issue("Login crash", "segfault", "Linux", "Bug", "ann", "bob"));
+  issuetracker->addToIssueVec(
+      new Issue("Dark theme", "colors", "Linux", "Feature", "bob", "ann"));
+  issuetracker->addToIssueVec(
+      new Issue("Print crash", "printer", "Windows", "Bug", "bob", "bob"));
+  issuetracker->addToCommentVec("Login crash", "seen", "bob", "");
+  issuetracker->addToCommentVec("Login crash", "again", "ann", "");
+  issuetracker->addLabel("Dark theme", "ui");
+
+  ASSERT_EQ("Login crash[^Print crash[^",
+            issuetracker->filterIssues("type:Bug", false));
+  ASSERT_EQ("Login crash[^",
+            issuetracker->filterIssues(
+                "type:Bug AND os:Linux AND NOT assignee:ann AND comments>1",
+                false));
+  ASSERT_EQ("Dark theme[^Print crash[^",
+            issuetracker->filterIssues("label:ui OR os:Windows", false));
+  ASSERT_EQ("Print crash[^",
+            issuetracker->filterIssues("title:crash desc:PRINT", false));
+  ASSERT_EQ("Dark theme[^Print crash[^",
+            issuetracker->filterIssues("comments<1", false));
+  ASSERT_EQ("(BLANK)[^", issuetracker->filterIssues("user:carl", false));
+  ASSERT_EQ("(ERROR) unknown field color",
+            issuetracker->filterIssues("color:red", false));
+  ASSERT_EQ("(ERROR) comments needs a number",
+            issuetracker->filterIssues("comments>many", false));
+
+  // The indexes narrow the candidates before the comment count is checked
+  ASSERT_EQ("AND (1 ids)\n"
+            "  index user:ann (1 ids)\n"
+            "  index os:Linux (2 ids)\n"
+            "  filter comments>1 on 1 issues (1 kept)\n"
+            "examined 1 of 3 issues, matched 1\n",
+            issuetracker->filterIssues("os:Linux user:ann comments>1", true));
+  ASSERT_EQ("scan (comments>1 OR os:Windows) on 3 issues (2 kept)\n"
+            "examined 3 of 3 issues, matched 2\n",
+            issuetracker->filterIssues("comments>1 OR os:Windows", true));
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, savedViews) {
+  IssueTracker* issuetracker = new IssueTracker();
+  issuetracker->addToIssueVec(
+      new Issue("Login crash", "segfault", "Windows", "Bug", "ann", "bob"));
+  issuetracker->addToIssueVec(
+      new Issue("Dark theme", "colors", "Linux", "Feature", "bob", "ann"));
+
+  ASSERT_EQ("View triage saved with 1 issues",
+            issuetracker->saveView("triage", "type:Bug os:Windows"));
+  ASSERT_EQ("View busy saved with 0 issues",
+            issuetracker->saveView("busy", "comments>0 OR label:hot"));
+  ASSERT_EQ("(ERROR) unknown field color",
+            issuetracker->saveView("bad", "color:red"));
+  ASSERT_EQ("Login crash[^", issuetracker->getView("triage"));
+  ASSERT_EQ("(BLANK)[^", issuetracker->getView("busy"));
+  ASSERT_EQ("(ERROR) no view named bad", issuetracker->getView("bad"));
+
+  // Every kind of change updates the views it touches
+  std::string result;
+  issuetracker->addAnIssue("Print crash", "printer", "Windows", "Bug", "bob",
+                           "bob", result);
+  issuetracker->addToCommentVec("Dark theme", "too dark", "ann", "");
+  ASSERT_EQ("Login crash[^Print crash[^", issuetracker->getView("triage"));
+  ASSERT_EQ("Dark theme[^", issuetracker->getView("busy"));
+  issuetracker->addLabel("Login crash", "hot");
+  ASSERT_EQ("Login crash[^Dark theme[^", issuetracker->getView("busy"));
+  issuetracker->removeLabel("Login crash", "hot");
+  issuetracker->deleteIssue("Print crash");
+  ASSERT_EQ("Login crash[^", issuetracker->getView("triage"));
+  ASSERT_EQ("Dark theme[^", issuetracker->getView("busy"));
+
+  ASSERT_EQ("busy^]comments>0 OR label:hot^]1^]"
+            "triage^]type:Bug os:Windows^]1^]",
+            issuetracker->listViews());
+  uint64_t version = issuetracker->getVersion();
+  ASSERT_EQ("View busy has been removed.", issuetracker->deleteView("busy"));
+  ASSERT_EQ(version + 1, issuetracker->getVersion());
+  ASSERT_EQ("(BLANK)", issuetracker->deleteView("busy"));
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, storeStats) {
+  IssueTracker* issuetracker = new IssueTracker();
+  StoreStats stats = issuetracker->getStoreStats();
+  ASSERT_EQ(0, stats.issues);
+  ASSERT_EQ(0, stats.writes);
+
+  std::string result;
+  issuetracker->createUser("ann");
+  issuetracker->addAnIssue("Login crash", "segfault", "Windows", "Bug", "ann",
+                           "ann", result);
+  issuetracker->addToCommentVec("Login crash", "again", "ann", "");
+  stats = issuetracker->getStoreStats();
+  ASSERT_EQ(1, stats.issues);
+  ASSERT_EQ(1, stats.users);
+  ASSERT_EQ(1, stats.comments);
+  // Adding the issue and the comment each rewrote the store
+  ASSERT_EQ(2, stats.writes);
+  ASSERT_GT(stats.writeBytes, 0);
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, memoryStats) {
+  IssueTracker* issuetracker = new IssueTracker();
+  MemoryStats empty = issuetracker->getMemoryStats();
+  ASSERT_EQ(0, empty.issueBytes);
+  ASSERT_EQ(0, empty.commentBytes);
+
+  std::string result;
+  std::string longText(1000, 'x');
+  issuetracker->addToUserVec(new User("ann"));
+  issuetracker->addAnIssue("Login crash", longText, "Windows", "Bug", "ann",
+                           "ann", result);
+  issuetracker->addToCommentVec("Login crash", longText, "ann", "");
+  MemoryStats stats = issuetracker->getMemoryStats();
+  ASSERT_GT(stats.issueBytes, sizeof(Issue) + longText.size());
+  ASSERT_GT(stats.commentBytes, sizeof(Comment) + longText.size());
+  // ann fits inside her string, while the longer name has a buffer of its
+  // own even though it is shorter than the string object
+  ASSERT_EQ(sizeof(User), stats.userBytes);
+  User* longName = new User("annabelle_lastname");
+  issuetracker->addToUserVec(longName);
+  ASSERT_GT(std::string("annabelle_lastname").size(),
+            std::string().capacity());
+  ASSERT_LT(std::string("annabelle_lastname").size(), sizeof(std::string));
+  ASSERT_GE(issuetracker->getMemoryStats().userBytes,
+            2 * sizeof(User) + longName->getName().size() + 1);
+  ASSERT_GT(stats.listBytes, 0);
+  ASSERT_GT(stats.changeBytes, 0);
+  // Every index is listed, and the issue shows in the text index
+  ASSERT_EQ(15, stats.indexBytes.size());
+  ASSERT_EQ("text", stats.indexBytes[3].first);
+  ASSERT_GT(stats.indexBytes[3].second, 0);
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, duplicateTitles) {
+  IssueTracker* issuetracker = new IssueTracker();
+  issuetracker->addToIssueVec(new Issue("A", "first", "os", "Bug", "u", "u"));
+  issuetracker->addToIssueVec(new Issue("A", "second", "os", "Bug", "u", "u"));
+  issuetracker->addToIssueVec(new Issue("B", "other", "os", "Bug", "u", "u"));
+  issuetracker->addToIssueVec(new Issue("A", "third", "os", "Bug", "u", "u"));
+  ASSERT_EQ(0, issuetracker->getAnIssuePage("A", 0, 10).find("A^]third^]"));
+  ASSERT_EQ("A[^B[^", issuetracker->completeIssueTitles("", 10));
+  // The title index finds every issue the scan does
+  issuetracker->addToIssueVec(new Issue("Dup", "1", "os", "Bug", "u", "u"));
+  issuetracker->addToIssueVec(new Issue("Dup", "2", "os", "Bug", "u", "u"));
+  ASSERT_EQ("Dup[^Dup[^", issuetracker->filterIssues("title:Dup", false));
+  ASSERT_EQ("Dup[^Dup[^",
+            issuetracker->filterIssues("title:Dup OR comments>0", false));
+  issuetracker->deleteIssue("Dup");
+
+  // Every issue with the title goes, adjacent ones included
+  ASSERT_EQ("A has been removed.", issuetracker->deleteIssue("A"));
+  ASSERT_EQ(1, issuetracker->retSize());
+  ASSERT_EQ("(BLANK)[^", issuetracker->getAnIssuePage("A", 0, 10));
+  ASSERT_EQ("(BLANK)[^", issuetracker->completeIssueTitles("A", 10));
+  ASSERT_EQ("(BLANK)[^", issuetracker->findIssueTitles("A", 0, 10));
+  ASSERT_EQ(0, issuetracker->getAnIssuePage("B", 0, 10).find("B^]other^]"));
+  ASSERT_EQ("B[^", issuetracker->completeIssueTitles("", 10));
+
+  issuetracker->memoryCleanIssues();
+  delete issuetracker;
+}
+TEST(MockIssueTracker, readDuplicateTitles) {
+  // Only the later of two issues sharing a title has comments
+  IssueTracker* issuetracker = new IssueTracker();
+  issuetracker->addToIssueVec(new Issue("A", "first", "os", "Bug", "u", "u"));
+  Issue* later = new Issue("A", "second", "os", "Bug", "u", "u");
+  Comment* com = new Comment();
+  com->setText("only here");
+  com->setUser("u");
+  later->addToComments(com);
+  issuetracker->addToIssueVec(later);
+  issuetracker->writeFile();
+
+  IssueTracker* reloaded = new IssueTracker();
+  reloaded->readFile();
+  std::vector<Issue*> issues = reloaded->getIssueVec();
+  ASSERT_EQ(2, issues.size());
+  ASSERT_EQ(0, issues[0]->getCommentNum());
+  ASSERT_EQ(1, issues[1]->getCommentNum());
+  ASSERT_EQ("only here", issues[1]->getCommentVec()[0]->getCommentText());
+
+  // Files without blocks for uncommented issues still pair by title
+  std::ofstream context("context.txt");
+  context << "A^]d^]os^]Bug^]u^]u^]B^]d^]os^]Bug^]u^]u^]";
+  context.close();
+  std::ofstream comments("comments.txt");
+  comments << "B^]late^]u^]**";
+  comments.close();
+  IssueTracker* older = new IssueTracker();
+  older->readFile();
+  issues = older->getIssueVec();
+  ASSERT_EQ(0, issues[0]->getCommentNum());
+  ASSERT_EQ(1, issues[1]->getCommentNum());
+
+  issuetracker->memoryCleanCom();
+  issuetracker->memoryCleanIssues();
+  reloaded->memoryCleanCom();
+  reloaded->memoryCleanIssues();
+  older->memoryCleanCom();
+  older->memoryCleanIssues();
+  delete issuetracker;
+  delete reloaded;
+  delete older;
+}
 /**
  * @note: This causes coverage on CI server to fail but locally worked fine
  * -For reference in the makefile all the commented out code actually works
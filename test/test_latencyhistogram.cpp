@@ -0,0 +1,52 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <cstdint>
+
+#include "LatencyHistogram.h"
+#include "gtest/gtest.h"
+
+TEST(LatencyHistogramTest, Test_Percentiles) {
+  LatencyHistogram* histogram = new LatencyHistogram();
+  ASSERT_EQ(0, histogram->count());
+  ASSERT_EQ(0, histogram->percentile(99));
+
+  // Small values are exact
+  for (uint64_t v = 1; v <= 100; v++) histogram->record(v);
+  ASSERT_EQ(100, histogram->count());
+  ASSERT_EQ(1, histogram->min());
+  ASSERT_EQ(100, histogram->max());
+  ASSERT_DOUBLE_EQ(50.5, histogram->mean());
+  ASSERT_EQ(50, histogram->percentile(50));
+  ASSERT_EQ(99, histogram->percentile(99));
+  ASSERT_EQ(100, histogram->percentile(100));
+  ASSERT_EQ(1, histogram->percentile(0));
+
+  // Large values are reported within 1.6% of themselves
+  histogram->clear();
+  for (uint64_t v = 1000; v <= 1000000; v += 1000) histogram->record(v);
+  uint64_t median = histogram->percentile(50);
+  ASSERT_GE(median, 500000);
+  ASSERT_LE(median, 500000 * 1.016);
+  uint64_t tail = histogram->percentile(99.9);
+  ASSERT_GE(tail, 999000);
+  ASSERT_LE(tail, 1000000);  // Never above the maximum
+  histogram->record(UINT64_MAX);
+  ASSERT_EQ(UINT64_MAX, histogram->percentile(100));
+  delete histogram;
+}
+
+TEST(LatencyHistogramTest, Test_Merge) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (int i = 0; i < 90; i++) first.record(10);
+  for (int i = 0; i < 10; i++) second.record(5000);
+  first.merge(second);
+  first.merge(LatencyHistogram());  // Empty histograms change nothing
+  ASSERT_EQ(100, first.count());
+  ASSERT_EQ(10, first.min());
+  ASSERT_EQ(5000, first.max());
+  ASSERT_EQ(10, first.percentile(90));
+  ASSERT_GE(first.percentile(95), 5000);
+  ASSERT_DOUBLE_EQ(509, first.mean());
+}
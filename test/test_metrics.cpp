@@ -0,0 +1,102 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "Metrics.h"
+#include "gtest/gtest.h"
+
+TEST(MetricsTest, Test_Observe) {
+  Metrics* metrics = new Metrics("test", {"getIssue", "addIssue"});
+  metrics->observe(0, 1, false);     // 1 us, first bucket
+  metrics->observe(0, 3, false);     // Up to 4 us
+  metrics->observe(0, 1000, true);   // Up to 1024 us
+  metrics->observe(0, 1ULL << 40, false);  // Past the last bound
+  metrics->observe(7, 5, false);     // No such operation
+
+  Metrics::Totals totals = metrics->totals(0);
+  ASSERT_EQ(4, totals.count);
+  ASSERT_EQ(1, totals.errors);
+  ASSERT_EQ(1 + 3 + 1000 + (1ULL << 40), totals.micros);
+  ASSERT_EQ(1, totals.buckets[0]);
+  ASSERT_EQ(1, totals.buckets[2]);
+  ASSERT_EQ(1, totals.buckets[10]);
+  ASSERT_EQ(1, totals.buckets[Metrics::BUCKETS - 1]);
+  ASSERT_EQ(0, metrics->totals(1).count);
+
+  // Every thread counts into its own shard, summed when read
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([metrics]() {
+      for (int i = 0; i < 1000; i++) metrics->observe(1, 100, false);
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+  ASSERT_EQ(4000, metrics->totals(1).count);
+  ASSERT_EQ(4000, metrics->totals(1).buckets[7]);
+
+  // Counters for every operation, histograms for the requested ones
+  std::string text = metrics->format();
+  ASSERT_NE(std::string::npos,
+            text.find("test_requests_total{op=\"getIssue\"} 4\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_errors_total{op=\"getIssue\"} 1\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_duration_seconds_bucket{op=\"addIssue\","
+                      "le=\"0.000128\"} 4000\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_duration_seconds_bucket{op=\"getIssue\","
+                      "le=\"+Inf\"} 4\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_duration_seconds_count{op=\"addIssue\"} "
+                      "4000\n"));
+
+  std::string gauge;
+  Metrics::append(&gauge, "test_issues", "gauge", "Issues.", 12);
+  ASSERT_EQ("# HELP test_issues Issues.\n# TYPE test_issues gauge\n"
+            "test_issues 12\n",
+            gauge);
+  ASSERT_GT(Metrics::residentBytes(), 0);
+  delete metrics;
+}
+
+TEST(MetricsTest, Test_Allocations) {
+  Metrics* metrics = new Metrics("test", {"getIssue", "addIssue"});
+  metrics->observe(0, 10, false);
+  ASSERT_EQ(std::string::npos, metrics->format().find("alloc"));
+
+  metrics->observe(0, 10, false);
+  metrics->observeAllocations(0, 30, 1000);
+  metrics->observeAllocations(0, 10, 200);
+  metrics->observeAllocations(5, 10, 200);  // No such operation
+  Metrics::Totals totals = metrics->totals(0);
+  ASSERT_EQ(40, totals.allocations);
+  ASSERT_EQ(1200, totals.allocatedBytes);
+  ASSERT_EQ(0, metrics->totals(1).allocations);
+
+  std::string text = metrics->format();
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_allocations_total{op=\"getIssue\"} "
+                      "40\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_request_allocated_bytes_total{op=\"getIssue\"} "
+                      "1200\n"));
+  ASSERT_NE(std::string::npos,
+            text.find("test_allocations_per_request{op=\"getIssue\"} 20\n"));
+  // No average for an operation never requested
+  ASSERT_EQ(std::string::npos,
+            text.find("test_allocations_per_request{op=\"addIssue\"}"));
+  delete metrics;
+}
+
+TEST(MetricsTest, Test_HeapStats) {
+  std::vector<std::string> held(1000, std::string(100, 'x'));
+  Metrics::HeapStats heap;
+  ASSERT_TRUE(Metrics::heapStats(&heap));
+  ASSERT_GE(heap.arenas, 1);
+  ASSERT_GT(heap.systemBytes, 100000);
+  ASSERT_GE(heap.maxSystemBytes, heap.systemBytes);
+  ASSERT_LT(heap.freeBytes, heap.systemBytes);
+}
@@ -0,0 +1,30 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <vector>
+
+#include "PostingIndex.h"
+#include "gtest/gtest.h"
+
+TEST(PostingIndexTest, Test_AddRemove) {
+  PostingIndex* index = new PostingIndex();
+  index->add("Linux", 1);
+  index->add("Linux", 4);
+  index->add("Linux", 2);  // Out of order ids stay sorted
+  index->add("MacOS", 3);
+  std::vector<uint64_t> expected = {1, 2, 4};
+  ASSERT_EQ(expected, index->get("Linux"));
+  ASSERT_TRUE(index->contains("MacOS", 3));
+  ASSERT_FALSE(index->contains("MacOS", 1));
+  ASSERT_TRUE(index->get("Windows").empty());
+  ASSERT_EQ(2, index->size());
+  ASSERT_GT(index->bytes(), 4 * sizeof(uint64_t));
+
+  index->remove("MacOS", 3);
+  index->remove("Linux", 2);
+  index->remove("Linux", 9);  // Missing ids are ignored
+  ASSERT_EQ(1, index->size());
+  expected = {1, 4};
+  ASSERT_EQ(expected, index->get("Linux"));
+  delete index;
+}
@@ -0,0 +1,41 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <vector>
+
+#include "PrefixIndex.h"
+#include "gtest/gtest.h"
+
+TEST(PrefixIndexTest, Test_Complete) {
+  PrefixIndex* index = new PrefixIndex();
+  index->add("printer offline");
+  index->add("Print preview blank");
+  index->add("Crash when printing");
+  index->add("PRINT");
+  index->add("Print preview blank");  // Already indexed
+  ASSERT_EQ(4, index->size());
+
+  // Case is ignored and shorter strings come first
+  std::vector<std::string> expected = {"PRINT", "Print preview blank",
+                                       "printer offline"};
+  ASSERT_EQ(expected, index->complete("print", 10));
+  expected = {"PRINT", "Print preview blank"};
+  ASSERT_EQ(expected, index->complete("pRiNt", 2));
+  expected = {"Print preview blank"};
+  ASSERT_EQ(expected, index->complete("print ", 10));
+  ASSERT_EQ(4, index->complete("", 10).size());
+  ASSERT_TRUE(index->complete("printers", 10).empty());
+  ASSERT_TRUE(index->complete("scan", 10).empty());
+
+  index->remove("PRINT");
+  index->remove("Print");  // Not indexed in this case
+  expected = {"Print preview blank", "printer offline"};
+  ASSERT_EQ(expected, index->complete("PRINT", 10));
+  ASSERT_GT(index->bytes(), 0);
+
+  index->clear();
+  ASSERT_EQ(0, index->size());
+  ASSERT_TRUE(index->complete("", 10).empty());
+  delete index;
+}
@@ -0,0 +1,74 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "Profiler.h"
+#include "gtest/gtest.h"
+
+/**
+ * Keeps the CPU busy for a while
+ * @param millis how long
+ * @return something computed, so the work is not optimized away
+ */
+static uint64_t spin(int millis) {
+  auto end = std::chrono::steady_clock::now() +
+             std::chrono::milliseconds(millis);
+  uint64_t value = 1;
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 1000; i++) value = value * 6364136223846793005ULL + 1;
+  }
+  return value;
+}
+
+TEST(ProfilerTest, Test_Sample) {
+  ASSERT_FALSE(Profiler::running());
+  ASSERT_EQ("", Profiler::stop());
+  ASSERT_FALSE(Profiler::start(0, 100));
+  ASSERT_FALSE(Profiler::start(1001, 100));
+
+  ASSERT_TRUE(Profiler::start(1000, 10000));
+  ASSERT_TRUE(Profiler::running());
+  ASSERT_FALSE(Profiler::start(1000, 10000));
+  ASSERT_NE(0, spin(300));
+  std::string folded = Profiler::stop();
+  ASSERT_FALSE(Profiler::running());
+  ASSERT_EQ(0, Profiler::dropped());
+
+  // "outer;...;inner count" lines, stacks in order
+  std::istringstream lines(folded);
+  std::string line;
+  std::string previous;
+  uint64_t samples = 0;
+  bool ownCode = false;
+  bool callers = false;
+  while (getline(lines, line)) {
+    size_t space = line.rfind(' ');
+    ASSERT_NE(std::string::npos, space);
+    std::string stack = line.substr(0, space);
+    ASSERT_LT(previous, stack);
+    previous = stack;
+    uint64_t count = strtoull(line.c_str() + space + 1, NULL, 10);
+    ASSERT_GT(count, 0);
+    samples += count;
+    // The test binary exports no symbols, so its frames are offsets
+    ownCode = ownCode || stack.find("test_issue+0x") != std::string::npos;
+    // Frame pointers lead from spin back out through its callers
+    size_t inner = stack.rfind(";test_issue+0x");
+    callers = callers || (inner != std::string::npos &&
+                          stack.rfind("test_issue+0x", inner - 1) !=
+                              std::string::npos);
+  }
+  ASSERT_GT(samples, 50);
+  ASSERT_TRUE(ownCode);
+  ASSERT_TRUE(callers);
+
+  // Samples past the capacity are counted, not kept
+  ASSERT_TRUE(Profiler::start(1000, 1));
+  ASSERT_NE(0, spin(100));
+  Profiler::stop();
+  ASSERT_GT(Profiler::dropped(), 0);
+}
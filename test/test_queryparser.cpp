@@ -0,0 +1,57 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+
+#include "QueryParser.h"
+#include "gtest/gtest.h"
+
+TEST(QueryParserTest, Test_Parse) {
+  QueryNode root;
+  std::string error;
+  ASSERT_TRUE(QueryParser::parse(
+      "type:Bug AND os:Linux AND NOT assignee:user_Removed AND comments>5",
+      &root, &error));
+  ASSERT_EQ(QueryNode::AND, root.kind);
+  ASSERT_EQ(4, root.children.size());
+  ASSERT_EQ("(type:Bug AND os:Linux AND NOT assignee:user_Removed AND "
+            "comments>5)",
+            QueryParser::describe(root));
+
+  // NOT binds tighter than AND, AND tighter than OR, and "=" means ":"
+  QueryNode precedence;
+  ASSERT_TRUE(QueryParser::parse("label:ui or not os=Linux and Type:Bug",
+                                 &precedence, &error));
+  ASSERT_EQ("(label:ui OR (NOT os:Linux AND type:Bug))",
+            QueryParser::describe(precedence));
+
+  // Adjacent predicates are ANDed, != is NOT and quotes keep spaces
+  QueryNode implicit;
+  ASSERT_TRUE(QueryParser::parse("(os:Linux OR os:MacOS) title:\"log in\" "
+                                 "user!=ann",
+                                 &implicit, &error));
+  ASSERT_EQ("((os:Linux OR os:MacOS) AND title:\"log in\" AND NOT user:ann)",
+            QueryParser::describe(implicit));
+
+  QueryNode bad;
+  ASSERT_FALSE(QueryParser::parse("", &bad, &error));
+  ASSERT_EQ("empty query", error);
+  ASSERT_FALSE(QueryParser::parse("type:Bug AND", &bad, &error));
+  ASSERT_FALSE(QueryParser::parse("(type:Bug", &bad, &error));
+  ASSERT_EQ("expected \")\" at position 9", error);
+  ASSERT_FALSE(QueryParser::parse("type Bug", &bad, &error));
+  ASSERT_FALSE(QueryParser::parse("title:\"open", &bad, &error));
+
+  // Nesting is limited, rather than recursing until the stack runs out
+  std::string nested = std::string(64, '(') + "os:Linux" + std::string(64, ')');
+  QueryNode deep;
+  ASSERT_TRUE(QueryParser::parse(nested, &deep, &error));
+  ASSERT_EQ("os:Linux", QueryParser::describe(deep));
+  ASSERT_FALSE(QueryParser::parse("(" + nested + ")", &bad, &error));
+  ASSERT_EQ("query nested too deeply", error);
+  ASSERT_FALSE(QueryParser::parse(std::string(200000, '('), &bad, &error));
+  std::string nots;
+  for (int i = 0; i < 65; i++) nots += "NOT ";
+  ASSERT_FALSE(QueryParser::parse(nots + "os:Linux", &bad, &error));
+  ASSERT_EQ("query nested too deeply", error);
+}
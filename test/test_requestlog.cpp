@@ -0,0 +1,85 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "RequestLog.h"
+#include "WireFrame.h"
+#include "gtest/gtest.h"
+
+TEST(RequestLogTest, Test_CaptureAndRead) {
+  RequestLog* log = new RequestLog();
+  ASSERT_FALSE(log->isOpen());
+  log->record(WireFrame::GET_REQUEST, "op~getAllIssues");  // Not capturing
+  ASSERT_TRUE(log->open("requests.log"));
+  ASSERT_TRUE(log->isOpen());
+
+  log->record(WireFrame::GET_REQUEST, "op~getIssue~title~Crash");
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  log->record(WireFrame::POST_REQUEST,
+              "issueType~addIssue~Crash~On save~Linux~Bug~ann~bob");
+  log->record(WireFrame::GET_REQUEST, std::string(300, 'x'));
+  log->close();
+  ASSERT_FALSE(log->isOpen());
+
+  std::vector<RequestLog::Entry> entries;
+  ASSERT_TRUE(RequestLog::read("requests.log", &entries));
+  ASSERT_EQ(3, entries.size());
+  ASSERT_EQ(WireFrame::GET_REQUEST, entries[0].kind);
+  ASSERT_EQ("op~getIssue~title~Crash", entries[0].payload);
+  ASSERT_EQ(0, entries[0].micros);
+  ASSERT_EQ(WireFrame::POST_REQUEST, entries[1].kind);
+  ASSERT_EQ("issueType~addIssue~Crash~On save~Linux~Bug~ann~bob",
+            entries[1].payload);
+  ASSERT_GE(entries[1].micros, 5000);
+  ASSERT_GE(entries[2].micros, entries[1].micros);
+  ASSERT_EQ(std::string(300, 'x'), entries[2].payload);
+
+  // A record cut off by a crash ends the log without failing it
+  FILE* file = fopen("requests.log", "rb");
+  std::string data;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.append(chunk, n);
+  fclose(file);
+  file = fopen("requests.log", "wb");
+  fwrite(data.data(), 1, data.size() - 10, file);
+  fclose(file);
+  entries.clear();
+  ASSERT_TRUE(RequestLog::read("requests.log", &entries));
+  ASSERT_EQ(2, entries.size());
+
+  // Anything else is not a log
+  file = fopen("requests.log", "wb");
+  fputs("op~getIssue\n", file);
+  fclose(file);
+  ASSERT_FALSE(RequestLog::read("requests.log", &entries));
+  ASSERT_FALSE(RequestLog::read("missing.log", &entries));
+
+  remove("requests.log");
+  delete log;
+}
+TEST(RequestLogTest, Test_TildeInTitle) {
+  // Captured parameters come back exactly, "~" and all
+  std::vector<std::pair<std::string, std::string>> params = {
+      {"op", "getIssue"}, {"title", "Crash~on~save"}};
+  RequestLog* log = new RequestLog();
+  ASSERT_TRUE(log->open("requests.log"));
+  log->record(WireFrame::GET_REQUEST, WireFrame::encodeParams(params));
+  log->close();
+
+  std::vector<RequestLog::Entry> entries;
+  ASSERT_TRUE(RequestLog::read("requests.log", &entries));
+  ASSERT_EQ(1, entries.size());
+  std::vector<std::pair<std::string, std::string>> replayed;
+  ASSERT_TRUE(WireFrame::decodeParams(entries[0].payload, &replayed));
+  ASSERT_EQ(params, replayed);
+
+  remove("requests.log");
+  delete log;
+}
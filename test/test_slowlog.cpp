@@ -0,0 +1,65 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "SlowLog.h"
+#include "gtest/gtest.h"
+
+TEST(SlowLogTest, Test_Write) {
+  remove("slow.log");
+  SlowLog* log = new SlowLog();
+  ASSERT_FALSE(log->isOpen());
+  log->write("not open");
+  ASSERT_TRUE(log->open("slow.log", 250000));
+  ASSERT_TRUE(log->isOpen());
+  ASSERT_EQ(250000, log->getThreshold());
+
+  // Lines from many threads all arrive, each whole
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([log, t]() {
+      for (int i = 0; i < 100; i++) {
+        log->write("{\"thread\":" + std::to_string(t) + "}");
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+  log->close();
+  ASSERT_FALSE(log->isOpen());
+  ASSERT_EQ(400, log->getLogged());
+  ASSERT_EQ(0, log->getDropped());
+  log->write("closed");
+
+  std::ifstream file("slow.log");
+  std::string line;
+  std::vector<int> perThread(4, 0);
+  int lines = 0;
+  while (getline(file, line)) {
+    ASSERT_EQ(12, line.size());
+    perThread[line[10] - '0']++;
+    lines++;
+  }
+  ASSERT_EQ(400, lines);
+  for (int t = 0; t < 4; t++) ASSERT_EQ(100, perThread[t]);
+  file.close();
+
+  // Reopening appends
+  ASSERT_TRUE(log->open("slow.log", 0));
+  log->write("again");
+  delete log;
+  std::ifstream reread("slow.log");
+  std::string last;
+  lines = 0;
+  while (getline(reread, line)) {
+    last = line;
+    lines++;
+  }
+  ASSERT_EQ(401, lines);
+  ASSERT_EQ("again", last);
+  remove("slow.log");
+}
@@ -0,0 +1,21 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+
+#include "StringBytes.h"
+#include "gtest/gtest.h"
+
+TEST(StringBytesTest, Test_Heap) {
+  size_t inlineCapacity = std::string().capacity();
+  ASSERT_EQ(0, StringBytes::heap(""));
+  ASSERT_EQ(0, StringBytes::heap(std::string(inlineCapacity, 'x')));
+
+  // One past the inline capacity is on the heap, even while it is still
+  // shorter than the string object
+  std::string longer(inlineCapacity + 1, 'x');
+  ASSERT_EQ(longer.capacity() + 1, StringBytes::heap(longer));
+  std::string reserved;
+  reserved.reserve(1000);
+  ASSERT_EQ(reserved.capacity() + 1, StringBytes::heap(reserved));
+}
@@ -0,0 +1,55 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "TextIndex.h"
+#include "gtest/gtest.h"
+
+TEST(TextIndexTest, Test_Ranking) {
+  TextIndex* index = new TextIndex();
+  std::vector<std::string> tokens = TextIndex::tokenize("Can't log-in, 404!");
+  std::vector<std::string> expected = {"can", "t", "log", "in", "404"};
+  ASSERT_EQ(expected, tokens);
+
+  index->add(1, "server crash on start");
+  index->add(2, "crash crash crash");
+  index->add(3, "typo in the docs");
+  index->add(3, "docs mention a crash once");
+  std::vector<std::pair<uint64_t, double>> hits = index->search("crash", 3);
+  ASSERT_EQ(3, hits.size());
+  ASSERT_EQ(2, hits[0].first);  // Highest term frequency ranks first
+  ASSERT_GT(hits[0].second, hits[1].second);
+
+  // Pruned top-k agrees with the best entries of the full ranking
+  for (int d = 10; d < 500; d++) {
+    index->add(d, d % 7 ? "docs page" : "crash report in docs");
+  }
+  std::vector<std::pair<uint64_t, double>> all =
+      index->search("crash docs", 1000);
+  std::vector<std::pair<uint64_t, double>> best =
+      index->search("crash docs", 5);
+  ASSERT_EQ(5, best.size());
+  for (int r = 0; r < 5; r++) ASSERT_DOUBLE_EQ(all[r].second, best[r].second);
+
+  // A saved index only loads back under the same stamp
+  std::unordered_map<uint64_t, uint64_t> ids;
+  for (int d = 0; d < 500; d++) ids[d] = d;
+  index->save("textindex_test.idx", ids, "stamp 1");
+  TextIndex* loaded = new TextIndex();
+  ASSERT_FALSE(loaded->load("textindex_test.idx", "stamp 2"));
+  ASSERT_TRUE(loaded->load("textindex_test.idx", "stamp 1"));
+  ASSERT_EQ(best, loaded->search("crash docs", 5));
+  remove("textindex_test.idx");
+  delete loaded;
+
+  index->remove(2, "crash crash crash");
+  ASSERT_EQ(492, index->documents());
+  hits = index->search("crash", 1);
+  ASSERT_NE(2, hits[0].first);
+  delete index;
+}
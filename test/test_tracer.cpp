@@ -0,0 +1,136 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "Tracer.h"
+#include "gtest/gtest.h"
+
+/**
+ * Counts the occurrences of a piece of text
+ */
+static size_t occurrences(const std::string& text, const std::string& part) {
+  size_t count = 0;
+  for (size_t p = text.find(part); p != std::string::npos;
+       p = text.find(part, p + 1)) {
+    count++;
+  }
+  return count;
+}
+
+TEST(TracerTest, Test_Sampling) {
+  Tracer::clear();
+  Tracer::setSampling(0);
+  ASSERT_EQ(0, Tracer::beginRequest());
+  ASSERT_FALSE(Tracer::active());
+  { TraceSpan span("ignored"); }
+  Tracer::endRequest();
+  ASSERT_EQ(std::string::npos, Tracer::dump().find("ignored"));
+
+  // One request in four is traced
+  Tracer::setSampling(4);
+  ASSERT_EQ(4, Tracer::getSampling());
+  int traced = 0;
+  for (int r = 0; r < 40; r++) {
+    if (Tracer::beginRequest() != 0) {
+      ASSERT_TRUE(Tracer::active());
+      traced++;
+    }
+    { TraceSpan span("phase"); }
+    Tracer::endRequest();
+  }
+  ASSERT_EQ(10, traced);
+  ASSERT_EQ(10, occurrences(Tracer::dump(), "\"name\":\"phase\""));
+  Tracer::setSampling(0);
+  Tracer::clear();
+}
+
+TEST(TracerTest, Test_Spans) {
+  Tracer::clear();
+  Tracer::setSampling(1);
+
+  // A request continued later, as POST callbacks do
+  uint64_t request = Tracer::beginRequest();
+  ASSERT_NE(0, request);
+  uint64_t start = Tracer::now();
+  Tracer::endRequest();
+  ASSERT_FALSE(Tracer::active());
+  Tracer::resumeRequest(request);
+  {
+    TraceSpan outer("outer");
+    { TraceSpan inner("inner"); }
+  }
+  Tracer::record("request", start, Tracer::now());
+  Tracer::endRequest();
+
+  // Spans from another thread land in its own ring
+  std::thread other([]() {
+    Tracer::beginRequest();
+    { TraceSpan span("elsewhere"); }
+    Tracer::endRequest();
+  });
+  other.join();
+
+  std::string json = Tracer::dump();
+  ASSERT_EQ(0, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  ASSERT_EQ(json.size() - 3, json.rfind("]}\n"));
+  ASSERT_EQ(4, occurrences(json, "\"ph\":\"X\""));
+  // Outer spans come before the spans they contain
+  ASSERT_LT(json.find("\"request\""), json.find("\"outer\""));
+  ASSERT_LT(json.find("\"outer\""), json.find("\"inner\""));
+  ASSERT_EQ(3, occurrences(json, "\"request\":" + std::to_string(request) +
+                                     "}"));
+  ASSERT_NE(json.find("\"tid\":"), json.rfind("\"tid\":"));
+
+  // Rings keep only the latest spans
+  Tracer::clear();
+  Tracer::beginRequest();
+  for (size_t i = 0; i < Tracer::RING_SIZE + 10; i++) {
+    TraceSpan span("many");
+  }
+  Tracer::endRequest();
+  ASSERT_EQ(Tracer::RING_SIZE, occurrences(Tracer::dump(), "\"many\""));
+
+  Tracer::setSampling(0);
+  Tracer::clear();
+}
+
+TEST(TracerTest, Test_PhaseTimes) {
+  Tracer::clear();
+  Tracer::setSampling(0);
+  Tracer::setPhaseTiming(true);
+
+  // Every request is timed, though none is traced
+  ASSERT_EQ(0, Tracer::beginRequest());
+  ASSERT_TRUE(Tracer::active());
+  Tracer::record("parse", 100, 300);
+  Tracer::record("IssueTracker", 300, 1300);
+  Tracer::record("writeFile", 400, 1200);
+  Tracer::record("parse", 1300, 1400);
+  const std::vector<std::pair<const char*, uint64_t>>& phases =
+      Tracer::phases();
+  ASSERT_EQ(3, phases.size());
+  ASSERT_STREQ("parse", phases[0].first);
+  ASSERT_EQ(300, phases[0].second);
+  ASSERT_STREQ("IssueTracker", phases[1].first);
+  ASSERT_EQ(1000, phases[1].second);
+  ASSERT_EQ(800, phases[2].second);
+  Tracer::endRequest();
+  ASSERT_FALSE(Tracer::active());
+  ASSERT_EQ(std::string::npos, Tracer::dump().find("parse"));
+
+  // Continuing a request starts its phases over
+  Tracer::beginRequest();
+  Tracer::record("fetch", 0, 50);
+  Tracer::resumeRequest(0);
+  ASSERT_TRUE(Tracer::phases().empty());
+  Tracer::endRequest();
+
+  Tracer::setPhaseTiming(false);
+  Tracer::beginRequest();
+  ASSERT_FALSE(Tracer::active());
+  Tracer::endRequest();
+}
@@ -0,0 +1,40 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <vector>
+
+#include "TrigramIndex.h"
+#include "gtest/gtest.h"
+
+TEST(TrigramIndexTest, Test_Lookup) {
+  TrigramIndex* index = new TrigramIndex();
+  ASSERT_EQ(0, TrigramIndex::substringDistance("crash", "a crash here"));
+  ASSERT_EQ(1, TrigramIndex::substringDistance("crsh", "a crash here"));
+  ASSERT_EQ(2, TrigramIndex::substringDistance("kitten", "sitting"));
+
+  index->add("Printer offline");
+  index->add("Print preview blank");
+  index->add("Crash when printing");
+  std::vector<std::string> expected = {"Printer offline",
+                                       "Print preview blank"};
+  ASSERT_EQ(expected, index->substring("PRINT", 2));  // Case-insensitive
+  ASSERT_EQ(3, index->substring("print", 10).size());
+  expected = {"Print preview blank"};
+  ASSERT_EQ(expected, index->substring("t pre", 10));
+  ASSERT_EQ(3, index->substring("in", 10).size());  // Too short for trigrams
+  ASSERT_TRUE(index->substring("scanner", 10).empty());
+
+  // Typos are found and the closest match ranks first
+  expected = {"Printer offline"};
+  ASSERT_EQ(expected, index->fuzzy("printer ofline", 1, 10));
+  ASSERT_TRUE(index->fuzzy("printer ofline", 0, 10).empty());
+
+  index->remove("Printer offline");
+  index->add("Scanner jam");  // Reuses the free slot
+  ASSERT_EQ(3, index->size());
+  ASSERT_TRUE(index->substring("offline", 10).empty());
+  expected = {"Scanner jam"};
+  ASSERT_EQ(expected, index->fuzzy("scaner", 1, 10));
+  delete index;
+}
@@ -0,0 +1,73 @@
+// Copyright 2020 Cole_Anderson,Christian_Walker, Micheal_Wynnychuck,
+// Radek_Lewandowski
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "WebSocketCodec.h"
+#include "WireFrame.h"
+#include "gtest/gtest.h"
+
+TEST(WebSocketTest, Test_Handshake) {
+  // Example handshake from RFC 6455 section 1.3
+  ASSERT_EQ("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=",
+            WebSocketCodec::acceptKey("dGhlIHNhbXBsZSBub25jZQ=="));
+  ASSERT_EQ("", WebSocketCodec::base64(""));
+  ASSERT_EQ("Zm8=", WebSocketCodec::base64("fo"));
+  ASSERT_EQ("Zm9vYg==", WebSocketCodec::base64("foob"));
+}
+TEST(WebSocketTest, Test_Frames) {
+  std::string big(70000, 'x');
+  std::string buffer = WebSocketCodec::encode(WebSocketCodec::BINARY,
+                                              "hello", true) +
+                       WebSocketCodec::encode(WebSocketCodec::TEXT, big, false);
+  bool fin;
+  int opcode;
+  std::string payload;
+
+  // A partial frame is left in the buffer
+  std::string partial = buffer.substr(0, 5);
+  ASSERT_FALSE(WebSocketCodec::decode(&partial, &fin, &opcode, &payload));
+  ASSERT_EQ(5, partial.size());
+
+  ASSERT_TRUE(WebSocketCodec::decode(&buffer, &fin, &opcode, &payload));
+  ASSERT_TRUE(fin);
+  ASSERT_EQ(WebSocketCodec::BINARY, opcode);
+  ASSERT_EQ("hello", payload);
+  ASSERT_TRUE(WebSocketCodec::decode(&buffer, &fin, &opcode, &payload));
+  ASSERT_EQ(WebSocketCodec::TEXT, opcode);
+  ASSERT_EQ(big, payload);
+  ASSERT_TRUE(buffer.empty());
+}
+TEST(WebSocketTest, Test_WireFrame) {
+  std::string frame = WireFrame::encode(WireFrame::EVENT, 300, "a^]b^]");
+  ASSERT_EQ(1 + 2 + 6, frame.size());  // 300 needs a two byte varint
+
+  int kind;
+  uint64_t id;
+  std::string payload;
+  ASSERT_TRUE(WireFrame::decode(frame, &kind, &id, &payload));
+  ASSERT_EQ(WireFrame::EVENT, kind);
+  ASSERT_EQ(300, id);
+  ASSERT_EQ("a^]b^]", payload);
+  ASSERT_FALSE(WireFrame::decode("", &kind, &id, &payload));
+  ASSERT_FALSE(WireFrame::decode(std::string("\x03\x80", 2), &kind, &id,
+                                 &payload));
+}
+TEST(WebSocketTest, Test_Params) {
+  // "~" separates the fields, so one inside a title must not split it
+  std::vector<std::pair<std::string, std::string>> params = {
+      {"op", "getIssue"}, {"title", "a~b 100%"}, {"after", ""}};
+  std::string payload = WireFrame::encodeParams(params);
+  ASSERT_EQ("op~getIssue~title~a%7Eb 100%25~after~", payload);
+
+  std::vector<std::pair<std::string, std::string>> decoded;
+  ASSERT_TRUE(WireFrame::decodeParams(payload, &decoded));
+  ASSERT_EQ(params, decoded);
+  ASSERT_TRUE(WireFrame::decodeParams("", &decoded));
+  ASSERT_TRUE(decoded.empty());
+  ASSERT_FALSE(WireFrame::decodeParams("op~getIssue~title", &decoded));
+  ASSERT_FALSE(WireFrame::decodeParams("title~50%", &decoded));
+  ASSERT_FALSE(WireFrame::decodeParams("title~%7G", &decoded));
+}